@@ -0,0 +1,305 @@
+/**
+ * @file bench_tools.hpp
+ * @author agent
+ *
+ * Utilities for the ensmallen benchmark program: the benchmark result record,
+ * a callback that records the progress of an optimization, measurement of the
+ * peak memory of the process, and the CSV/JSON writers.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_BENCH_BENCH_TOOLS_HPP
+#define ENSMALLEN_BENCH_BENCH_TOOLS_HPP
+
+#include <ensmallen.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <sys/resource.h>
+#endif
+
+namespace ens {
+namespace bench {
+
+/**
+ * The result of one run of one optimizer on one problem.
+ */
+struct BenchResult
+{
+  //! Name of the problem.
+  std::string problem;
+  //! Name of the optimizer.
+  std::string optimizer;
+  //! Scale the problem was generated with.
+  double scale;
+  //! Number of elements of the coordinates.
+  size_t dimension;
+  //! Index of the repetition.
+  size_t repetition;
+
+  //! Wall-clock time of the whole Optimize() call, in seconds.
+  double time;
+  //! Wall-clock time until the objective was within tolerance of the best
+  //! objective found by any optimizer on the problem, in seconds; NaN if it
+  //! never was (or if it is unknown).
+  double timeToTolerance;
+  //! Whether evaluation counts are available (the optimizer takes callbacks).
+  bool instrumented;
+  //! Number of objective evaluations.
+  size_t evaluations;
+  //! Number of gradient evaluations.
+  size_t gradients;
+  //! Objective value of the final point.
+  double finalObjective;
+  //! Peak resident set size of the whole benchmark process up to the end of
+  //! the run, in kilobytes; this includes all earlier runs.
+  size_t processPeakMemoryKB;
+
+  //! The objective over time (seconds, objective), for instrumented runs.
+  std::vector<std::pair<double, double>> trace;
+};
+
+/**
+ * BenchRecorder is a callback that counts evaluations and records the
+ * objective over time.  For optimizers with epochs, only the epoch objectives
+ * are recorded, since the objective of a single batch is not comparable to the
+ * full objective; otherwise every objective evaluation is recorded.  Once the
+ * first epoch begins, evaluations are only counted, so that the mini-batch
+ * optimizers do not pay for a clock read and a sample per batch.
+ */
+class BenchRecorder
+{
+ public:
+  //! Create the recorder and start its clock; use one recorder per run.  The
+  //! recorder does not reset at BeginOptimization(), so that the restarts of
+  //! IPOP-CMA-ES are all recorded.
+  BenchRecorder() :
+      evaluations(0),
+      gradients(0),
+      epochs(false),
+      start(Clock::now())
+  { }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double /* objective */)
+  {
+    if (!epochs)
+    {
+      epochs = true;
+      evaluationTrace.clear();
+    }
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double objective)
+  {
+    epochTrace.push_back(std::make_pair(Elapsed(), objective));
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double objective)
+  {
+    ++evaluations;
+    if (!epochs)
+      evaluationTrace.push_back(std::make_pair(Elapsed(), objective));
+  }
+
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  void Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const GradType& /* gradient */)
+  {
+    ++gradients;
+  }
+
+  //! Get the number of objective evaluations.
+  size_t Evaluations() const { return evaluations; }
+  //! Get the number of gradient evaluations.
+  size_t Gradients() const { return gradients; }
+
+  //! Get the recorded objective over time.
+  const std::vector<std::pair<double, double>>& Trace() const
+  {
+    return epochs ? epochTrace : evaluationTrace;
+  }
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  double Elapsed() const
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  size_t evaluations;
+  size_t gradients;
+  //! Whether the optimizer has epochs (an epoch has begun).
+  bool epochs;
+  std::vector<std::pair<double, double>> epochTrace;
+  std::vector<std::pair<double, double>> evaluationTrace;
+  Clock::time_point start;
+};
+
+/**
+ * Return the peak resident set size of the whole process in kilobytes, or 0
+ * if it cannot be determined on this platform.  This is a high-water mark of
+ * every run so far, not of the last run: it never decreases.  To measure a
+ * single benchmark, run it alone in its own process with --filter.
+ */
+inline size_t ProcessPeakMemoryKB()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+
+  #if defined(__APPLE__)
+    return size_t(usage.ru_maxrss) / 1024; // Reported in bytes.
+  #else
+    return size_t(usage.ru_maxrss); // Reported in kilobytes.
+  #endif
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Fill in the time to tolerance of the given results, which must all belong to
+ * the same problem.  The reference objective is the best final objective of
+ * any run; a run reaches it when its objective is within the relative
+ * tolerance of it.  Uninstrumented runs only reach it at their end, if at all.
+ *
+ * @param results Results of one problem.
+ * @param tolerance Relative tolerance.
+ */
+inline void ComputeTimeToTolerance(std::vector<BenchResult>& results,
+                                   const double tolerance)
+{
+  double best = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    if (std::isfinite(results[i].finalObjective))
+      best = std::min(best, results[i].finalObjective);
+  }
+
+  const double threshold = best + tolerance * std::max(1.0, std::abs(best));
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    BenchResult& r = results[i];
+    r.timeToTolerance = std::numeric_limits<double>::quiet_NaN();
+
+    for (size_t j = 0; j < r.trace.size(); ++j)
+    {
+      if (r.trace[j].second <= threshold)
+      {
+        r.timeToTolerance = r.trace[j].first;
+        break;
+      }
+    }
+
+    if (std::isnan(r.timeToTolerance) && r.finalObjective <= threshold)
+      r.timeToTolerance = r.time;
+  }
+}
+
+//! Print a number, or nothing if it is not finite.
+inline std::string FormatNumber(const double value, const std::string& empty)
+{
+  if (!std::isfinite(value))
+    return empty;
+
+  std::ostringstream oss;
+  oss.precision(10);
+  oss << value;
+  return oss.str();
+}
+
+//! Return the evaluations per second of the given result.
+inline double EvaluationsPerSecond(const BenchResult& r)
+{
+  if (!r.instrumented || r.time <= 0.0)
+    return std::numeric_limits<double>::quiet_NaN();
+
+  return (r.evaluations + r.gradients) / r.time;
+}
+
+/**
+ * Write the given results as CSV, with one header line.  Unavailable values
+ * are left empty.
+ */
+inline void WriteCSV(std::ostream& out, const std::vector<BenchResult>& results)
+{
+  out << "problem,optimizer,scale,dimension,repetition,time_s,"
+      << "time_to_tolerance_s,evaluations,gradients,evaluations_per_s,"
+      << "final_objective,process_peak_memory_kb" << std::endl;
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult& r = results[i];
+    out << r.problem << "," << r.optimizer << "," << r.scale << ","
+        << r.dimension << "," << r.repetition << ","
+        << FormatNumber(r.time, "") << ","
+        << FormatNumber(r.timeToTolerance, "") << ","
+        << (r.instrumented ? std::to_string(r.evaluations) : "") << ","
+        << (r.instrumented ? std::to_string(r.gradients) : "") << ","
+        << FormatNumber(EvaluationsPerSecond(r), "") << ","
+        << FormatNumber(r.finalObjective, "") << ","
+        << r.processPeakMemoryKB << std::endl;
+  }
+}
+
+/**
+ * Write the given results as a JSON array of objects.  Unavailable values are
+ * written as null.
+ */
+inline void WriteJSON(std::ostream& out,
+                      const std::vector<BenchResult>& results)
+{
+  out << "[" << std::endl;
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult& r = results[i];
+    out << "  { \"problem\": \"" << r.problem << "\", "
+        << "\"optimizer\": \"" << r.optimizer << "\", "
+        << "\"scale\": " << r.scale << ", "
+        << "\"dimension\": " << r.dimension << ", "
+        << "\"repetition\": " << r.repetition << ", "
+        << "\"time_s\": " << FormatNumber(r.time, "null") << ", "
+        << "\"time_to_tolerance_s\": "
+        << FormatNumber(r.timeToTolerance, "null") << ", "
+        << "\"evaluations\": "
+        << (r.instrumented ? std::to_string(r.evaluations) : "null") << ", "
+        << "\"gradients\": "
+        << (r.instrumented ? std::to_string(r.gradients) : "null") << ", "
+        << "\"evaluations_per_s\": "
+        << FormatNumber(EvaluationsPerSecond(r), "null") << ", "
+        << "\"final_objective\": "
+        << FormatNumber(r.finalObjective, "null") << ", "
+        << "\"process_peak_memory_kb\": " << r.processPeakMemoryKB
+        << " }"
+        << ((i + 1 < results.size()) ? "," : "") << std::endl;
+  }
+  out << "]" << std::endl;
+}
+
+} // namespace bench
+} // namespace ens
+
+#endif
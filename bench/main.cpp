@@ -0,0 +1,699 @@
+/**
+ * @file main.cpp
+ * @author agent
+ *
+ * End-to-end benchmark of the ensmallen optimizers on the problems shipped in
+ * ensmallen_bits/problems/ and on the LRSDP test problems.  For every run the
+ * wall-clock time, the time to reach the best objective of the problem within
+ * a tolerance, the number of evaluations per second, the final objective and
+ * the peak memory of the benchmark process so far are reported as CSV or JSON.
+ * The optimizers that take callbacks are instrumented; for the others only the
+ * time and the final objective are known.
+ *
+ * Run `ensmallen_bench --help` for the available options.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <fstream>
+
+#include "bench_tools.hpp"
+
+using namespace ens;
+using namespace ens::bench;
+using namespace ens::test;
+
+/**
+ * The options of the benchmark program.
+ */
+struct BenchOptions
+{
+  BenchOptions() :
+      scale(1.0),
+      repetitions(1),
+      epochs(20),
+      tolerance(1e-3),
+      seed(42),
+      format("csv"),
+      list(false)
+  { }
+
+  //! Multiplier for the size of every problem.
+  double scale;
+  //! Number of times each optimizer is run on each problem.
+  size_t repetitions;
+  //! Number of passes over the data allowed to the stochastic optimizers.
+  size_t epochs;
+  //! Relative tolerance for the time to tolerance.
+  double tolerance;
+  //! Random seed used to generate the problems.
+  size_t seed;
+  //! Output format ("csv" or "json").
+  std::string format;
+  //! Output file; standard output if empty.
+  std::string output;
+  //! Only run the benchmarks whose "problem/optimizer" name contains this.
+  std::string filter;
+  //! If true, only list the benchmarks.
+  bool list;
+};
+
+/**
+ * BenchRunner runs the optimizers on one problem at a time and collects the
+ * results.
+ */
+class BenchRunner
+{
+ public:
+  BenchRunner(const BenchOptions& options) : options(options) { }
+
+  /**
+   * Begin the benchmarks of a new problem.
+   *
+   * @param name Name of the problem.
+   */
+  void BeginProblem(const std::string& name)
+  {
+    problem = name;
+    problemResults.clear();
+  }
+
+  /**
+   * Run an optimizer on the current problem, options.repetitions times.  The
+   * given functor is called with a copy of the initial point and a
+   * BenchRecorder; if the optimizer takes callbacks, the functor should pass
+   * the recorder to Optimize() and instrumented should be true.
+   *
+   * @param name Name of the optimizer.
+   * @param initialPoint Starting point.
+   * @param instrumented Whether the recorder is passed to the optimizer.
+   * @param optimize Functor that runs the optimizer and returns the objective.
+   */
+  template<typename OptimizeType>
+  void Run(const std::string& name,
+           const arma::mat& initialPoint,
+           const bool instrumented,
+           OptimizeType optimize)
+  {
+    const std::string fullName = problem + "/" + name;
+    if (fullName.find(options.filter) == std::string::npos)
+      return;
+
+    if (options.list)
+    {
+      std::cout << fullName << std::endl;
+      return;
+    }
+
+    for (size_t rep = 0; rep < options.repetitions; ++rep)
+    {
+      BenchResult r;
+      r.problem = problem;
+      r.optimizer = name;
+      r.scale = options.scale;
+      r.dimension = initialPoint.n_elem;
+      r.repetition = rep;
+      r.instrumented = instrumented;
+
+      arma::mat coordinates(initialPoint);
+      BenchRecorder recorder;
+
+      const std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      r.finalObjective = optimize(coordinates, recorder);
+      r.time = std::chrono::duration<double>(
+          std::chrono::steady_clock::now() - start).count();
+
+      r.evaluations = recorder.Evaluations();
+      r.gradients = recorder.Gradients();
+      r.trace = recorder.Trace();
+      r.processPeakMemoryKB = ProcessPeakMemoryKB();
+
+      std::cerr << fullName << " (" << rep << "): " << r.time << "s, "
+          << "objective " << r.finalObjective << std::endl;
+
+      problemResults.push_back(r);
+    }
+  }
+
+  /**
+   * Finish the benchmarks of the current problem.
+   */
+  void EndProblem()
+  {
+    ComputeTimeToTolerance(problemResults, options.tolerance);
+    for (size_t i = 0; i < problemResults.size(); ++i)
+    {
+      problemResults[i].trace.clear();
+      results.push_back(problemResults[i]);
+    }
+    problemResults.clear();
+  }
+
+  //! Get the results of all finished problems.
+  const std::vector<BenchResult>& Results() const { return results; }
+
+ private:
+  //! The options of the benchmark program.
+  const BenchOptions& options;
+  //! The name of the current problem.
+  std::string problem;
+  //! The results of the current problem.
+  std::vector<BenchResult> problemResults;
+  //! The results of all finished problems.
+  std::vector<BenchResult> results;
+};
+
+/**
+ * Generate a dataset of Gaussian clusters, one per class, with identity
+ * covariance and centers spread along the diagonal.
+ */
+void GenerateGaussians(const size_t points,
+                       const size_t dimensionality,
+                       const size_t classes,
+                       arma::mat& data,
+                       arma::Row<size_t>& labels)
+{
+  data.randn(dimensionality, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % classes;
+    data.col(i) += 4.0 * labels[i];
+  }
+}
+
+/**
+ * Generate the edges of an Erdos-Renyi random graph, one edge per column.
+ */
+arma::umat GenerateGraph(const size_t vertices, const double probability)
+{
+  std::vector<arma::uword> edges;
+  for (size_t i = 0; i < vertices; ++i)
+  {
+    for (size_t j = i + 1; j < vertices; ++j)
+    {
+      if (arma::randu() < probability)
+      {
+        edges.push_back(i);
+        edges.push_back(j);
+      }
+    }
+  }
+
+  return arma::umat(edges.data(), 2, edges.size() / 2);
+}
+
+void LogisticRegressionBench(BenchRunner& runner, const BenchOptions& options)
+{
+  const size_t points = std::max(size_t(1000 * options.scale), size_t(10));
+  const size_t epochs = options.epochs;
+  const size_t maxIterations = epochs * points;
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateGaussians(points, 10, 2, data, labels);
+  LogisticRegressionFunction<> f(data, labels, 0.5);
+  const arma::mat x0 = f.GetInitialPoint();
+
+  runner.BeginProblem("logistic_regression");
+
+  runner.Run("sgd", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { StandardSGD opt(0.01, 32, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("momentum_sgd", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { MomentumSGD opt(0.01, 32, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("adam", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { Adam opt(0.001, 32, 0.9, 0.999, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("adamax", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { AdaMax opt(0.002, 32, 0.9, 0.999, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("amsgrad", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { AMSGrad opt(0.001, 32, 0.9, 0.999, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("nadam", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { Nadam opt(0.001, 32, 0.9, 0.999, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("adagrad", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { AdaGrad opt(0.99, 32, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("rmsprop", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { RMSProp opt(0.01, 32, 0.99, 1e-8, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("adadelta", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { AdaDelta opt(1.0, 32, 0.95, 1e-6, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("smorms3", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { SMORMS3 opt(0.001, 32, 1e-16, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("sgdr", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { SGDR<> opt(5, 2.0, 32, 0.01, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("snapshot_sgdr", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { SnapshotSGDR<> opt(5, 2.0, 32, 0.01, maxIterations, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("svrg", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { SVRG opt(0.005, 32, epochs, 0, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("slbfgs", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { SLBFGS opt(0.005, 32, epochs, 0, 10, 10, 256, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("lbfgs", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { L_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  runner.Run("more_thuente_lbfgs", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { MoreThuenteL_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  runner.Run("cmaes", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { CMAES<> opt(0, -1, 1, 32, 10 * epochs, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("sep_cmaes", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { SepCMAES<> opt(0, -1, 1, 32, 10 * epochs, 1e-8);
+        return opt.Optimize(f, x, r); });
+  runner.Run("ipop_cmaes", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { IPOP_CMAES<> opt(CMAES<>(0, -1, 1, 32, 10 * epochs, 1e-8), 2, 3);
+        return opt.Optimize(f, x, r); });
+
+  runner.Run("sarah", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { SARAH opt(0.01, 32, epochs, 0, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("katyusha", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { Katyusha opt(1.0, 10.0, 32, epochs, 0, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("bigbatch_sgd", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { BBS_BB opt(32, 0.01, 0.1, maxIterations, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("spalera_sgd", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { SPALeRASGD<> opt(0.05 / 32, 32, maxIterations, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("iqn", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { IQN opt(0.01, 10, epochs, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("l_iqn", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { L_IQN opt(0.01, 10, epochs, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("gradient_descent", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { GradientDescent opt(0.01 / points, 100 * epochs, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("cne", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { CNE opt(50, 10 * epochs, 0.2, 0.2, 0.3, 1e-8, 0.0);
+        return opt.Optimize(f, x); });
+
+  runner.EndProblem();
+}
+
+void SoftmaxRegressionBench(BenchRunner& runner, const BenchOptions& options)
+{
+  const size_t points = std::max(size_t(1000 * options.scale), size_t(10));
+  const size_t epochs = options.epochs;
+
+  arma::mat data;
+  arma::Row<size_t> labels;
+  GenerateGaussians(points, 10, 4, data, labels);
+  SoftmaxRegressionFunction f(data, labels, 4);
+  const arma::mat x0 = f.InitializeWeights();
+
+  runner.BeginProblem("softmax_regression");
+
+  runner.Run("lbfgs", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { L_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  runner.Run("more_thuente_lbfgs", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { MoreThuenteL_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  runner.Run("gradient_descent", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { GradientDescent opt(0.01 / points, 100 * epochs, 1e-8);
+        return opt.Optimize(f, x); });
+  runner.Run("scd", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { SCD<> opt(0.01 / points, 100 * epochs * f.NumFeatures(), 1e-8);
+        return opt.Optimize(f, x); });
+
+  runner.EndProblem();
+}
+
+void GeneralizedRosenbrockBench(BenchRunner& runner,
+                                const BenchOptions& options)
+{
+  const size_t dimensions = std::max(size_t(10 * options.scale), size_t(2));
+  const size_t maxIterations = 1000 * options.epochs * (dimensions - 1);
+
+  GeneralizedRosenbrockFunction f(dimensions);
+  const arma::mat x0 = f.GetInitialPoint();
+
+  runner.BeginProblem("generalized_rosenbrock");
+
+  runner.Run("sgd", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { StandardSGD opt(0.001, 1, maxIterations, 1e-15);
+        return opt.Optimize(f, x, r); });
+  runner.Run("adam", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { Adam opt(0.01, 1, 0.9, 0.999, 1e-8, maxIterations, 1e-15);
+        return opt.Optimize(f, x, r); });
+  runner.Run("lbfgs", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { L_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  runner.Run("more_thuente_lbfgs", x0, true,
+      [&](arma::mat& x, BenchRecorder& r) -> double
+      { MoreThuenteL_BFGS opt;
+        return opt.Optimize(f, x, r); });
+  // The minimum at (1, ..., 1) lies outside of the box, so the bounds are
+  // active at the solution.
+  runner.Run("lbfgs_b", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { L_BFGS_B opt(-2.0, 0.5);
+        return opt.Optimize(f, x, r); });
+  runner.Run("gradient_descent", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { GradientDescent opt(0.001, maxIterations, 1e-15);
+        return opt.Optimize(f, x); });
+  runner.Run("sa", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { ExponentialSchedule schedule;
+        SA<> opt(schedule, maxIterations, 1000., 1000, 100, 1e-10, 3, 1.5,
+            0.5, 0.3);
+        return opt.Optimize(f, x); });
+
+  runner.EndProblem();
+}
+
+void SparseTestBench(BenchRunner& runner, const BenchOptions& options)
+{
+  const size_t maxIterations = 10000 * options.epochs;
+
+  SparseTestFunction f;
+  const arma::mat x0 = f.GetInitialPoint();
+
+  runner.BeginProblem("sparse_test");
+
+  // SparseTestFunction only provides sparse gradients.
+  runner.Run("adam", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { Adam opt(0.01, 1, 0.9, 0.999, 1e-8, maxIterations, 1e-12);
+        return opt.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+            x, r); });
+  runner.Run("adagrad", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { AdaGrad opt(0.99, 1, 1e-8, maxIterations, 1e-12);
+        return opt.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+            x, r); });
+  runner.Run("rmsprop", x0, true, [&](arma::mat& x, BenchRecorder& r) -> double
+      { RMSProp opt(0.01, 1, 0.99, 1e-8, maxIterations, 1e-12);
+        return opt.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+            x, r); });
+  runner.Run("parallel_sgd", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { ParallelSGD<ConstantStep> opt(maxIterations, f.NumFunctions(), 1e-12,
+            true, ConstantStep(0.4));
+        return opt.Optimize(f, x); });
+
+  runner.EndProblem();
+}
+
+void SparseApproximationBench(BenchRunner& runner,
+                              const BenchOptions& options)
+{
+  const size_t rows = std::max(size_t(50 * options.scale), size_t(5));
+  const size_t cols = 2 * rows;
+
+  // b is a combination of a few columns of A, with coefficients inside the
+  // unit l1 ball.
+  const arma::mat A(rows, cols, arma::fill::randn);
+  arma::vec truth(cols, arma::fill::zeros);
+  const size_t nonzeros = std::min(size_t(5), cols);
+  for (size_t i = 0; i < nonzeros; ++i)
+    truth[(i * cols) / nonzeros] = ((i % 2 == 0) ? 1.0 : -1.0) / nonzeros;
+  const arma::vec b = A * truth;
+
+  FuncSq f(A, b);
+  const arma::mat x0(cols, 1, arma::fill::zeros);
+
+  runner.BeginProblem("sparse_approximation");
+
+  runner.Run("frank_wolfe", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { FrankWolfe<ConstrLpBallSolver, UpdateClassic> opt(
+            ConstrLpBallSolver(1), UpdateClassic(), 1000 * options.epochs);
+        return opt.Optimize(f, x); });
+  runner.Run("omp", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+      { OMP opt(ConstrLpBallSolver(1), UpdateSpan(), 1000 * options.epochs);
+        return opt.Optimize(f, x); });
+
+  runner.EndProblem();
+}
+
+void ConstrainedBench(BenchRunner& runner, const BenchOptions& /* options */)
+{
+  // The Gockenbach problem has a fixed size.
+  GockenbachFunction f;
+  const arma::mat x0 = f.GetInitialPoint();
+
+  runner.BeginProblem("gockenbach");
+
+  runner.Run("aug_lagrangian", x0, false,
+      [&](arma::mat& x, BenchRecorder&) -> double
+      { AugLagrangian opt;
+        opt.Optimize(f, x, 0);
+        return f.Evaluate(x); });
+
+  runner.EndProblem();
+}
+
+/**
+ * Set up the Lovasz-Theta SDP of the given graph, as in Monteiro and Burer
+ * 2004, and return the initial point.
+ */
+arma::mat SetupLovaszTheta(const arma::umat& edges,
+                           const size_t vertices,
+                           SDP<arma::mat>& sdp)
+{
+  // C = -(e e^T) = -ones().
+  sdp.C().ones(vertices, vertices);
+  sdp.C() *= -1;
+
+  // b_0 = 1; else = 0.
+  sdp.SparseB().zeros(edges.n_cols + 1);
+  sdp.SparseB()[0] = 1;
+
+  // A_0 = I_n; A_ij only has ones at (i, j) and (j, i).
+  sdp.SparseA()[0].eye(vertices, vertices);
+  for (size_t i = 0; i < edges.n_cols; ++i)
+  {
+    sdp.SparseA()[i + 1].zeros(vertices, vertices);
+    sdp.SparseA()[i + 1](edges(0, i), edges(1, i)) = 1.;
+    sdp.SparseA()[i + 1](edges(1, i), edges(0, i)) = 1.;
+  }
+
+  const size_t m = edges.n_cols + 1;
+  const size_t r = std::min(size_t(std::ceil(0.5 + std::sqrt(0.25 + 2 * m))),
+      vertices);
+  arma::mat coordinates(vertices, r);
+  coordinates.fill(std::sqrt(1.0 / (vertices * m)));
+  for (size_t i = 0; i < r; ++i)
+    coordinates(i, i) += std::sqrt(1.0 / r);
+
+  return coordinates;
+}
+
+/**
+ * Set up the Max-Cut SDP of the given graph and return a feasible initial
+ * point.
+ */
+arma::mat SetupMaxCut(const arma::umat& edges,
+                      const size_t vertices,
+                      SDP<arma::sp_mat>& sdp)
+{
+  // C is the negative graph Laplacian, since we minimize.
+  sdp.C().zeros(vertices, vertices);
+  for (size_t i = 0; i < edges.n_cols; ++i)
+  {
+    sdp.C()(edges(0, i), edges(1, i)) = 1.0;
+    sdp.C()(edges(1, i), edges(0, i)) = 1.0;
+  }
+  for (size_t i = 0; i < vertices; ++i)
+    sdp.C()(i, i) = -arma::accu(sdp.C().row(i));
+
+  sdp.SparseB().ones(vertices);
+  for (size_t i = 0; i < vertices; ++i)
+  {
+    sdp.SparseA()[i].zeros(vertices, vertices);
+    sdp.SparseA()[i](i, i) = 1.;
+  }
+
+  const size_t r = std::min(size_t(std::ceil(0.5 + std::sqrt(0.25 + 2 *
+      edges.n_cols))), vertices);
+  arma::mat coordinates(vertices, r, arma::fill::zeros);
+  for (size_t i = 0; i < vertices; ++i)
+    coordinates(i, i % r) = 1.;
+
+  return coordinates;
+}
+
+void LRSDPBench(BenchRunner& runner, const BenchOptions& options)
+{
+  const size_t vertices = std::max(size_t(50 * options.scale), size_t(5));
+  const arma::umat edges = GenerateGraph(vertices, 0.1);
+
+  runner.BeginProblem("lovasz_theta_sdp");
+  {
+    SDP<arma::mat> sdp(vertices, edges.n_cols + 1, 0);
+    const arma::mat x0 = SetupLovaszTheta(edges, vertices, sdp);
+
+    runner.Run("lrsdp", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+        { LRSDP<SDP<arma::mat>> lrsdp(edges.n_cols + 1, 0, x);
+          lrsdp.SDP() = sdp;
+          lrsdp.AugLag().Lambda().ones(edges.n_cols + 1);
+          lrsdp.AugLag().Lambda() *= -1;
+          lrsdp.AugLag().Lambda()[0] = -double(vertices);
+          return lrsdp.Optimize(x); });
+  }
+  runner.EndProblem();
+
+  runner.BeginProblem("max_cut_sdp");
+  {
+    SDP<arma::sp_mat> sdp(vertices, vertices, 0);
+    const arma::mat x0 = SetupMaxCut(edges, vertices, sdp);
+
+    runner.Run("lrsdp", x0, false, [&](arma::mat& x, BenchRecorder&) -> double
+        { LRSDP<SDP<arma::sp_mat>> lrsdp(vertices, 0, x);
+          lrsdp.SDP() = sdp;
+          return lrsdp.Optimize(x); });
+
+    // The primal-dual solver works on the full X = R R^T.
+    const arma::mat X0 = x0 * x0.t();
+    runner.Run("primal_dual", X0, false,
+        [&](arma::mat& X, BenchRecorder&) -> double
+        { PrimalDualSolver<SDP<arma::sp_mat>> solver(sdp);
+          return solver.Optimize(X); });
+  }
+  runner.EndProblem();
+}
+
+void PrintHelp()
+{
+  std::cout << "Usage: ensmallen_bench [options]\n\n"
+      << "Runs the ensmallen optimizers on the benchmark problems and prints\n"
+      << "one record per run.\n\n"
+      << "Options:\n"
+      << "  --scale S        multiply the size of every problem by S (1)\n"
+      << "  --repetitions N  run every benchmark N times (1)\n"
+      << "  --epochs N       passes over the data for stochastic "
+      << "optimizers (20)\n"
+      << "  --tolerance T    relative tolerance for the time to tolerance "
+      << "(1e-3)\n"
+      << "  --seed N         random seed for the problems (42)\n"
+      << "  --format F       output format: csv or json (csv)\n"
+      << "  --output FILE    write the results to FILE (stdout)\n"
+      << "  --filter STR     only run benchmarks whose \"problem/optimizer\"\n"
+      << "                   name contains STR\n"
+      << "  --list           list the benchmarks and exit\n"
+      << "  --help           print this message\n";
+}
+
+int main(int argc, char** argv)
+{
+  BenchOptions options;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--help")
+    {
+      PrintHelp();
+      return 0;
+    }
+    else if (arg == "--list")
+    {
+      options.list = true;
+      continue;
+    }
+
+    if (i + 1 == argc)
+    {
+      std::cerr << "ensmallen_bench: unknown option or missing value: " << arg
+          << std::endl;
+      return 1;
+    }
+
+    const std::string value(argv[++i]);
+    if (arg == "--scale")
+      options.scale = std::stod(value);
+    else if (arg == "--repetitions")
+      options.repetitions = std::stoul(value);
+    else if (arg == "--epochs")
+      options.epochs = std::stoul(value);
+    else if (arg == "--tolerance")
+      options.tolerance = std::stod(value);
+    else if (arg == "--seed")
+      options.seed = std::stoul(value);
+    else if (arg == "--format")
+      options.format = value;
+    else if (arg == "--output")
+      options.output = value;
+    else if (arg == "--filter")
+      options.filter = value;
+    else
+    {
+      std::cerr << "ensmallen_bench: unknown option: " << arg << std::endl;
+      return 1;
+    }
+  }
+
+  if (options.format != "csv" && options.format != "json")
+  {
+    std::cerr << "ensmallen_bench: unknown format: " << options.format
+        << std::endl;
+    return 1;
+  }
+
+  BenchRunner runner(options);
+
+  // Every problem is generated from the same seed, so that the problems do not
+  // depend on which of the other benchmarks are run.
+  arma::arma_rng::set_seed(options.seed);
+  LogisticRegressionBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  SoftmaxRegressionBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  GeneralizedRosenbrockBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  SparseTestBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  SparseApproximationBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  ConstrainedBench(runner, options);
+  arma::arma_rng::set_seed(options.seed);
+  LRSDPBench(runner, options);
+
+  if (options.list)
+    return 0;
+
+  std::ofstream file;
+  if (!options.output.empty())
+  {
+    file.open(options.output.c_str());
+    if (!file.is_open())
+    {
+      std::cerr << "ensmallen_bench: cannot open " << options.output
+          << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& out = options.output.empty() ? std::cout : file;
+
+  if (options.format == "json")
+    WriteJSON(out, runner.Results());
+  else
+    WriteCSV(out, runner.Results());
+
+  return 0;
+}
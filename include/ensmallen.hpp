@@ -41,11 +41,15 @@
 #include <climits>
 #include <cfloat>
 #include <cstdint>
+#include <chrono>
+#include <initializer_list>
+#include <random>
 #include <stdexcept>
 #include <tuple>
 #include <utility>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <sstream>
 
 // On Visual Studio, disable C4519 (default arguments for function templates)
@@ -61,6 +65,10 @@
 
 #include "ensmallen_bits/problems/problems.hpp" // TODO: should move to another place
 
+#include "ensmallen_bits/callbacks/callbacks.hpp"
+#include "ensmallen_bits/utility/mapped_matrix.hpp"
+#include "ensmallen_bits/utility/memoized_function.hpp"
+
 // TODO: remove mlpack bits from each of these files
 #include "ensmallen_bits/ada_delta/ada_delta.hpp"
 #include "ensmallen_bits/ada_grad/ada_grad.hpp"
@@ -68,6 +76,7 @@
 #include "ensmallen_bits/aug_lagrangian/aug_lagrangian.hpp"
 #include "ensmallen_bits/bigbatch_sgd/bigbatch_sgd.hpp"
 #include "ensmallen_bits/cmaes/cmaes.hpp"
+#include "ensmallen_bits/cmaes/ipop_cmaes.hpp"
 #include "ensmallen_bits/cne/cne.hpp"
 
 #include "ensmallen_bits/function.hpp" // TODO: should move to function/
@@ -76,8 +85,10 @@
 #include "ensmallen_bits/gradient_descent/gradient_descent.hpp"
 // #include "ensmallen_bits/grid_search/grid_search.hpp"
 #include "ensmallen_bits/iqn/iqn.hpp"
+#include "ensmallen_bits/iqn/liqn.hpp"
 #include "ensmallen_bits/katyusha/katyusha.hpp"
 #include "ensmallen_bits/lbfgs/lbfgs.hpp"
+#include "ensmallen_bits/lbfgs/lbfgs_b.hpp"
 #include "ensmallen_bits/line_search/line_search.hpp"
 #include "ensmallen_bits/parallel_sgd/parallel_sgd.hpp"
 #include "ensmallen_bits/proximal/proximal.hpp"
@@ -96,6 +107,7 @@
 #include "ensmallen_bits/sgdr/sgdr.hpp"
 #include "ensmallen_bits/sgdr/snapshot_ensembles.hpp"
 #include "ensmallen_bits/sgdr/snapshot_sgdr.hpp"
+#include "ensmallen_bits/slbfgs/slbfgs.hpp"
 #include "ensmallen_bits/smorms3/smorms3.hpp"
 #include "ensmallen_bits/spalera_sgd/spalera_sgd.hpp"
 #include "ensmallen_bits/svrg/svrg.hpp"
@@ -119,14 +119,25 @@ class AdamType
    * objective value is returned.
    *
    * @tparam DecomposableFunctionType Type of the function to optimize.
+   * @tparam MatType Type of matrix to optimize with.
+   * @tparam GradType Type of matrix to use to represent function gradients.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
-  double Optimize(DecomposableFunctionType& function, arma::mat& iterate)
+  template<typename DecomposableFunctionType,
+           typename MatType,
+           typename GradType = MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(DecomposableFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks)
   {
-    return optimizer.Optimize(function, iterate);
+    return optimizer.template Optimize<DecomposableFunctionType, MatType,
+        GradType, CallbackTypes...>(function, iterate,
+        std::forward<CallbackTypes>(callbacks)...);
   }
 
   //! Get the step size.
@@ -169,6 +180,13 @@ class AdamType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return optimizer.Shuffle(); }
 
+  //! Get the number of parts each batch is split into for thread-parallel
+  //! evaluation; see SGD::NumThreads().
+  size_t NumThreads() const { return optimizer.NumThreads(); }
+  //! Modify the number of parts each batch is split into for thread-parallel
+  //! evaluation.
+  size_t& NumThreads() { return optimizer.NumThreads(); }
+
  private:
   //! The Stochastic Gradient Descent object with Adam policy.
   SGD<UpdateRule> optimizer;
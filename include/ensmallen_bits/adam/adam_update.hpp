@@ -52,57 +52,82 @@ class AdamUpdate
              const double beta2 = 0.999) :
     epsilon(epsilon),
     beta1(beta1),
-    beta2(beta2),
-    iteration(0)
+    beta2(beta2)
   {
     // Nothing to do.
   }
 
   /**
-   * The Initialize method is called by SGD Optimizer method before the start of
-   * the iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
-   */
-  void Initialize(const size_t rows, const size_t cols)
-  {
-    m = arma::zeros<arma::mat>(rows, cols);
-    v = arma::zeros<arma::mat>(rows, cols);
-  }
-
-  /**
-   * Update step for Adam.
-   *
-   * @param iterate Parameters that minimize the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    // Increment the iteration counter variable.
-    ++iteration;
-
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    v *= beta2;
-    v += (1 - beta2) * (gradient % gradient);
-
-    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
-    const double biasCorrection2 = 1.0 - std::pow(beta2, iteration);
+   public:
+    /**
+     * This is called by the optimizer before the start of the iteration update
+     * process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const AdamUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        m(arma::zeros<MatType>(rows, cols)),
+        v(arma::zeros<MatType>(rows, cols)),
+        iteration(0)
+    { /* Do nothing. */ }
 
     /**
-     * It should be noted that the term, m / (arma::sqrt(v) + eps), in the
-     * following expression is an approximation of the following actual term;
-     * m / (arma::sqrt(v) + (arma::sqrt(biasCorrection2) * eps).
+     * Update step for Adam.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
      */
-    iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
-        m / (arma::sqrt(v) + epsilon);
-  }
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      // And update the iterate.
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      v *= parent.beta2;
+      v += (1 - parent.beta2) * (gradient % gradient);
+
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+      const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+
+      /**
+       * It should be noted that the term, m / (arma::sqrt(v) + eps), in the
+       * following expression is an approximation of the following actual term;
+       * m / (arma::sqrt(v) + (arma::sqrt(biasCorrection2) * eps).
+       */
+      iterate -= (stepSize * std::sqrt(biasCorrection2) / biasCorrection1) *
+          m / (arma::sqrt(v) + parent.epsilon);
+    }
+
+   private:
+    //! Instantiated parent object.
+    const AdamUpdate& parent;
+
+    // The exponential moving average of gradient values.
+    MatType m;
+
+    // The exponential moving average of squared gradient values.
+    MatType v;
+
+    // The number of iterations.
+    double iteration;
+  };
 
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
@@ -128,15 +153,97 @@ class AdamUpdate
 
   // The second moment coefficient.
   double beta2;
+};
+
+/**
+ * Lazy Adam update for sparse gradients (GradType = arma::SpMat<>).  Only the
+ * coordinates with a nonzero gradient in the current batch are touched, so each
+ * step costs O(nnz(gradient)) instead of O(rows * cols).
+ *
+ * The decay of the first and second moment estimates that a coordinate missed
+ * while its gradient was zero is applied lazily the next time the coordinate is
+ * touched, so m and v match the dense update exactly.  The only difference to
+ * the dense update is that a coordinate doesn't move during the iterations in
+ * which its gradient is zero (its moment estimates are still decaying then).
+ */
+template<typename MatType, typename eT>
+class AdamUpdate::Policy<MatType, arma::SpMat<eT>>
+{
+ public:
+  /**
+   * This is called by the optimizer before the start of the iteration update
+   * process.
+   *
+   * @param parent Instantiated parent class.
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  Policy(const AdamUpdate& parent, const size_t rows, const size_t cols) :
+      parent(parent),
+      m(arma::zeros<MatType>(rows, cols)),
+      v(arma::zeros<MatType>(rows, cols)),
+      lastIteration(rows, cols, arma::fill::zeros),
+      iteration(0)
+  { /* Do nothing. */ }
+
+  /**
+   * Lazy update step for Adam.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(MatType& iterate,
+              const double stepSize,
+              const arma::SpMat<eT>& gradient)
+  {
+    // Increment the iteration counter variable.
+    ++iteration;
+
+    const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+    const double biasCorrection2 = 1.0 - std::pow(parent.beta2, iteration);
+    const double scale = stepSize * std::sqrt(biasCorrection2) /
+        biasCorrection1;
+
+    typename arma::SpMat<eT>::const_iterator it = gradient.begin();
+    for ( ; it != gradient.end(); ++it)
+    {
+      const size_t row = it.row();
+      const size_t col = it.col();
+      const double g = (*it);
+
+      // Catch up on the decay from the iterations this coordinate skipped.
+      const size_t skipped = iteration - lastIteration(row, col) - 1;
+      if (skipped > 0)
+      {
+        m(row, col) *= std::pow(parent.beta1, (double) skipped);
+        v(row, col) *= std::pow(parent.beta2, (double) skipped);
+      }
+      lastIteration(row, col) = iteration;
+
+      m(row, col) = parent.beta1 * m(row, col) + (1 - parent.beta1) * g;
+      v(row, col) = parent.beta2 * v(row, col) + (1 - parent.beta2) * g * g;
+
+      iterate(row, col) -= scale * m(row, col) /
+          (std::sqrt(v(row, col)) + parent.epsilon);
+    }
+  }
+
+ private:
+  //! Instantiated parent object.
+  const AdamUpdate& parent;
 
   // The exponential moving average of gradient values.
-  arma::mat m;
+  MatType m;
 
   // The exponential moving average of squared gradient values.
-  arma::mat v;
+  MatType v;
+
+  // The iteration at which each coordinate was last updated.
+  arma::Mat<size_t> lastIteration;
 
   // The number of iterations.
-  double iteration;
+  size_t iteration;
 };
 
 } // namespace ens
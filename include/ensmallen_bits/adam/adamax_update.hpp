@@ -54,52 +54,77 @@ class AdaMaxUpdate
                const double beta2 = 0.999) :
     epsilon(epsilon),
     beta1(beta1),
-    beta2(beta2),
-    iteration(0)
+    beta2(beta2)
   {
     // Nothing to do.
   }
 
   /**
-   * The Initialize method is called by SGD Optimizer method before the start of
-   * the iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
-   */
-  void Initialize(const size_t rows, const size_t cols)
-  {
-    m = arma::zeros<arma::mat>(rows, cols);
-    u = arma::zeros<arma::mat>(rows, cols);
-  }
-
-  /**
-   * Update step for Adam.
-   *
-   * @param iterate Parameters that minimize the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    // Increment the iteration counter variable.
-    ++iteration;
-
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    // Update the exponentially weighted infinity norm.
-    u *= beta2;
-    u = arma::max(u, arma::abs(gradient));
-
-    const double biasCorrection1 = 1.0 - std::pow(beta1, iteration);
-
-    if (biasCorrection1 != 0)
-      iterate -= (stepSize / biasCorrection1 * m / (u + epsilon));
-  }
+   public:
+    /**
+     * This is called by the optimizer before the start of the iteration update
+     * process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const AdaMaxUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        m(arma::zeros<MatType>(rows, cols)),
+        u(arma::zeros<MatType>(rows, cols)),
+        iteration(0)
+    { /* Do nothing. */ }
+
+    /**
+     * Update step for Adam.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      // And update the iterate.
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      // Update the exponentially weighted infinity norm.
+      u *= parent.beta2;
+      u = arma::max(u, arma::abs(gradient));
+
+      const double biasCorrection1 = 1.0 - std::pow(parent.beta1, iteration);
+
+      if (biasCorrection1 != 0)
+        iterate -= (stepSize / biasCorrection1 * m / (u + parent.epsilon));
+    }
+
+   private:
+    //! Instantiated parent object.
+    const AdaMaxUpdate& parent;
+
+    // The exponential moving average of gradient values.
+    MatType m;
+
+    // The exponentially weighted infinity norm.
+    MatType u;
+
+    // The number of iterations.
+    double iteration;
+  };
 
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
@@ -125,15 +150,6 @@ class AdaMaxUpdate
 
   // The second moment coefficient.
   double beta2;
-
-  // The exponential moving average of gradient values.
-  arma::mat m;
-
-  // The exponentially weighted infinity norm.
-  arma::mat u;
-
-  // The number of iterations.
-  double iteration;
 };
 
 } // namespace ens
@@ -51,72 +51,101 @@ class NadaMaxUpdate
       beta1(beta1),
       beta2(beta2),
       scheduleDecay(scheduleDecay),
-      cumBeta1(1),
-      iteration(0)
+      cumBeta1(1)
   {
     // Nothing to do.
   }
 
   /**
-   * The Initialize() method is called by the optimizer before the start of the
-   * iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Initialize(const size_t rows, const size_t cols)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    m = arma::zeros<arma::mat>(rows, cols);
-    u = arma::zeros<arma::mat>(rows, cols);
-  }
-
-  /**
-   * Update step for NadaMax.
-   *
-   * @param iterate Parameters that minimize the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
-   */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
-  {
-    // Increment the iteration counter variable.
-    ++iteration;
+   public:
+    /**
+     * This is called by the optimizer before the start of the iteration update
+     * process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const NadaMaxUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        m(arma::zeros<MatType>(rows, cols)),
+        u(arma::zeros<MatType>(rows, cols)),
+        cumBeta1(parent.cumBeta1),
+        iteration(0)
+    { /* Do nothing. */ }
+
+    /**
+     * Update step for NadaMax.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
 
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
+      // And update the iterate.
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
 
-    u = arma::max(u * beta2, arma::abs(gradient));
+      u = arma::max(u * parent.beta2, arma::abs(gradient));
 
-    double beta1T = beta1 * (1 - (0.5 *
-        std::pow(0.96, iteration * scheduleDecay)));
+      double beta1T = parent.beta1 * (1 - (0.5 *
+          std::pow(0.96, iteration * parent.scheduleDecay)));
 
-    double beta1T1 = beta1 * (1 - (0.5 *
-        std::pow(0.96, (iteration + 1) * scheduleDecay)));
+      double beta1T1 = parent.beta1 * (1 - (0.5 *
+          std::pow(0.96, (iteration + 1) * parent.scheduleDecay)));
 
-    cumBeta1 *= beta1T;
+      cumBeta1 *= beta1T;
 
-    const double biasCorrection1 = 1.0 - cumBeta1;
+      const double biasCorrection1 = 1.0 - cumBeta1;
 
-    const double biasCorrection2 = 1.0 - (cumBeta1 * beta1T1);
+      const double biasCorrection2 = 1.0 - (cumBeta1 * beta1T1);
 
-    if ((biasCorrection1 != 0) && (biasCorrection2 != 0))
-    {
-       iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
-           + (beta1T1 / biasCorrection2) * m)) / (u + epsilon);
+      if ((biasCorrection1 != 0) && (biasCorrection2 != 0))
+      {
+         iterate -= (stepSize * (((1 - beta1T) / biasCorrection1) * gradient
+             + (beta1T1 / biasCorrection2) * m)) / (u + parent.epsilon);
+      }
     }
-  }
+
+   private:
+    //! Instantiated parent object.
+    const NadaMaxUpdate& parent;
+
+    // The exponential moving average of gradient values.
+    MatType m;
+
+    // The exponentially weighted infinity norm.
+    MatType u;
+
+    // The cumulative product of decay coefficients.
+    double cumBeta1;
+
+    // The number of iterations.
+    double iteration;
+  };
 
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
   //! Modify the value used to initialise the squared gradient parameter.
   double& Epsilon() { return epsilon; }
 
-  //! Get the value of the cumulative product of decay coefficients
+  //! Get the initial value of the cumulative product of decay coefficients.
   double CumBeta1() const { return cumBeta1; }
-  //! Modify the value of the cumulative product of decay coefficients
+  //! Modify the initial value of the cumulative product of decay coefficients.
   double& CumBeta1() { return cumBeta1; }
 
   //! Get the smoothing parameter.
@@ -144,20 +173,11 @@ class NadaMaxUpdate
   // The second moment coefficient.
   double beta2;
 
-  // The exponential moving average of gradient values.
-  arma::mat m;
-
-  // The exponentially weighted infinity norm.
-  arma::mat u;
-
   // The decay parameter for decay coefficients
   double scheduleDecay;
 
   // The cumulative product of decay coefficients
   double cumBeta1;
-
-  // The number of iterations.
-  double iteration;
 };
 
 } // namespace ens
@@ -51,56 +51,86 @@ class OptimisticAdamUpdate
                        const double beta2 = 0.999) :
     epsilon(epsilon),
     beta1(beta1),
-    beta2(beta2),
-    iteration(0)
+    beta2(beta2)
   {
     // Nothing to do.
   }
 
   /**
-   * The Initialize method is called by SGD Optimizer method before the start of
-   * the iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Initialize(const size_t rows, const size_t cols)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    m = arma::zeros<arma::mat>(rows, cols);
-    v = arma::zeros<arma::mat>(rows, cols);
-    g = arma::zeros<arma::mat>(rows, cols);
-  }
-
-  /**
-   * Update step for OptimisticAdam.
-   *
-   * @param iterate Parameters that minimize the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
-   */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
-  {
-    // Increment the iteration counter variable.
-    ++iteration;
-
-    // And update the iterate.
-    m *= beta1;
-    m += (1 - beta1) * gradient;
-
-    v *= beta2;
-    v += (1 - beta2) * arma::square(gradient);
-
-    arma::mat mCorrected = m / (1.0 - std::pow(beta1, iteration));
-    arma::mat vCorrected = v / (1.0 - std::pow(beta2, iteration));
-
-    arma::mat update = mCorrected / (arma::sqrt(vCorrected) + epsilon);
-
-    iterate -= (2 * stepSize * update - stepSize * g);
-
-    g = std::move(update);
-  }
+   public:
+    /**
+     * This is called by the optimizer before the start of the iteration update
+     * process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const OptimisticAdamUpdate& parent,
+           const size_t rows,
+           const size_t cols) :
+        parent(parent),
+        m(arma::zeros<MatType>(rows, cols)),
+        v(arma::zeros<MatType>(rows, cols)),
+        g(arma::zeros<MatType>(rows, cols)),
+        iteration(0)
+    { /* Do nothing. */ }
+
+    /**
+     * Update step for OptimisticAdam.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      // Increment the iteration counter variable.
+      ++iteration;
+
+      // And update the iterate.
+      m *= parent.beta1;
+      m += (1 - parent.beta1) * gradient;
+
+      v *= parent.beta2;
+      v += (1 - parent.beta2) * arma::square(gradient);
+
+      MatType mCorrected = m / (1.0 - std::pow(parent.beta1, iteration));
+      MatType vCorrected = v / (1.0 - std::pow(parent.beta2, iteration));
+
+      MatType update = mCorrected / (arma::sqrt(vCorrected) + parent.epsilon);
+
+      iterate -= (2 * stepSize * update - stepSize * g);
+
+      g = std::move(update);
+    }
+
+   private:
+    //! Instantiated parent object.
+    const OptimisticAdamUpdate& parent;
+
+    // The exponential moving average of gradient values.
+    MatType m;
+
+    // The exponential moving average of squared gradient values.
+    MatType v;
+
+    // The previous update.
+    MatType g;
+
+    // The number of iterations.
+    double iteration;
+  };
 
   //! Get the value used to initialize the squared gradient parameter.
   double Epsilon() const { return epsilon; }
@@ -126,17 +156,6 @@ class OptimisticAdamUpdate
 
   // The second moment coefficient.
   double beta2;
-
-  // The exponential moving average of gradient values.
-  arma::mat m;
-
-  // The exponential moving average of squared gradient values.
-  arma::mat v;
-  // The previous update.
-  arma::mat g;
-
-  // The number of iterations.
-  double iteration;
 };
 
 } // namespace ens
@@ -0,0 +1,718 @@
+/**
+ * @file callbacks.hpp
+ * @author agent
+ *
+ * Dispatch of optimizer events to user-supplied callbacks.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_CALLBACKS_HPP
+#define ENSMALLEN_CALLBACKS_CALLBACKS_HPP
+
+#include "traits.hpp"
+
+namespace ens {
+
+/**
+ * Callback forwards the events of a running optimizer to any number of
+ * callback objects.  The optimizers that support callbacks take them as a
+ * trailing parameter pack of Optimize(), e.g.
+ *
+ * @code
+ * EvaluationCounter counter;
+ * optimizer.Optimize(f, coordinates, counter, EarlyStopAtMinLoss());
+ * @endcode
+ *
+ * A callback only needs to implement the events it is interested in; all of
+ * them are optional.  Each event may return void, or bool, in which case
+ * returning true terminates the optimization.  The available events are:
+ *
+ * @code
+ * // Called once before and once after the optimization.
+ * void BeginOptimization(OptimizerType&, FunctionType&, MatType& coordinates);
+ * void EndOptimization(OptimizerType&, FunctionType&, MatType& coordinates);
+ *
+ * // Called before and after each epoch (for optimizers that have epochs).
+ * void BeginEpoch(OptimizerType&, FunctionType&, const MatType& coordinates,
+ *                 const size_t epoch, const double objective);
+ * void EndEpoch(OptimizerType&, FunctionType&, const MatType& coordinates,
+ *               const size_t epoch, const double objective);
+ *
+ * // Called after each step taken by the optimizer.
+ * void StepTaken(OptimizerType&, FunctionType&, MatType& coordinates);
+ *
+ * // Called after each objective or gradient evaluation.
+ * void Evaluate(OptimizerType&, FunctionType&, const MatType& coordinates,
+ *               const double objective);
+ * void Gradient(OptimizerType&, FunctionType&, const MatType& coordinates,
+ *               const GradType& gradient);
+ * @endcode
+ *
+ * The events are usually implemented as member templates, so that the same
+ * callback can be used with any optimizer and function.  When no callbacks
+ * are given, every dispatch reduces to a constant false, so there is no
+ * overhead.
+ *
+ * Every epoch that begins also ends, including the last one when the maximum
+ * number of iterations or a callback stops the optimization in the middle of
+ * it.
+ *
+ * Callbacks are supported by SGD and the optimizers built on it (momentum and
+ * Nesterov momentum SGD, Adam and its variants, AdaGrad, AdaDelta, RMSProp,
+ * SMORMS3, SGDR and SnapshotSGDR), SVRG, SLBFGS, L-BFGS, L-BFGS-B, CMA-ES,
+ * SepCMAES and IPOP-CMA-ES.  The remaining optimizers (AugLagrangian, BigBatchSGD, CNE,
+ * FrankWolfe, GradientDescent, GridSearch, IQN, Katyusha, ParallelSGD,
+ * SA, SARAH, SCD, SPALeRASGD, LRSDP and PrimalDualSolver) do not take
+ * callbacks yet.
+ */
+class Callback
+{
+ public:
+  /**
+   * Fire the BeginOptimization() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The starting point.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool BeginOptimization(OptimizerType& optimizer,
+                                FunctionType& function,
+                                MatType& coordinates,
+                                CallbackTypes&... callbacks)
+  {
+    // Every callback sees every event, even after one of them has requested
+    // termination.
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        BeginOptimizationFunction(callbacks, optimizer, function,
+        coordinates) || result... };
+    return result;
+  }
+
+  /**
+   * Fire the EndOptimization() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The final point.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool EndOptimization(OptimizerType& optimizer,
+                              FunctionType& function,
+                              MatType& coordinates,
+                              CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        EndOptimizationFunction(callbacks, optimizer, function,
+        coordinates) || result... };
+    return result;
+  }
+
+  /**
+   * Fire the BeginEpoch() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The current coordinates.
+   * @param epoch The index of the epoch that begins.
+   * @param objective The objective of the previous epoch.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool BeginEpoch(OptimizerType& optimizer,
+                         FunctionType& function,
+                         const MatType& coordinates,
+                         const size_t epoch,
+                         const double objective,
+                         CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        BeginEpochFunction(callbacks, optimizer, function, coordinates, epoch,
+        objective) || result... };
+    return result;
+  }
+
+  /**
+   * Fire the EndEpoch() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The current coordinates.
+   * @param epoch The index of the epoch that ended.
+   * @param objective The objective of the epoch that ended.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool EndEpoch(OptimizerType& optimizer,
+                       FunctionType& function,
+                       const MatType& coordinates,
+                       const size_t epoch,
+                       const double objective,
+                       CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        EndEpochFunction(callbacks, optimizer, function, coordinates, epoch,
+        objective) || result... };
+    return result;
+  }
+
+  /**
+   * Fire the StepTaken() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The coordinates after the step.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool StepTaken(OptimizerType& optimizer,
+                        FunctionType& function,
+                        MatType& coordinates,
+                        CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        StepTakenFunction(callbacks, optimizer, function, coordinates) ||
+        result... };
+    return result;
+  }
+
+  /**
+   * Fire the Evaluate() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The coordinates the objective was evaluated at.
+   * @param objective The objective value.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename... CallbackTypes>
+  static bool Evaluate(OptimizerType& optimizer,
+                       FunctionType& function,
+                       const MatType& coordinates,
+                       const double objective,
+                       CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        EvaluateFunction(callbacks, optimizer, function, coordinates,
+        objective) || result... };
+    return result;
+  }
+
+  /**
+   * Fire the Gradient() event of each callback.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The coordinates the gradient was evaluated at.
+   * @param gradient The gradient.
+   * @param callbacks The callbacks.
+   * @return true if any callback requested termination.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType,
+           typename... CallbackTypes>
+  static bool Gradient(OptimizerType& optimizer,
+                       FunctionType& function,
+                       const MatType& coordinates,
+                       const GradType& gradient,
+                       CallbackTypes&... callbacks)
+  {
+    bool result = false;
+    (void) std::initializer_list<bool>{ result =
+        GradientFunction(callbacks, optimizer, function, coordinates,
+        gradient) || result... };
+    return result;
+  }
+
+ private:
+  //! The signature traits of an optimization-level event.
+  template<typename CallbackType,
+           template<typename, template<typename...> class, size_t> class Has,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  using OptimizationSignature = callbacks::traits::EventSignature<
+      CallbackType, Has,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template OptimizationBoolForm,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template OptimizationVoidForm>;
+
+  //! The signature traits of an epoch-level event.
+  template<typename CallbackType,
+           template<typename, template<typename...> class, size_t> class Has,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  using EpochSignature = callbacks::traits::EventSignature<
+      CallbackType, Has,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template EpochBoolForm,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template EpochVoidForm>;
+
+  //! The signature traits of the StepTaken() event.
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  using StepTakenSignature = callbacks::traits::EventSignature<
+      CallbackType, callbacks::traits::HasStepTaken,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template StepTakenBoolForm,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template StepTakenVoidForm>;
+
+  //! The signature traits of the Evaluate() event.
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  using EvaluateSignature = callbacks::traits::EventSignature<
+      CallbackType, callbacks::traits::HasEvaluate,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template EvaluateBoolForm,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType,
+          MatType>::template EvaluateVoidForm>;
+
+  //! The signature traits of the Gradient() event.
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  using GradientSignature = callbacks::traits::EventSignature<
+      CallbackType, callbacks::traits::HasGradient,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType, MatType,
+          GradType>::template GradientBoolForm,
+      callbacks::traits::TypedForms<OptimizerType, FunctionType, MatType,
+          GradType>::template GradientVoidForm>;
+
+  //! Select the overload for a bool-returning event.
+  template<typename Signature>
+  using IfBool = typename std::enable_if<Signature::hasBool, bool>::type;
+  //! Select the overload for a void-returning event.
+  template<typename Signature>
+  using IfVoid = typename std::enable_if<!Signature::hasBool &&
+      Signature::hasVoid, bool>::type;
+  //! Select the overload for a callback that does not handle the event.
+  template<typename Signature>
+  using IfNone = typename std::enable_if<!Signature::value, bool>::type;
+
+  // The functions below invoke a single callback.  The callback type is
+  // stripped of const, so that temporary callbacks can be used too.
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginOptimization, OptimizerType, FunctionType,
+      MatType>>
+  BeginOptimizationFunction(CallbackType& callback,
+                            OptimizerType& optimizer,
+                            FunctionType& function,
+                            MatType& coordinates)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).BeginOptimization(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginOptimization, OptimizerType, FunctionType,
+      MatType>>
+  BeginOptimizationFunction(CallbackType& callback,
+                            OptimizerType& optimizer,
+                            FunctionType& function,
+                            MatType& coordinates)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).BeginOptimization(optimizer, function, coordinates);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginOptimization, OptimizerType, FunctionType,
+      MatType>>
+  BeginOptimizationFunction(CallbackType& /* callback */,
+                            OptimizerType& /* optimizer */,
+                            FunctionType& /* function */,
+                            MatType& /* coordinates */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndOptimization, OptimizerType, FunctionType,
+      MatType>>
+  EndOptimizationFunction(CallbackType& callback,
+                          OptimizerType& optimizer,
+                          FunctionType& function,
+                          MatType& coordinates)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).EndOptimization(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndOptimization, OptimizerType, FunctionType,
+      MatType>>
+  EndOptimizationFunction(CallbackType& callback,
+                          OptimizerType& optimizer,
+                          FunctionType& function,
+                          MatType& coordinates)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).EndOptimization(optimizer, function, coordinates);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<OptimizationSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndOptimization, OptimizerType, FunctionType,
+      MatType>>
+  EndOptimizationFunction(CallbackType& /* callback */,
+                          OptimizerType& /* optimizer */,
+                          FunctionType& /* function */,
+                          MatType& /* coordinates */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginEpoch, OptimizerType, FunctionType, MatType>>
+  BeginEpochFunction(CallbackType& callback,
+                     OptimizerType& optimizer,
+                     FunctionType& function,
+                     const MatType& coordinates,
+                     const size_t epoch,
+                     const double objective)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).BeginEpoch(optimizer, function, coordinates, epoch,
+        objective);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginEpoch, OptimizerType, FunctionType, MatType>>
+  BeginEpochFunction(CallbackType& callback,
+                     OptimizerType& optimizer,
+                     FunctionType& function,
+                     const MatType& coordinates,
+                     const size_t epoch,
+                     const double objective)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).BeginEpoch(optimizer, function, coordinates, epoch,
+        objective);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasBeginEpoch, OptimizerType, FunctionType, MatType>>
+  BeginEpochFunction(CallbackType& /* callback */,
+                     OptimizerType& /* optimizer */,
+                     FunctionType& /* function */,
+                     const MatType& /* coordinates */,
+                     const size_t /* epoch */,
+                     const double /* objective */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndEpoch, OptimizerType, FunctionType, MatType>>
+  EndEpochFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const size_t epoch,
+                   const double objective)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).EndEpoch(optimizer, function, coordinates, epoch,
+        objective);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndEpoch, OptimizerType, FunctionType, MatType>>
+  EndEpochFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const size_t epoch,
+                   const double objective)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).EndEpoch(optimizer, function, coordinates, epoch,
+        objective);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<EpochSignature<
+      typename std::remove_cv<CallbackType>::type,
+      callbacks::traits::HasEndEpoch, OptimizerType, FunctionType, MatType>>
+  EndEpochFunction(CallbackType& /* callback */,
+                   OptimizerType& /* optimizer */,
+                   FunctionType& /* function */,
+                   const MatType& /* coordinates */,
+                   const size_t /* epoch */,
+                   const double /* objective */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<StepTakenSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  StepTakenFunction(CallbackType& callback,
+                    OptimizerType& optimizer,
+                    FunctionType& function,
+                    MatType& coordinates)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).StepTaken(optimizer, function, coordinates);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<StepTakenSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  StepTakenFunction(CallbackType& callback,
+                    OptimizerType& optimizer,
+                    FunctionType& function,
+                    MatType& coordinates)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).StepTaken(optimizer, function, coordinates);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<StepTakenSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  StepTakenFunction(CallbackType& /* callback */,
+                    OptimizerType& /* optimizer */,
+                    FunctionType& /* function */,
+                    MatType& /* coordinates */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfBool<EvaluateSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  EvaluateFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const double objective)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).Evaluate(optimizer, function, coordinates, objective);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfVoid<EvaluateSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  EvaluateFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const double objective)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).Evaluate(optimizer, function, coordinates, objective);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType>
+  static IfNone<EvaluateSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType>>
+  EvaluateFunction(CallbackType& /* callback */,
+                   OptimizerType& /* optimizer */,
+                   FunctionType& /* function */,
+                   const MatType& /* coordinates */,
+                   const double /* objective */)
+  {
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  static IfBool<GradientSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType, GradType>>
+  GradientFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const GradType& gradient)
+  {
+    return const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).Gradient(optimizer, function, coordinates, gradient);
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  static IfVoid<GradientSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType, GradType>>
+  GradientFunction(CallbackType& callback,
+                   OptimizerType& optimizer,
+                   FunctionType& function,
+                   const MatType& coordinates,
+                   const GradType& gradient)
+  {
+    const_cast<typename std::remove_cv<CallbackType>::type&>(
+        callback).Gradient(optimizer, function, coordinates, gradient);
+    return false;
+  }
+
+  template<typename CallbackType,
+           typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  static IfNone<GradientSignature<
+      typename std::remove_cv<CallbackType>::type, OptimizerType, FunctionType,
+      MatType, GradType>>
+  GradientFunction(CallbackType& /* callback */,
+                   OptimizerType& /* optimizer */,
+                   FunctionType& /* function */,
+                   const MatType& /* coordinates */,
+                   const GradType& /* gradient */)
+  {
+    return false;
+  }
+};
+
+} // namespace ens
+
+// Include the built-in callbacks.
+#include "early_stop_at_min_loss.hpp"
+#include "evaluation_counter.hpp"
+#include "gradient_norm_trace.hpp"
+#include "phase_timer.hpp"
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * @file early_stop_at_min_loss.hpp
+ * @author agent
+ *
+ * Callback that terminates the optimization once the objective has stopped
+ * improving.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_EARLY_STOP_AT_MIN_LOSS_HPP
+#define ENSMALLEN_CALLBACKS_EARLY_STOP_AT_MIN_LOSS_HPP
+
+namespace ens {
+
+/**
+ * EarlyStopAtMinLoss terminates the optimization when the objective of an
+ * epoch has not improved on the best objective seen so far for a given number
+ * of epochs.
+ */
+class EarlyStopAtMinLoss
+{
+ public:
+  /**
+   * Create the EarlyStopAtMinLoss callback.
+   *
+   * @param patience The number of epochs without improvement after which the
+   *     optimization is terminated.
+   */
+  EarlyStopAtMinLoss(const size_t patience = 10) :
+      patience(patience),
+      bestObjective(std::numeric_limits<double>::max()),
+      steps(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Reset the state of the callback at the beginning of the optimization.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The starting point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    bestObjective = std::numeric_limits<double>::max();
+    steps = 0;
+  }
+
+  /**
+   * Check whether the objective of the epoch improved, and request termination
+   * if it did not for too long.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The current coordinates.
+   * @param epoch The index of the epoch that ended.
+   * @param objective The objective of the epoch that ended.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double objective)
+  {
+    if (objective < bestObjective)
+    {
+      bestObjective = objective;
+      steps = 0;
+      return false;
+    }
+
+    if (++steps >= patience)
+    {
+      Info << "EarlyStopAtMinLoss: objective did not improve for " << steps
+          << " epochs; terminating optimization." << std::endl;
+      return true;
+    }
+
+    return false;
+  }
+
+  //! Get the number of epochs without improvement before termination.
+  size_t Patience() const { return patience; }
+  //! Modify the number of epochs without improvement before termination.
+  size_t& Patience() { return patience; }
+
+  //! Get the best epoch objective seen in the last optimization.
+  double BestObjective() const { return bestObjective; }
+
+ private:
+  //! The number of epochs without improvement before termination.
+  size_t patience;
+
+  //! The best epoch objective seen so far.
+  double bestObjective;
+
+  //! The number of epochs since the objective last improved.
+  size_t steps;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,119 @@
+/**
+ * @file evaluation_counter.hpp
+ * @author agent
+ *
+ * Callback that counts the events fired by an optimizer.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_EVALUATION_COUNTER_HPP
+#define ENSMALLEN_CALLBACKS_EVALUATION_COUNTER_HPP
+
+namespace ens {
+
+/**
+ * EvaluationCounter counts the number of objective evaluations, gradient
+ * evaluations, steps and epochs of an optimization.  The counters are reset at
+ * the beginning of each optimization.
+ *
+ * Note that the counts are in terms of calls made by the optimizer; for
+ * decomposable functions, one call may evaluate a whole batch of functions.
+ */
+class EvaluationCounter
+{
+ public:
+  //! Create the EvaluationCounter with all counters set to zero.
+  EvaluationCounter() :
+      evaluations(0),
+      gradients(0),
+      steps(0),
+      epochs(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Reset the counters at the beginning of the optimization.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The starting point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    evaluations = 0;
+    gradients = 0;
+    steps = 0;
+    epochs = 0;
+  }
+
+  //! Count an epoch.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    ++epochs;
+  }
+
+  //! Count a step.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    ++steps;
+  }
+
+  //! Count an objective evaluation.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double /* objective */)
+  {
+    ++evaluations;
+  }
+
+  //! Count a gradient evaluation.
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  void Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const GradType& /* gradient */)
+  {
+    ++gradients;
+  }
+
+  //! Get the number of objective evaluations.
+  size_t Evaluations() const { return evaluations; }
+  //! Get the number of gradient evaluations.
+  size_t Gradients() const { return gradients; }
+  //! Get the number of steps taken.
+  size_t Steps() const { return steps; }
+  //! Get the number of completed epochs.
+  size_t Epochs() const { return epochs; }
+
+ private:
+  //! The number of objective evaluations.
+  size_t evaluations;
+  //! The number of gradient evaluations.
+  size_t gradients;
+  //! The number of steps taken.
+  size_t steps;
+  //! The number of completed epochs.
+  size_t epochs;
+};
+
+} // namespace ens
+
+#endif
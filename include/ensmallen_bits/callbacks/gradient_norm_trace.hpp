@@ -0,0 +1,89 @@
+/**
+ * @file gradient_norm_trace.hpp
+ * @author agent
+ *
+ * Callback that records the norm of every gradient computed by an optimizer.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_GRADIENT_NORM_TRACE_HPP
+#define ENSMALLEN_CALLBACKS_GRADIENT_NORM_TRACE_HPP
+
+namespace ens {
+
+/**
+ * GradientNormTrace records the Frobenius norm of each gradient the optimizer
+ * computes, and optionally prints it to a stream.  The trace is cleared at the
+ * beginning of each optimization.
+ */
+class GradientNormTrace
+{
+ public:
+  /**
+   * Create the GradientNormTrace callback, which only records the norms.
+   */
+  GradientNormTrace() : output(NULL) { /* Nothing to do. */ }
+
+  /**
+   * Create the GradientNormTrace callback, which records the norms and prints
+   * each of them to the given stream.
+   *
+   * @param output Stream to print the gradient norms to.
+   */
+  GradientNormTrace(std::ostream& output) : output(&output)
+  { /* Nothing to do. */ }
+
+  /**
+   * Clear the trace at the beginning of the optimization.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The starting point.
+   */
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    norms.clear();
+  }
+
+  /**
+   * Record the norm of the gradient.
+   *
+   * @param optimizer The optimizer.
+   * @param function The function being optimized.
+   * @param coordinates The coordinates the gradient was evaluated at.
+   * @param gradient The gradient.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  void Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const GradType& gradient)
+  {
+    norms.push_back(arma::norm(gradient, "fro"));
+    if (output)
+      *output << norms.back() << std::endl;
+  }
+
+  //! Get the recorded gradient norms.
+  const std::vector<double>& Norms() const { return norms; }
+
+ private:
+  //! The stream to print to, or NULL.
+  std::ostream* output;
+
+  //! The recorded gradient norms.
+  std::vector<double> norms;
+};
+
+} // namespace ens
+
+#endif
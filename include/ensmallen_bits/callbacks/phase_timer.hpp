@@ -0,0 +1,172 @@
+/**
+ * @file phase_timer.hpp
+ * @author agent
+ *
+ * Callback that measures the wall-clock time spent in each phase of an
+ * optimization.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_PHASE_TIMER_HPP
+#define ENSMALLEN_CALLBACKS_PHASE_TIMER_HPP
+
+namespace ens {
+
+/**
+ * PhaseTimer measures the wall-clock time of an optimization and splits it into
+ * phases.  Since events are fired after the corresponding work is done, the
+ * time elapsed since the previous event is charged to the phase of the event
+ * that ends it:
+ *
+ *  - the time before an Evaluate() or Gradient() event is evaluation time;
+ *  - the time before a StepTaken() event is step (update) time;
+ *  - everything else (shuffling, convergence checks, ...) is other time.
+ *
+ * The duration of each epoch is recorded too.  All times are in seconds, and
+ * are reset at the beginning of each optimization.
+ */
+class PhaseTimer
+{
+ public:
+  //! Create the PhaseTimer with all times set to zero.
+  PhaseTimer() :
+      totalTime(0),
+      evaluationTime(0),
+      stepTime(0)
+  { /* Nothing to do. */ }
+
+  //! Start the timers.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    totalTime = 0;
+    evaluationTime = 0;
+    stepTime = 0;
+    epochTimes.clear();
+
+    start = Clock::now();
+    last = start;
+    epochStart = start;
+  }
+
+  //! Stop the timers.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    totalTime = Seconds(start, Clock::now());
+  }
+
+  //! Mark the beginning of an epoch.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double /* objective */)
+  {
+    last = Clock::now();
+    epochStart = last;
+  }
+
+  //! Record the duration of an epoch.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    last = Clock::now();
+    epochTimes.push_back(Seconds(epochStart, last));
+  }
+
+  //! Charge the elapsed time to the step phase.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    stepTime += Lap();
+  }
+
+  //! Charge the elapsed time to the evaluation phase.
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void Evaluate(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const double /* objective */)
+  {
+    evaluationTime += Lap();
+  }
+
+  //! Charge the elapsed time to the evaluation phase.
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename MatType,
+           typename GradType>
+  void Gradient(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const GradType& /* gradient */)
+  {
+    evaluationTime += Lap();
+  }
+
+  //! Get the total time of the last optimization.
+  double TotalTime() const { return totalTime; }
+  //! Get the time spent evaluating the objective and the gradient.
+  double EvaluationTime() const { return evaluationTime; }
+  //! Get the time spent taking steps.
+  double StepTime() const { return stepTime; }
+  //! Get the time not spent evaluating or taking steps.
+  double OtherTime() const { return totalTime - evaluationTime - stepTime; }
+  //! Get the duration of each epoch.
+  const std::vector<double>& EpochTimes() const { return epochTimes; }
+
+ private:
+  //! The clock used for all measurements.
+  typedef std::chrono::steady_clock Clock;
+
+  //! Return the number of seconds between the two given time points.
+  static double Seconds(const Clock::time_point& from,
+                        const Clock::time_point& to)
+  {
+    return std::chrono::duration<double>(to - from).count();
+  }
+
+  //! Return the time since the last event, and mark the current time.
+  double Lap()
+  {
+    const Clock::time_point now = Clock::now();
+    const double elapsed = Seconds(last, now);
+    last = now;
+    return elapsed;
+  }
+
+  //! The total time of the last optimization.
+  double totalTime;
+  //! The time spent evaluating the objective and the gradient.
+  double evaluationTime;
+  //! The time spent taking steps.
+  double stepTime;
+  //! The duration of each epoch.
+  std::vector<double> epochTimes;
+
+  //! The beginning of the optimization.
+  Clock::time_point start;
+  //! The time of the last event.
+  Clock::time_point last;
+  //! The beginning of the current epoch.
+  Clock::time_point epochStart;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file traits.hpp
+ * @author agent
+ *
+ * This file provides metaprogramming utilities for detecting the optional
+ * event methods of callback classes.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CALLBACKS_TRAITS_HPP
+#define ENSMALLEN_CALLBACKS_TRAITS_HPP
+
+#include <ensmallen_bits/function/sfinae_utility.hpp>
+
+namespace ens {
+namespace callbacks {
+namespace traits {
+
+//! Detect a BeginOptimization() method.
+ENS_HAS_EXACT_METHOD_FORM(BeginOptimization, HasBeginOptimization)
+//! Detect an EndOptimization() method.
+ENS_HAS_EXACT_METHOD_FORM(EndOptimization, HasEndOptimization)
+//! Detect a BeginEpoch() method.
+ENS_HAS_EXACT_METHOD_FORM(BeginEpoch, HasBeginEpoch)
+//! Detect an EndEpoch() method.
+ENS_HAS_EXACT_METHOD_FORM(EndEpoch, HasEndEpoch)
+//! Detect a StepTaken() method.
+ENS_HAS_EXACT_METHOD_FORM(StepTaken, HasStepTaken)
+//! Detect an Evaluate() method.
+ENS_HAS_EXACT_METHOD_FORM(Evaluate, HasEvaluate)
+//! Detect a Gradient() method.
+ENS_HAS_EXACT_METHOD_FORM(Gradient, HasGradient)
+
+/**
+ * TypedForms holds the forms of the event methods a callback may implement.
+ * Every event may either return void, or return bool; returning true requests
+ * that the optimizer terminates.
+ *
+ * @tparam OptimizerType Type of the optimizer that fires the events.
+ * @tparam FunctionType Type of the function being optimized.
+ * @tparam MatType Type of the coordinates.
+ * @tparam GradType Type of the gradient.
+ */
+template<typename OptimizerType,
+         typename FunctionType,
+         typename MatType,
+         typename GradType = MatType>
+struct TypedForms
+{
+  //! The form of an optimization-level event (begin or end).
+  template<typename CallbackType, typename ReturnType>
+  using OptimizationForm = ReturnType(CallbackType::*)(OptimizerType&,
+      FunctionType&, MatType&);
+
+  //! The form of an epoch-level event (begin or end).
+  template<typename CallbackType, typename ReturnType>
+  using EpochForm = ReturnType(CallbackType::*)(OptimizerType&,
+      FunctionType&, const MatType&, const size_t, const double);
+
+  //! The form of a StepTaken() event.
+  template<typename CallbackType, typename ReturnType>
+  using StepTakenForm = ReturnType(CallbackType::*)(OptimizerType&,
+      FunctionType&, MatType&);
+
+  //! The form of an Evaluate() event.
+  template<typename CallbackType, typename ReturnType>
+  using EvaluateForm = ReturnType(CallbackType::*)(OptimizerType&,
+      FunctionType&, const MatType&, const double);
+
+  //! The form of a Gradient() event.
+  template<typename CallbackType, typename ReturnType>
+  using GradientForm = ReturnType(CallbackType::*)(OptimizerType&,
+      FunctionType&, const MatType&, const GradType&);
+
+  //! The bool- and void-returning versions of each form, as needed by the
+  //! method form detectors.
+  template<typename C> using OptimizationBoolForm = OptimizationForm<C, bool>;
+  template<typename C> using OptimizationVoidForm = OptimizationForm<C, void>;
+  template<typename C> using EpochBoolForm = EpochForm<C, bool>;
+  template<typename C> using EpochVoidForm = EpochForm<C, void>;
+  template<typename C> using StepTakenBoolForm = StepTakenForm<C, bool>;
+  template<typename C> using StepTakenVoidForm = StepTakenForm<C, void>;
+  template<typename C> using EvaluateBoolForm = EvaluateForm<C, bool>;
+  template<typename C> using EvaluateVoidForm = EvaluateForm<C, void>;
+  template<typename C> using GradientBoolForm = GradientForm<C, bool>;
+  template<typename C> using GradientVoidForm = GradientForm<C, void>;
+};
+
+/**
+ * EventSignature collects whether the given callback implements an event with
+ * a bool-returning signature (hasBool) or a void-returning signature
+ * (hasVoid).  The event is selected by passing the detector (e.g.
+ * HasBeginEpoch) and the two forms to look for.
+ */
+template<typename CallbackType,
+         template<typename, template<typename...> class, size_t> class Has,
+         template<typename...> class BoolForm,
+         template<typename...> class VoidForm>
+struct EventSignature
+{
+  const static bool hasBool = Has<CallbackType, BoolForm, 0>::value;
+  const static bool hasVoid = Has<CallbackType, VoidForm, 0>::value;
+  const static bool value = hasBool || hasVoid;
+};
+
+} // namespace traits
+} // namespace callbacks
+} // namespace ens
+
+#endif
@@ -17,6 +17,8 @@
 
 #include "full_selection.hpp"
 #include "random_selection.hpp"
+#include "full_covariance.hpp"
+#include "diagonal_covariance.hpp"
 
 namespace ens {
 
@@ -57,9 +59,24 @@ namespace ens {
  * the first point in the dataset (presumably, the dataset is held internally in
  * the DecomposableFunctionType).
  *
+ * The offspring of each generation can be evaluated in parallel; see
+ * NumThreads().  The offspring are still sampled serially, and every offspring
+ * (and the mean of each generation) is evaluated with its own seed for the
+ * selection policy, drawn from Armadillo's random number generator; so the
+ * result for a given seed does not depend on the number of threads.  The
+ * selection policy must provide a
+ * Select(function, batchSize, iterate, seed) method.
+ *
+ * The covariance policy determines how much of the covariance matrix of the
+ * search distribution is adapted: FullCovariance adapts the full matrix, while
+ * DiagonalCovariance only adapts its diagonal (separable CMA-ES; see SepCMAES),
+ * in linear time and memory.
+ *
  * @tparam SelectionPolicy The selection strategy used for the evaluation step.
+ * @tparam CovariancePolicyType The covariance matrix adaptation strategy.
  */
-template<typename SelectionPolicyType = FullSelection>
+template<typename SelectionPolicyType = FullSelection,
+         typename CovariancePolicyType = FullCovariance>
 class CMAES
 {
  public:
@@ -80,6 +97,9 @@ class CMAES
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param selectionPolicy Instantiated selection policy used to calculate the
    *     objective.
+   * @param numThreads Number of parts the population is split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).  See NumThreads().
    */
   CMAES(const size_t lambda = 0,
         const double lowerBound = -10,
@@ -87,20 +107,29 @@ class CMAES
         const size_t batchSize = 32,
         const size_t maxIterations = 1000,
         const double tolerance = 1e-5,
-        const SelectionPolicyType& selectionPolicy = SelectionPolicyType());
+        const SelectionPolicyType& selectionPolicy = SelectionPolicyType(),
+        const size_t numThreads = 1);
 
   /**
    * Optimize the given function using CMA-ES. The given starting point will be
    * modified to store the finishing point of the algorithm, and the final
    * objective value is returned.
    *
+   * Any number of callbacks may be given after the iterate; see Callback for
+   * the events they can handle.  An epoch is one generation, and the
+   * coordinates passed to the events are the best point found so far.
+   *
    * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
-  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the step size.
   size_t PopulationSize() const { return lambda; }
@@ -137,6 +166,31 @@ class CMAES
   //! Modify the selection policy.
   SelectionPolicyType& SelectionPolicy() { return selectionPolicy; }
 
+  /**
+   * Get the number of parts the population is split into for thread-parallel
+   * evaluation.  If it is not 1, the offspring of each generation are split
+   * into that many contiguous ranges (or one per OpenMP thread if it is 0),
+   * which are evaluated in parallel.  Each offspring is a separate matrix, but
+   * the Evaluate() method of the function (and the Select() method of the
+   * selection policy) must be safe to call concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the population is split into for
+  //! thread-parallel evaluation.
+  size_t& NumThreads() { return numThreads; }
+
+  //! Get the step size of the search distribution; after Optimize() it holds
+  //! the final step size, and during it the step size of the current
+  //! generation.
+  double StepSize() const { return sigma; }
+
+  //! Get the covariance policy, which holds the covariance of the last
+  //! optimization.
+  const CovariancePolicyType& CovariancePolicy() const
+  { return covariancePolicy; }
+  //! Modify the covariance policy.
+  CovariancePolicyType& CovariancePolicy() { return covariancePolicy; }
+
  private:
   //! Population size.
   size_t lambda;
@@ -158,6 +212,17 @@ class CMAES
 
   //! The selection policy used to calculate the objective.
   SelectionPolicyType selectionPolicy;
+
+  //! The number of parts the population is split into for parallel
+  //! evaluation.
+  size_t numThreads;
+
+  //! The covariance policy, which adapts the covariance of the search
+  //! distribution.
+  CovariancePolicyType covariancePolicy;
+
+  //! The step size of the search distribution.
+  double sigma;
 };
 
 /**
@@ -166,6 +231,13 @@ class CMAES
 template<typename SelectionPolicyType = RandomSelection>
 using ApproxCMAES = CMAES<SelectionPolicyType>;
 
+/**
+ * Convenient typedef for separable CMA-ES, which only adapts the diagonal of
+ * the covariance matrix.
+ */
+template<typename SelectionPolicyType = FullSelection>
+using SepCMAES = CMAES<SelectionPolicyType, DiagonalCovariance>;
+
 } // namespace ens
 
 // Include implementation.
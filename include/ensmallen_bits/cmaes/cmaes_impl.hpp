@@ -22,28 +22,34 @@
 
 namespace ens {
 
-template<typename SelectionPolicyType>
-CMAES<SelectionPolicyType>::CMAES(const size_t lambda,
-                                  const double lowerBound,
-                                  const double upperBound,
-                                  const size_t batchSize,
-                                  const size_t maxIterations,
-                                  const double tolerance,
-                                  const SelectionPolicyType& selectionPolicy) :
+template<typename SelectionPolicyType, typename CovariancePolicyType>
+CMAES<SelectionPolicyType, CovariancePolicyType>::CMAES(
+    const size_t lambda,
+    const double lowerBound,
+    const double upperBound,
+    const size_t batchSize,
+    const size_t maxIterations,
+    const double tolerance,
+    const SelectionPolicyType& selectionPolicy,
+    const size_t numThreads) :
     lambda(lambda),
     lowerBound(lowerBound),
     upperBound(upperBound),
     batchSize(batchSize),
     maxIterations(maxIterations),
     tolerance(tolerance),
-    selectionPolicy(selectionPolicy)
+    selectionPolicy(selectionPolicy),
+    numThreads(numThreads),
+    sigma(0)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
-template<typename SelectionPolicyType>
-template<typename DecomposableFunctionType>
-double CMAES<SelectionPolicyType>::Optimize(
-    DecomposableFunctionType& function, arma::mat& iterate)
+template<typename SelectionPolicyType, typename CovariancePolicyType>
+template<typename DecomposableFunctionType, typename... CallbackTypes>
+double CMAES<SelectionPolicyType, CovariancePolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackTypes&&... callbacks)
 {
   // Make sure that we have the methods that we need.  Long name...
   traits::CheckNonDifferentiableDecomposableFunctionTypeAPI<
@@ -66,8 +72,7 @@ double CMAES<SelectionPolicyType>::Optimize(
   const double muEffective = 1 / arma::accu(arma::pow(w, 2));
 
   // Step size control parameters.
-  arma::vec sigma(3);
-  sigma(0) = 0.3 * (upperBound - lowerBound);
+  sigma = 0.3 * (upperBound - lowerBound);
   const double cs = (muEffective + 2) / (iterate.n_elem + muEffective + 5);
   const double ds = 1 + cs + 2 * std::max(std::sqrt((muEffective - 1) /
       (iterate.n_elem + 1)) - 1, 0.0);
@@ -80,180 +85,158 @@ double CMAES<SelectionPolicyType>::Optimize(
       (4 + iterate.n_elem + 2 * muEffective / iterate.n_elem);
   const double h = (1.4 + 2.0 / (iterate.n_elem + 1.0)) * enn;
 
-  const double c1 = 2 / (std::pow(iterate.n_elem + 1.3, 2) + muEffective);
+  // The covariance policy may learn fewer parameters, and then learn faster.
+  covariancePolicy.Reset(iterate.n_elem, lambda);
+  const double learningRateFactor = covariancePolicy.LearningRateFactor();
+
+  const double c1 = std::min(1.0, learningRateFactor * 2 /
+      (std::pow(iterate.n_elem + 1.3, 2) + muEffective));
   const double alphaMu = 2;
-  const double cmu = std::min(1 - c1, alphaMu * (muEffective - 2 + 1 /
-      muEffective) / (std::pow(iterate.n_elem + 2, 2) +
+  const double cmu = std::min(1 - c1, learningRateFactor * alphaMu *
+      (muEffective - 2 + 1 / muEffective) / (std::pow(iterate.n_elem + 2, 2) +
       alphaMu * muEffective / 2));
 
-  arma::cube mPosition(iterate.n_rows, iterate.n_cols, 3);
-  mPosition.slice(0) = lowerBound + arma::randu(
-      iterate.n_rows, iterate.n_cols) * (upperBound - lowerBound);
+  // The search distribution is handled in vectorized form: the mean, the
+  // paths and every offspring are vectors of iterate.n_elem elements.  The
+  // whole population is kept in the columns of one matrix, so that it is
+  // sampled and recombined with matrix products.
+  const size_t n = iterate.n_elem;
+
+  // The mean of the search distribution, and an alias of it in the shape of
+  // the iterate.
+  arma::vec mPosition = lowerBound + arma::randu<arma::vec>(n) *
+      (upperBound - lowerBound);
+  const arma::mat mIterate(mPosition.memptr(), iterate.n_rows,
+      iterate.n_cols, false, true);
 
-  arma::mat step = arma::zeros(iterate.n_rows, iterate.n_cols);
+  arma::vec step = arma::zeros(n);
 
   // Calculate the first objective function.
   double currentObjective = 0;
   for (size_t f = 0; f < numFunctions; f += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-    currentObjective += function.Evaluate(mPosition.slice(0), f,
-        effectiveBatchSize);
+    currentObjective += function.Evaluate(mIterate, f, effectiveBatchSize);
   }
 
   double overallObjective = currentObjective;
   double lastObjective = DBL_MAX;
-
-  // Population parameters.
-  arma::cube pStep(iterate.n_rows, iterate.n_cols, lambda);
-  arma::cube pPosition(iterate.n_rows, iterate.n_cols, lambda);
+  iterate = mIterate;
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+  terminate |= Callback::BeginOptimization(*this, function, iterate,
+      callbacks...);
+
+  // Population parameters; the workspace is reused by every generation.
+  arma::mat pNoise(n, lambda);
+  arma::mat pStep(n, lambda);
+  arma::mat pPosition(n, lambda);
+  arma::mat pBestStep(n, mu);
   arma::vec pObjective(lambda);
-  arma::cube ps = arma::zeros(iterate.n_rows, iterate.n_cols, 2);
-  arma::cube pc = ps;
-  arma::cube C(iterate.n_elem, iterate.n_elem, 2);
-  C.slice(0).eye();
-
-  // Covariance matrix parameters.
-  arma::vec eigval;
-  arma::mat eigvec;
-  arma::vec eigvalZero = arma::zeros(iterate.n_elem);
+  arma::vec ps = arma::zeros(n);
+  arma::vec pc = arma::zeros(n);
+  arma::vec transformedStep(n);
 
   // The current visitation order (sorted by population objectives).
   arma::uvec idx = arma::linspace<arma::uvec>(0, lambda - 1, lambda);
 
-  // Now iterate!
-  for (size_t i = 1; i < maxIterations; ++i)
-  {
-    // To keep track of where we are.
-    const size_t idx0 = (i - 1) % 2;
-    const size_t idx1 = i % 2;
+  // The number of parts the population is evaluated in.
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, lambda), size_t(1));
 
-    const arma::mat covLower = arma::chol(C.slice(idx0), "lower");
+  // The seeds of the selection policy for each offspring and for the mean.
+  arma::uvec seeds(lambda + 1);
 
-    for (size_t j = 0; j < lambda; ++j)
+  // Now iterate!
+  for (size_t i = 1; i < maxIterations && !terminate; ++i)
+  {
+    // A generation is an epoch.
+    terminate |= Callback::BeginEpoch(*this, function, iterate, i,
+        overallObjective, callbacks...);
+
+    // Sample the whole population at once.
+    covariancePolicy.Factorize();
+    pNoise.randn();
+    covariancePolicy.Transform(pNoise, pStep);
+
+    pPosition = sigma * pStep;
+    pPosition.each_col() += mPosition;
+
+    // Draw the seeds serially, so that they do not depend on the number of
+    // threads.
+    seeds = arma::randi<arma::uvec>(lambda + 1, arma::distr_param(0,
+        std::numeric_limits<int>::max()));
+
+    // Calculate the objective function of every offspring.  The loop variable
+    // is signed for OpenMP 2.0 compilers.
+    ENS_PRAGMA_OMP_PARALLEL_FOR
+    for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
     {
-      if (iterate.n_rows > iterate.n_cols)
+      const size_t partBegin = (size_t(p) * lambda) / numParts;
+      const size_t partEnd = ((size_t(p) + 1) * lambda) / numParts;
+      for (size_t j = partBegin; j < partEnd; ++j)
       {
-        pStep.slice(idx(j)) = covLower *
-            arma::randn(iterate.n_rows, iterate.n_cols);
+        // Evaluate the offspring in place, in the shape of the iterate.
+        const arma::mat position(pPosition.colptr(j), iterate.n_rows,
+            iterate.n_cols, false, true);
+        pObjective(j) = selectionPolicy.Select(function, batchSize, position,
+            seeds(j));
       }
-      else
-      {
-        pStep.slice(idx(j)) = arma::randn(iterate.n_rows, iterate.n_cols) *
-            covLower;
-      }
-
-      pPosition.slice(idx(j)) = mPosition.slice(idx0) + sigma(idx0) *
-          pStep.slice(idx(j));
-
-      // Calculate the objective function.
-      pObjective(idx(j)) = selectionPolicy.Select(function, batchSize,
-          pPosition.slice(idx(j)));
     }
 
     // Sort population.
     idx = sort_index(pObjective);
 
-    step = w(0) * pStep.slice(idx(0));
-    for (size_t j = 1; j < mu; ++j)
-      step += w(j) * pStep.slice(idx(j));
+    // Recombine the best steps.
+    pBestStep = pStep.cols(idx.head(mu));
+    step = pBestStep * w;
 
-    mPosition.slice(idx1) = mPosition.slice(idx0) + sigma(idx0) * step;
+    mPosition += sigma * step;
 
     // Calculate the objective function.
-    currentObjective = selectionPolicy.Select(function, batchSize,
-          mPosition.slice(idx1));
+    currentObjective = selectionPolicy.Select(function, batchSize, mIterate,
+        seeds(lambda));
 
     // Update best parameters.
     if (currentObjective < overallObjective)
     {
       overallObjective = currentObjective;
-      iterate = mPosition.slice(idx1);
+      iterate = mIterate;
     }
 
-    // Update Step Size.
-    if (iterate.n_rows > iterate.n_cols)
-    {
-      ps.slice(idx1) = (1 - cs) * ps.slice(idx0) + std::sqrt(
-          cs * (2 - cs) * muEffective) * covLower.t() * step;
-    }
-    else
-    {
-      ps.slice(idx1) = (1 - cs) * ps.slice(idx0) + std::sqrt(
-          cs * (2 - cs) * muEffective) * step * covLower.t();
-    }
+    // Update Step Size.  The path is accumulated in the coordinates where the
+    // search distribution is isotropic, so its expected length is enn if the
+    // selection is random.
+    covariancePolicy.Whiten(step, transformedStep);
+    ps = (1 - cs) * ps + std::sqrt(cs * (2 - cs) * muEffective) *
+        transformedStep;
 
-    const double psNorm = arma::norm(ps.slice(idx1));
-    sigma(idx1) = sigma(idx0) * std::pow(
-        std::exp(cs / ds * psNorm / enn - 1), 0.3);
+    const double psNorm = arma::norm(ps);
+    sigma *= std::exp(cs / ds * (psNorm / enn - 1));
 
-    // Update covariance matrix.
+    // Update covariance matrix.  Without the rank-one update of the evolution
+    // path, its variance is kept in the covariance instead.
+    double decay = 1 - c1 - cmu;
     if ((psNorm / sqrt(1 - std::pow(1 - cs, 2 * i))) < h)
     {
-      pc.slice(idx1) = (1 - cc) * pc.slice(idx0) + std::sqrt(cc * (2 - cc) *
-        muEffective) * step;
-
-
-      if (iterate.n_rows > iterate.n_cols)
-      {
-        C.slice(idx1) = (1 - c1 - cmu) * C.slice(idx0) + c1 *
-          (pc.slice(idx1) * pc.slice(idx1).t());
-      }
-      else
-      {
-        C.slice(idx1) = (1 - c1 - cmu) * C.slice(idx0) + c1 *
-          (pc.slice(idx1).t() * pc.slice(idx1));
-      }
+      pc = (1 - cc) * pc + std::sqrt(cc * (2 - cc) * muEffective) * step;
     }
     else
     {
-      pc.slice(idx1) = (1 - cc) * pc.slice(idx0);
-
-      if (iterate.n_rows > iterate.n_cols)
-      {
-        C.slice(idx1) = (1 - c1 - cmu) * C.slice(idx0) + c1 * (pc.slice(idx1) *
-            pc.slice(idx1).t() + (cc * (2 - cc)) * C.slice(idx0));
-      }
-      else
-      {
-        C.slice(idx1) = (1 - c1 - cmu) * C.slice(idx0) + c1 *
-            (pc.slice(idx1).t() * pc.slice(idx1) + (cc * (2 - cc)) *
-            C.slice(idx0));
-      }
+      pc *= (1 - cc);
+      decay += c1 * cc * (2 - cc);
     }
 
-    if (iterate.n_rows > iterate.n_cols)
-    {
-      for (size_t j = 0; j < mu; ++j)
-      {
-        C.slice(idx1) = C.slice(idx1) + cmu * w(j) *
-            pStep.slice(idx(j)) * pStep.slice(idx(j)).t();
-      }
-    }
-    else
-    {
-      for (size_t j = 0; j < mu; ++j)
-      {
-        C.slice(idx1) = C.slice(idx1) + cmu * w(j) *
-            pStep.slice(idx(j)).t() * pStep.slice(idx(j));
-      }
-    }
+    covariancePolicy.Update(decay, c1, pc, cmu, w, pBestStep);
 
-    arma::eig_sym(eigval, eigvec, C.slice(idx1));
-    const arma::uvec negativeEigval = find(eigval < 0, 1);
-    if (!negativeEigval.is_empty())
-    {
-      if (negativeEigval(0) == 0)
-      {
-        C.slice(idx1).zeros();
-      }
-      else
-      {
-        C.slice(idx1) = eigvec.cols(0, negativeEigval(0) - 1) *
-            arma::diagmat(eigval.subvec(0, negativeEigval(0) - 1)) *
-            eigvec.cols(0, negativeEigval(0) - 1).t();
-      }
-    }
+    // The coordinates of the epoch are the best point so far.
+    terminate |= Callback::EndEpoch(*this, function, iterate, i,
+        overallObjective, callbacks...);
 
     // Output current objective function.
     Info << "CMA-ES: iteration " << i << ", objective " << overallObjective
@@ -263,19 +246,20 @@ double CMAES<SelectionPolicyType>::Optimize(
     {
       Warn << "CMA-ES: converged to " << overallObjective << "; "
           << "terminating with failure.  Try a smaller step size?" << std::endl;
-      return overallObjective;
+      break;
     }
 
     if (std::abs(lastObjective - overallObjective) < tolerance)
     {
       Info << "CMA-ES: minimized within tolerance " << tolerance << "; "
           << "terminating optimization." << std::endl;
-      return overallObjective;
+      break;
     }
 
     lastObjective = overallObjective;
   }
 
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
   return overallObjective;
 }
 
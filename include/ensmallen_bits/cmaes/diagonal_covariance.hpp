@@ -0,0 +1,121 @@
+/**
+ * @file diagonal_covariance.hpp
+ * @author agent
+ *
+ * Diagonal covariance matrix for separable CMA-ES.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CMAES_DIAGONAL_COVARIANCE_HPP
+#define ENSMALLEN_CMAES_DIAGONAL_COVARIANCE_HPP
+
+namespace ens {
+
+/**
+ * Adapt only the diagonal of the covariance matrix of the search distribution
+ * (separable CMA-ES).  It takes O(n) memory and O(n lambda) time per generation
+ * for n coordinates and a population of lambda, so it can be used on problems
+ * with many coordinates, at the cost of not learning correlations between
+ * them.  Since there are only n parameters to learn, the learning rates are
+ * scaled up by (n + 2) / 3.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Ros2008,
+ *   author    = {Ros, Raymond and Hansen, Nikolaus},
+ *   title     = {A Simple Modification in CMA-ES Achieving Linear Time and
+ *                Space Complexity},
+ *   booktitle = {Parallel Problem Solving from Nature -- PPSN X},
+ *   year      = {2008},
+ *   pages     = {296--305},
+ *   publisher = {Springer},
+ * }
+ * @endcode
+ */
+class DiagonalCovariance
+{
+ public:
+  /**
+   * Reset the covariance to the identity.
+   *
+   * @param n Number of coordinates.
+   * @param lambda Population size (unused).
+   */
+  void Reset(const size_t n, const size_t /* lambda */)
+  {
+    variance.ones(n);
+    deviation.ones(n);
+  }
+
+  //! The factor the learning rates of the covariance are scaled with.
+  double LearningRateFactor() const { return (variance.n_elem + 2) / 3.0; }
+
+  //! Compute the standard deviations, which are used for sampling until the
+  //! next call.
+  void Factorize() { deviation = arma::sqrt(variance); }
+
+  /**
+   * Transform standard normal samples into samples with the covariance.
+   *
+   * @param z Standard normal samples, one per column.
+   * @param steps Matrix to store the transformed samples in.
+   */
+  void Transform(const arma::mat& z, arma::mat& steps) const
+  {
+    steps = z;
+    steps.each_col() %= deviation;
+  }
+
+  /**
+   * Transform a step with the inverse square root of the covariance, as
+   * needed for the update of the step size.
+   *
+   * @param step Step.
+   * @param transformed Vector to store the transformed step in.
+   */
+  void Whiten(const arma::vec& step, arma::vec& transformed) const
+  {
+    transformed = step / deviation;
+  }
+
+  /**
+   * Update the diagonal of the covariance with the evolution path (rank-one
+   * update) and the best steps of the generation (rank-mu update).
+   *
+   * @param decay Factor the old covariance is scaled with.
+   * @param c1 Learning rate of the rank-one update.
+   * @param pc Evolution path.
+   * @param cmu Learning rate of the rank-mu update.
+   * @param w Weights of the best steps.
+   * @param bestSteps Best steps of the generation, one per column, sorted by
+   *     objective.
+   */
+  void Update(const double decay,
+              const double c1,
+              const arma::vec& pc,
+              const double cmu,
+              const arma::vec& w,
+              const arma::mat& bestSteps)
+  {
+    variance = decay * variance + c1 * arma::square(pc) +
+        cmu * (arma::square(bestSteps) * w);
+  }
+
+  //! Get the diagonal of the covariance.
+  const arma::vec& Variance() const { return variance; }
+
+ private:
+  //! The diagonal of the covariance.
+  arma::vec variance;
+
+  //! The square root of the diagonal of the covariance.
+  arma::vec deviation;
+};
+
+} // namespace ens
+
+#endif
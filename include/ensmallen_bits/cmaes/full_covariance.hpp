@@ -0,0 +1,203 @@
+/**
+ * @file full_covariance.hpp
+ * @author agent
+ *
+ * Full covariance matrix for CMA-ES.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CMAES_FULL_COVARIANCE_HPP
+#define ENSMALLEN_CMAES_FULL_COVARIANCE_HPP
+
+namespace ens {
+
+/**
+ * Adapt the full covariance matrix of the search distribution; this is the
+ * original CMA-ES.  It takes O(n^2) memory for n coordinates.
+ *
+ * Offspring are sampled with the eigendecomposition C = B D^2 B^T of the
+ * covariance.  Since the covariance changes slowly, the decomposition is only
+ * recomputed once every n / (lambda (c1 + cmu)) generations, for a population
+ * of lambda; in between, a generation takes O(n^2) time instead of O(n^3).
+ * For more information on the lazy update, see the following tutorial.
+ *
+ * @code
+ * @article{Hansen2016,
+ *   author  = {Hansen, Nikolaus},
+ *   title   = {The {CMA} Evolution Strategy: A Tutorial},
+ *   journal = {CoRR},
+ *   volume  = {abs/1604.00772},
+ *   year    = {2016},
+ * }
+ * @endcode
+ */
+class FullCovariance
+{
+ public:
+  //! Construct the policy; the covariance is set by Reset().
+  FullCovariance() :
+      lambda(1),
+      updateGap(1),
+      updates(0),
+      decompositions(0)
+  { }
+
+  /**
+   * Reset the covariance to the identity.
+   *
+   * @param n Number of coordinates.
+   * @param lambda Population size.
+   */
+  void Reset(const size_t n, const size_t lambda)
+  {
+    covariance.eye(n, n);
+    transformation.eye(n, n);
+    eigvec.eye(n, n);
+    inverseDeviation.ones(n);
+    this->lambda = lambda;
+    updateGap = 1;
+    updates = 0;
+    decompositions = 0;
+  }
+
+  //! The factor the learning rates of the covariance are scaled with.
+  double LearningRateFactor() const { return 1.0; }
+
+  /**
+   * Recompute the eigendecomposition of the covariance if it has been updated
+   * often enough since the last decomposition; the decomposition is used for
+   * sampling until it is recomputed.  Negative eigenvalues (from rounding
+   * errors) are dropped, from the decomposition and from the covariance.
+   */
+  void Factorize()
+  {
+    if (updates < updateGap)
+      return;
+
+    updates = 0;
+    ++decompositions;
+
+    // Rounding errors may make the covariance slightly asymmetric.
+    covariance = arma::symmatu(covariance);
+    arma::eig_sym(eigval, eigvec, covariance);
+
+    if (eigval.min() < 0)
+    {
+      eigval.elem(arma::find(eigval < 0)).zeros();
+      covariance = eigvec * arma::diagmat(eigval) * eigvec.t();
+    }
+
+    // B D, so that B D z has the covariance.
+    const arma::vec deviation = arma::sqrt(eigval);
+    transformation = eigvec;
+    transformation.each_row() %= deviation.t();
+
+    // D^-1, with the directions of zero variance left out.
+    inverseDeviation.zeros(deviation.n_elem);
+    const arma::uvec positive = arma::find(deviation > 0);
+    inverseDeviation.elem(positive) = 1.0 / deviation.elem(positive);
+  }
+
+  /**
+   * Transform standard normal samples into samples with the covariance, with
+   * a single matrix product.
+   *
+   * @param z Standard normal samples, one per column.
+   * @param steps Matrix to store the transformed samples in.
+   */
+  void Transform(const arma::mat& z, arma::mat& steps) const
+  {
+    steps = transformation * z;
+  }
+
+  /**
+   * Transform a step with the inverse square root of the covariance,
+   * C^(-1/2) = B D^-1 B^T, as needed for the update of the step size.
+   *
+   * @param step Step.
+   * @param transformed Vector to store the transformed step in.
+   */
+  void Whiten(const arma::vec& step, arma::vec& transformed) const
+  {
+    transformed = eigvec * (inverseDeviation % (eigvec.t() * step));
+  }
+
+  /**
+   * Update the covariance with the evolution path (rank-one update) and the
+   * best steps of the generation (rank-mu update).  The rank-mu update is a
+   * single weighted matrix product.
+   *
+   * @param decay Factor the old covariance is scaled with.
+   * @param c1 Learning rate of the rank-one update.
+   * @param pc Evolution path.
+   * @param cmu Learning rate of the rank-mu update.
+   * @param w Weights of the best steps.
+   * @param bestSteps Best steps of the generation, one per column, sorted by
+   *     objective.
+   */
+  void Update(const double decay,
+              const double c1,
+              const arma::vec& pc,
+              const double cmu,
+              const arma::vec& w,
+              const arma::mat& bestSteps)
+  {
+    weightedSteps = bestSteps;
+    weightedSteps.each_row() %= w.t();
+
+    covariance *= decay;
+    covariance += c1 * (pc * pc.t());
+    covariance += cmu * (weightedSteps * bestSteps.t());
+
+    // The smaller the learning rates, the longer the decomposition stays
+    // accurate.
+    updateGap = std::max(size_t(1), (size_t) (covariance.n_rows /
+        (lambda * (c1 + cmu))));
+    ++updates;
+  }
+
+  //! Get the covariance matrix.
+  const arma::mat& Covariance() const { return covariance; }
+
+  //! Get the number of eigendecompositions since the last Reset().
+  size_t Decompositions() const { return decompositions; }
+
+ private:
+  //! The covariance matrix.
+  arma::mat covariance;
+
+  //! The transformation B D from the eigendecomposition of the covariance.
+  arma::mat transformation;
+
+  //! Workspace for the weighted best steps of the rank-mu update.
+  arma::mat weightedSteps;
+
+  //! Eigenvalues of the covariance.
+  arma::vec eigval;
+
+  //! Eigenvectors of the covariance.
+  arma::mat eigvec;
+
+  //! Inverse square roots of the eigenvalues of the covariance (zero for the
+  //! eigenvalues that are zero).
+  arma::vec inverseDeviation;
+
+  //! The population size.
+  size_t lambda;
+
+  //! The number of updates after which the decomposition is recomputed.
+  size_t updateGap;
+
+  //! The number of updates since the last decomposition.
+  size_t updates;
+
+  //! The number of eigendecompositions since the last Reset().
+  size_t decompositions;
+};
+
+} // namespace ens
+
+#endif
@@ -45,6 +45,25 @@ class FullSelection
 
     return objective;
   }
+
+  /**
+   * Select the full dataset to calculate the objective function.  The selection
+   * is not random, so the seed is ignored.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be evaluated.
+   * @param function Function to optimize.
+   * @param batchSize Batch size to use for each step.
+   * @param iterate starting point.
+   * @param seed Seed of the selection (ignored).
+   */
+  template<typename DecomposableFunctionType>
+  double Select(DecomposableFunctionType& function,
+                const size_t batchSize,
+                const arma::mat& iterate,
+                const size_t /* seed */)
+  {
+    return Select(function, batchSize, iterate);
+  }
 };
 
 } // namespace ens
@@ -0,0 +1,237 @@
+/**
+ * @file ipop_cmaes.hpp
+ * @author agent
+ *
+ * CMA-ES with restarts and increasing population size (IPOP-CMA-ES), and its
+ * bi-population variant (BIPOP-CMA-ES).
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CMAES_IPOP_CMAES_HPP
+#define ENSMALLEN_CMAES_IPOP_CMAES_HPP
+
+#include "cmaes.hpp"
+
+namespace ens {
+
+/**
+ * IPOP-CMA-ES runs CMA-ES several times from random starting points, and
+ * multiplies the population size by a constant factor for every restart, so
+ * that multimodal functions (such as the Rastrigin or Schwefel functions) are
+ * searched more and more globally.  The best point of all runs is returned.
+ *
+ * With the BIPOP option, the restarts alternate between this regime of
+ * increasing population sizes and runs with a small, random population size,
+ * which are better at weakly structured functions.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Auger2005,
+ *   author    = {Auger, Anne and Hansen, Nikolaus},
+ *   title     = {A Restart {CMA} Evolution Strategy With Increasing
+ *                Population Size},
+ *   booktitle = {IEEE Congress on Evolutionary Computation},
+ *   year      = {2005},
+ *   pages     = {1769--1776},
+ * }
+ *
+ * @inproceedings{Hansen2009,
+ *   author    = {Hansen, Nikolaus},
+ *   title     = {Benchmarking a {BI}-Population {CMA-ES} on the {BBOB}-2009
+ *                Function Testbed},
+ *   booktitle = {Genetic and Evolutionary Computation Conference},
+ *   year      = {2009},
+ *   pages     = {2389--2396},
+ * }
+ * @endcode
+ *
+ * The runs are independent, so several of them can run concurrently; see
+ * ConcurrentRuns().  The runs share the best objective found so far, and a run
+ * is stopped early when its best objective is worse than that, and has not
+ * improved for 10 + 30 n / lambda generations (n coordinates, population size
+ * lambda).  Every run draws its random numbers from Armadillo's random number
+ * generator.  The runs on the calling thread continue its generator, which is
+ * never reseeded, so with one run at a time the result only depends on the
+ * caller's seed.  The generators of the other threads (which are thread-local
+ * with C++11) are reseeded for every run they execute, with a seed drawn
+ * before any run starts.  Which runs execute on the calling thread and which
+ * runs are stopped early depends on the timing of the concurrent runs,
+ * though.
+ *
+ * The step size of each run is derived from the bounds by CMAES, so unlike the
+ * original BIPOP-CMA-ES, the runs with a small population do not use a smaller
+ * step size.  The regimes alternate, instead of being balanced by their
+ * evaluation budgets, so that the population sizes of all runs are known
+ * before any run starts.
+ *
+ * The function requirements are the same as for CMAES; if runs are executed
+ * concurrently, the Evaluate() method of the function must be safe to call
+ * concurrently.
+ *
+ * @tparam SelectionPolicyType The selection strategy used for the evaluation
+ *     step.
+ * @tparam CovariancePolicyType The covariance matrix adaptation strategy.
+ */
+template<typename SelectionPolicyType = FullSelection,
+         typename CovariancePolicyType = FullCovariance>
+class IPOP_CMAES
+{
+ public:
+  //! The type of the optimizer of each run.
+  typedef CMAES<SelectionPolicyType, CovariancePolicyType> CMAESType;
+
+  /**
+   * Construct the IPOP-CMA-ES optimizer.  The population size of the given
+   * CMA-ES optimizer is the population size of the first run (0 means the
+   * default size); its other parameters are used by every run.
+   *
+   * @param cmaes CMA-ES optimizer used for each run.
+   * @param populationFactor Factor the population size is multiplied with for
+   *     each restart.
+   * @param maxRestarts Maximum number of restarts.
+   * @param bipop If true, alternate with runs with a small population size
+   *     (BIPOP-CMA-ES).
+   * @param concurrentRuns Number of runs executed concurrently (1 means one at
+   *     a time, 0 means one per OpenMP thread).
+   */
+  IPOP_CMAES(const CMAESType& cmaes = CMAESType(),
+             const double populationFactor = 2,
+             const size_t maxRestarts = 9,
+             const bool bipop = false,
+             const size_t concurrentRuns = 1);
+
+  /**
+   * Optimize the given function using IPOP-CMA-ES.  The given starting point
+   * will be modified to store the best point of all runs, and its objective
+   * value is returned.
+   *
+   * The callbacks are passed to every run, and see the events of the CMAES
+   * optimizer of that run; a callback that requests termination stops that
+   * run.  If runs are executed concurrently, the callbacks must be safe to
+   * call concurrently.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks passed to every run.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
+
+  //! Get the CMA-ES optimizer used for each run.
+  const CMAESType& CMAESOptimizer() const { return cmaes; }
+  //! Modify the CMA-ES optimizer used for each run.
+  CMAESType& CMAESOptimizer() { return cmaes; }
+
+  //! Get the factor the population size is multiplied with per restart.
+  double PopulationFactor() const { return populationFactor; }
+  //! Modify the factor the population size is multiplied with per restart.
+  double& PopulationFactor() { return populationFactor; }
+
+  //! Get the maximum number of restarts.
+  size_t MaxRestarts() const { return maxRestarts; }
+  //! Modify the maximum number of restarts.
+  size_t& MaxRestarts() { return maxRestarts; }
+
+  //! Get whether runs with a small population size are interleaved.
+  bool BIPOP() const { return bipop; }
+  //! Modify whether runs with a small population size are interleaved.
+  bool& BIPOP() { return bipop; }
+
+  //! Get the number of runs executed concurrently (0 means one per OpenMP
+  //! thread).
+  size_t ConcurrentRuns() const { return concurrentRuns; }
+  //! Modify the number of runs executed concurrently (0 means one per OpenMP
+  //! thread).
+  size_t& ConcurrentRuns() { return concurrentRuns; }
+
+ private:
+  /**
+   * The state shared by the concurrent runs.
+   */
+  struct SharedState
+  {
+    //! The best objective of all runs so far.
+    double bestObjective;
+    //! The index of the next run to start.
+    size_t nextRun;
+  };
+
+  /**
+   * A callback that publishes the objective of a run to the shared state, and
+   * stops the run when it is unpromising.
+   */
+  class RunMonitor
+  {
+   public:
+    RunMonitor(SharedState& state, const size_t patience) :
+        state(state),
+        patience(patience),
+        runBest(DBL_MAX),
+        stalled(0)
+    { }
+
+    template<typename OptimizerType, typename FunctionType, typename MatType>
+    bool EndEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double objective)
+    {
+      if (objective < runBest)
+      {
+        runBest = objective;
+        stalled = 0;
+      }
+      else
+      {
+        ++stalled;
+      }
+
+      bool worse;
+      ENS_PRAGMA_OMP_CRITICAL
+      {
+        state.bestObjective = std::min(state.bestObjective, runBest);
+        worse = (runBest > state.bestObjective);
+      }
+
+      return worse && stalled >= patience;
+    }
+
+   private:
+    SharedState& state;
+    size_t patience;
+    double runBest;
+    size_t stalled;
+  };
+
+  //! The CMA-ES optimizer used for each run.
+  CMAESType cmaes;
+
+  //! The factor the population size is multiplied with for each restart.
+  double populationFactor;
+
+  //! The maximum number of restarts.
+  size_t maxRestarts;
+
+  //! Whether runs with a small population size are interleaved.
+  bool bipop;
+
+  //! The number of runs executed concurrently.
+  size_t concurrentRuns;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "ipop_cmaes_impl.hpp"
+
+#endif
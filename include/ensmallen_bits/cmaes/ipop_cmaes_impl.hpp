@@ -0,0 +1,156 @@
+/**
+ * @file ipop_cmaes_impl.hpp
+ * @author agent
+ *
+ * Implementation of IPOP-CMA-ES and BIPOP-CMA-ES.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_CMAES_IPOP_CMAES_IMPL_HPP
+#define ENSMALLEN_CMAES_IPOP_CMAES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ipop_cmaes.hpp"
+
+namespace ens {
+
+template<typename SelectionPolicyType, typename CovariancePolicyType>
+IPOP_CMAES<SelectionPolicyType, CovariancePolicyType>::IPOP_CMAES(
+    const CMAESType& cmaes,
+    const double populationFactor,
+    const size_t maxRestarts,
+    const bool bipop,
+    const size_t concurrentRuns) :
+    cmaes(cmaes),
+    populationFactor(populationFactor),
+    maxRestarts(maxRestarts),
+    bipop(bipop),
+    concurrentRuns(concurrentRuns)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename SelectionPolicyType, typename CovariancePolicyType>
+template<typename DecomposableFunctionType, typename... CallbackTypes>
+double IPOP_CMAES<SelectionPolicyType, CovariancePolicyType>::Optimize(
+    DecomposableFunctionType& function,
+    arma::mat& iterate,
+    CallbackTypes&&... callbacks)
+{
+  const size_t numRuns = maxRestarts + 1;
+
+  // The population size of the first run; this is the default population size
+  // of CMAES.
+  const size_t defaultLambda = (cmaes.PopulationSize() == 0) ?
+      (4 + std::round(3 * std::log(iterate.n_elem))) * 10 :
+      cmaes.PopulationSize();
+
+  // Determine the population size of every run before any run starts, so that
+  // they do not depend on the order the runs finish in.
+  std::vector<size_t> lambdas(numRuns);
+  size_t largeLambda = defaultLambda;
+  for (size_t run = 0; run < numRuns; ++run)
+  {
+    if (run == 0)
+    {
+      lambdas[run] = defaultLambda;
+    }
+    else if (!bipop || run % 2 == 1)
+    {
+      // Regime of increasing population sizes.
+      largeLambda = (size_t) std::round(largeLambda * populationFactor);
+      lambdas[run] = largeLambda;
+    }
+    else
+    {
+      // Regime of small population sizes, between the default size and half
+      // of the current large population size.
+      const double u = arma::randu();
+      lambdas[run] = std::max(defaultLambda, (size_t) std::floor(defaultLambda *
+          std::pow(0.5 * largeLambda / defaultLambda, u * u)));
+    }
+  }
+
+  std::vector<arma::mat> runIterates(numRuns, iterate);
+  std::vector<double> runObjectives(numRuns, DBL_MAX);
+
+  SharedState state;
+  state.bestObjective = DBL_MAX;
+  state.nextRun = 0;
+
+  size_t numWorkers = concurrentRuns;
+  #ifdef ENS_USE_OPENMP
+    if (numWorkers == 0)
+      numWorkers = omp_get_max_threads();
+  #endif
+  numWorkers = std::max(std::min(numWorkers, numRuns), size_t(1));
+
+  // The seeds of the runs that are not executed on the calling thread.
+  arma::uvec seeds;
+  if (numWorkers > 1)
+  {
+    seeds = arma::randi<arma::uvec>(numRuns, arma::distr_param(0,
+        std::numeric_limits<int>::max()));
+  }
+
+  // Each worker takes the next run that has not been started, until all runs
+  // are done.  The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t worker = 0; worker < (ptrdiff_t) numWorkers; ++worker)
+  {
+    while (true)
+    {
+      size_t run;
+      ENS_PRAGMA_OMP_CRITICAL
+      {
+        run = state.nextRun++;
+      }
+
+      if (run >= numRuns)
+        break;
+
+      CMAESType runOptimizer(cmaes);
+      runOptimizer.PopulationSize() = lambdas[run];
+
+      RunMonitor monitor(state, 10 + (size_t) std::ceil(30.0 * iterate.n_elem /
+          lambdas[run]));
+
+      // Only the generators of the other threads are reseeded; the caller's
+      // generator keeps its state.
+      size_t threadId = 0;
+      #ifdef ENS_USE_OPENMP
+        threadId = omp_get_thread_num();
+      #endif
+      if (threadId != 0)
+        arma::arma_rng::set_seed(seeds(run));
+
+      runObjectives[run] = runOptimizer.Optimize(function, runIterates[run],
+          monitor, callbacks...);
+
+      ENS_PRAGMA_OMP_CRITICAL
+      {
+        Info << "IPOP-CMA-ES: run " << run << " with population size "
+            << lambdas[run] << " finished with objective "
+            << runObjectives[run] << "." << std::endl;
+      }
+    }
+  }
+
+  // Return the best point of all runs; ties go to the earliest run, so that
+  // the result does not depend on the order the runs finished in.
+  size_t best = 0;
+  for (size_t run = 1; run < numRuns; ++run)
+  {
+    if (runObjectives[run] < runObjectives[best])
+      best = run;
+  }
+
+  iterate = runIterates[best];
+  return runObjectives[best];
+}
+
+} // namespace ens
+
+#endif
@@ -65,6 +65,44 @@ class RandomSelection
     return objective;
   }
 
+  /**
+   * Randomly select dataset points to calculate the objective function, drawing
+   * them from a generator seeded with the given seed instead of Armadillo's
+   * random number generator.  The selection only depends on the seed, so this
+   * can be called concurrently for different iterates with reproducible
+   * results.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be evaluated.
+   * @param function Function to optimize.
+   * @param batchSize Batch size to use for each step.
+   * @param iterate starting point.
+   * @param seed Seed of the selection.
+   */
+  template<typename DecomposableFunctionType>
+  double Select(DecomposableFunctionType& function,
+                const size_t batchSize,
+                const arma::mat& iterate,
+                const size_t seed)
+  {
+    // Find the number of functions to use.
+    const size_t numFunctions = function.NumFunctions();
+
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<size_t> distribution(0, numFunctions - 1);
+
+    double objective = 0;
+    for (size_t f = 0; f < std::floor(numFunctions * fraction); f += batchSize)
+    {
+      const size_t selection = distribution(generator);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - selection);
+
+      objective += function.Evaluate(iterate, selection, effectiveBatchSize);
+    }
+
+    return objective;
+  }
+
  private:
   //! Dataset fraction parameter.
   double fraction;
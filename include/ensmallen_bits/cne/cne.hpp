@@ -67,6 +67,18 @@ namespace ens {
  * This class must implement the following function:
  *
  *   double Evaluate(const arma::mat& iterate);
+ *
+ * The candidates of each generation can be evaluated in parallel; see
+ * NumThreads().  Every candidate is a separate matrix, and all random numbers
+ * are drawn serially outside of the evaluation, so the result for a given seed
+ * does not depend on the number of threads.
+ *
+ * Only the candidates that changed since the previous generation are
+ * evaluated: the best candidate, and the elite candidates that no mutation
+ * happened to touch, keep their fitness.  Children that crossover and
+ * mutation left equal to a candidate of the previous generation are still
+ * evaluated; to avoid that, wrap the function in a MemoizedFunction that holds
+ * about two generations (a cache of 2 * populationSize points).
  */
 class CNE
 {
@@ -91,6 +103,9 @@ class CNE
    * @param objectiveChange Minimum change in best fitness values between two
    *     consecutive generations should be greater than threshold. If set to
    *     negative value, objectiveChange is not considered.
+   * @param numThreads Number of parts the population is split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).  See NumThreads().
    */
   CNE(const size_t populationSize = 500,
       const size_t maxGenerations = 5000,
@@ -98,7 +113,8 @@ class CNE
       const double mutationSize = 0.02,
       const double selectPercent = 0.2,
       const double tolerance = 1e-5,
-      const double objectiveChange = 1e-5);
+      const double objectiveChange = 1e-5,
+      const size_t numThreads = 1);
 
   /**
    * Optimize the given function using CNE. The given
@@ -148,6 +164,18 @@ class CNE
   //! Modify the termination criteria of change in fitness value.
   double& ObjectiveChange() { return objectiveChange; }
 
+  /**
+   * Get the number of parts the population is split into for thread-parallel
+   * evaluation.  If it is not 1, the candidates of each generation are split
+   * into that many contiguous ranges (or one per OpenMP thread if it is 0),
+   * which are evaluated in parallel.  The Evaluate() method of the function
+   * must then be safe to call concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the population is split into for
+  //! thread-parallel evaluation.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! Reproduce candidates to create the next generation.
   void Reproduce();
@@ -178,9 +206,21 @@ class CNE
   //! Vector of fintness values corresponding to each candidate.
   arma::vec fitnessValues;
 
+  //! Whether each candidate changed since its fitness was computed.
+  std::vector<bool> changed;
+
   //! Index of sorted fitness values.
   arma::uvec index;
 
+  //! Buffer for the random selection of the parent of each weight.
+  arma::vec crossoverSelection;
+
+  //! Buffer for the random draws that decide which weights are mutated.
+  arma::vec mutationProbabilities;
+
+  //! Buffer for the mutation noise.
+  arma::vec mutationNoise;
+
   //! The number of candidates in the population.
   size_t populationSize;
 
@@ -202,6 +242,10 @@ class CNE
   //! Minimum change in best fitness values between two generations.
   double objectiveChange;
 
+  //! The number of parts the population is split into for parallel
+  //! evaluation.
+  size_t numThreads;
+
   //! Number of candidates to become parent for the next generation.
   size_t numElite;
 
@@ -26,7 +26,8 @@ inline CNE::CNE(const size_t populationSize,
                 const double mutationSize,
                 const double selectPercent,
                 const double tolerance,
-                const double objectiveChange) :
+                const double objectiveChange,
+                const size_t numThreads) :
     populationSize(populationSize),
     maxGenerations(maxGenerations),
     mutationProb(mutationProb),
@@ -34,6 +35,7 @@ inline CNE::CNE(const size_t populationSize,
     selectPercent(selectPercent),
     tolerance(tolerance),
     objectiveChange(objectiveChange),
+    numThreads(numThreads),
     numElite(0),
     elements(0)
 { /* Nothing to do here. */ }
@@ -79,6 +81,26 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   // initializing helper variables.
   fitnessValues.set_size(populationSize);
 
+  // No candidate has been evaluated yet.
+  changed.assign(populationSize, true);
+  std::vector<size_t> pending;
+  pending.reserve(populationSize);
+  size_t reusedEvaluations = 0;
+
+  // The random numbers of a crossover or a mutation are drawn into these
+  // buffers, so that no memory is allocated during the evolution.
+  crossoverSelection.set_size(elements);
+  mutationProbabilities.set_size(elements);
+  mutationNoise.set_size(elements);
+
+  // The number of parts the population is evaluated in.
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, populationSize), size_t(1));
+
   Info << "CNE initialized successfully. Optimization started."
       << std::endl;
 
@@ -88,15 +110,40 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   // Iterate until maximum number of generations is obtained.
   for (size_t gen = 1; gen <= maxGenerations; gen++)
   {
-    // Calculating fitness values of all candidates.
+    // Only the candidates that changed since they were last evaluated need to
+    // be evaluated; the others (at least the best candidate) keep their
+    // fitness.
+    pending.clear();
     for (size_t i = 0; i < populationSize; i++)
     {
-       // Select a candidate and insert the parameters in the function.
-       iterate = population.slice(i);
+      if (changed[i])
+        pending.push_back(i);
+    }
+    reusedEvaluations += populationSize - pending.size();
+
+    // Calculating fitness values of the changed candidates.  The loop variable
+    // is signed for OpenMP 2.0 compilers.
+    const size_t numPending = pending.size();
+    ENS_PRAGMA_OMP_PARALLEL_FOR
+    for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
+    {
+      const size_t partBegin = (size_t(p) * numPending) / numParts;
+      const size_t partEnd = ((size_t(p) + 1) * numPending) / numParts;
+      for (size_t k = partBegin; k < partEnd; k++)
+      {
+        const size_t i = pending[k];
 
-       // Find fitness of candidate.
-       fitnessValues[i] = function.Evaluate(iterate);
+        // Evaluate the candidate in place, through an alias of its slice (the
+        // slice objects of a cube may be created lazily, which is not safe to
+        // do concurrently).
+        const arma::mat candidate(population.slice_memptr(i),
+            population.n_rows, population.n_cols, false, true);
+
+        // Find fitness of candidate.
+        fitnessValues[i] = function.Evaluate(candidate);
+      }
     }
+    changed.assign(populationSize, false);
 
     Info << "Generation number: " << gen << " best fitness = "
         << fitnessValues.min() << std::endl;
@@ -125,10 +172,14 @@ double CNE::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
     lastBestFitness = fitnessValues.min();
   }
 
-  // Set the best candidate into the network parameters.
+  Info << "CNE::Optimize(): reused the fitness of " << reusedEvaluations
+      << " unchanged candidates." << std::endl;
+
+  // Set the best candidate into the network parameters.  Reproduce() does not
+  // change the best candidate, so its fitness is still known.
   iterate = population.slice(index(0));
 
-  return function.Evaluate(iterate);
+  return fitnessValues[index(0)];
 }
 
 //! Reproduce candidates to create the next generation.
@@ -143,7 +194,7 @@ inline void CNE::Reproduce()
   // Second parent.
   size_t dad;
 
-  for (size_t i = numElite; i < populationSize - 1; i++)
+  for (size_t i = numElite; i < populationSize - 1; i += 2)
   {
     // Select 2 different parents from elite group randomly [0, numElite).
     mom = arma::as_scalar(arma::randi<arma::uvec>(
@@ -181,27 +232,26 @@ inline void CNE::Crossover(const size_t mom,
                            const size_t child1,
                            const size_t child2)
 {
-  // Replace the candidates with parents at their place.
-  population.slice(child1) = population.slice(mom);
-  population.slice(child2) = population.slice(dad);
-
-  // Preallocate random selection vector (values between 0 and 1).
-  arma::vec selection = arma::randu(elements);
+  // Work on the memory of the slices directly: the children are blended from
+  // the parents element by element.
+  const double* momMemory = population.slice_memptr(mom);
+  const double* dadMemory = population.slice_memptr(dad);
+  double* child1Memory = population.slice_memptr(child1);
+  double* child2Memory = population.slice_memptr(child2);
+  changed[child1] = true;
+  changed[child2] = true;
+
+  // Random selection vector (values between 0 and 1).
+  crossoverSelection.randu();
 
   // Randomly alter mom and dad genome weights to get two different children.
   for (size_t i = 0; i < elements; i++)
   {
-    // Using it to alter the weights of the children.
-    if (selection(i) > 0.5)
-    {
-      population.slice(child1)(i) = population.slice(mom)(i);
-      population.slice(child2)(i) = population.slice(dad)(i);
-    }
-    else
-    {
-      population.slice(child1)(i) = population.slice(dad)(i);
-      population.slice(child2)(i) = population.slice(mom)(i);
-    }
+    const bool fromMom = (crossoverSelection[i] > 0.5);
+    const double momWeight = momMemory[i];
+    const double dadWeight = dadMemory[i];
+    child1Memory[i] = fromMom ? momWeight : dadWeight;
+    child2Memory[i] = fromMom ? dadWeight : momWeight;
   }
 }
 
@@ -212,9 +262,18 @@ inline void CNE::Mutate()
   // The best candidate is not altered.
   for (size_t i = 1; i < populationSize; i++)
   {
-    population.slice(index(i)) += (arma::randu(
-        population.n_rows, population.n_cols) < mutationProb) %
-        (mutationSize * arma::randn(population.n_rows, population.n_cols));
+    mutationProbabilities.randu();
+    mutationNoise.randn();
+
+    double* candidate = population.slice_memptr(index(i));
+    for (size_t j = 0; j < elements; j++)
+    {
+      if (mutationProbabilities[j] < mutationProb)
+      {
+        candidate[j] += mutationSize * mutationNoise[j];
+        changed[index(i)] = true;
+      }
+    }
   }
 }
 
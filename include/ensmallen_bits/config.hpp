@@ -46,7 +46,14 @@
 #if defined(ENS_USE_OPENMP)
   #define ENS_PRAGMA_OMP_PARALLEL _Pragma("omp parallel")
   #define ENS_PRAGMA_OMP_ATOMIC   _Pragma("omp atomic")
+  #define ENS_PRAGMA_OMP_PARALLEL_FOR \
+      _Pragma("omp parallel for schedule(static)")
+  #define ENS_PRAGMA_OMP_FOR_DYNAMIC _Pragma("omp for schedule(dynamic)")
+  #define ENS_PRAGMA_OMP_CRITICAL _Pragma("omp critical")
 #else
   #define ENS_PRAGMA_OMP_PARALLEL
   #define ENS_PRAGMA_OMP_ATOMIC
+  #define ENS_PRAGMA_OMP_PARALLEL_FOR
+  #define ENS_PRAGMA_OMP_FOR_DYNAMIC
+  #define ENS_PRAGMA_OMP_CRITICAL
 #endif
@@ -25,13 +25,20 @@ namespace traits {
  *
  * This is required by the FunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckEvaluate
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasEvaluate<FunctionType, EvaluateForm>::value ||
-      HasEvaluate<FunctionType, EvaluateConstForm>::value ||
-      HasEvaluate<FunctionType, EvaluateStaticForm>::value;
+      HasEvaluate<FunctionType,
+          Forms::template EvaluateForm>::value ||
+      HasEvaluate<FunctionType,
+          Forms::template EvaluateConstForm>::value ||
+      HasEvaluate<FunctionType,
+          Forms::template EvaluateStaticForm>::value;
 };
 
 /**
@@ -39,13 +46,20 @@ struct CheckEvaluate
  *
  * This is required by the FunctionType API.
  */
-template <typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckGradient
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasGradient<FunctionType, GradientForm>::value ||
-      HasGradient<FunctionType, GradientConstForm>::value ||
-      HasGradient<FunctionType, GradientStaticForm>::value;
+      HasGradient<FunctionType,
+          Forms::template GradientForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template GradientConstForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template GradientStaticForm>::value;
 };
 
 /**
@@ -81,13 +95,20 @@ struct CheckShuffle
  *
  * This is required by the DecomposableFunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckDecomposableEvaluate
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasEvaluate<FunctionType, DecomposableEvaluateForm>::value ||
-      HasEvaluate<FunctionType, DecomposableEvaluateConstForm>::value ||
-      HasEvaluate<FunctionType, DecomposableEvaluateStaticForm>::value;
+      HasEvaluate<FunctionType,
+          Forms::template DecomposableEvaluateForm>::value ||
+      HasEvaluate<FunctionType,
+          Forms::template DecomposableEvaluateConstForm>::value ||
+      HasEvaluate<FunctionType,
+          Forms::template DecomposableEvaluateStaticForm>::value;
 };
 
 /**
@@ -95,13 +116,20 @@ struct CheckDecomposableEvaluate
  *
  * This is required by the DecomposableFunctionType API.
  */
-template <typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckDecomposableGradient
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasGradient<FunctionType, DecomposableGradientForm>::value ||
-      HasGradient<FunctionType, DecomposableGradientConstForm>::value ||
-      HasGradient<FunctionType, DecomposableGradientStaticForm>::value;
+      HasGradient<FunctionType,
+          Forms::template DecomposableGradientForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template DecomposableGradientConstForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template DecomposableGradientStaticForm>::value;
 };
 
 /**
@@ -152,13 +180,20 @@ struct CheckGradientConstraint
  *
  * This is required by the SparseFunctionType API.
  */
-template <typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckSparseGradient
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasGradient<FunctionType, SparseGradientForm>::value ||
-      HasGradient<FunctionType, SparseGradientConstForm>::value ||
-      HasGradient<FunctionType, SparseGradientStaticForm>::value;
+      HasGradient<FunctionType,
+          Forms::template SparseGradientForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template SparseGradientConstForm>::value ||
+      HasGradient<FunctionType,
+          Forms::template SparseGradientStaticForm>::value;
 };
 
 /**
@@ -194,15 +229,20 @@ struct CheckPartialGradient
  *
  * This is required by the FunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckEvaluateWithGradient
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
-      HasEvaluateWithGradient<FunctionType, EvaluateWithGradientForm>::value ||
       HasEvaluateWithGradient<FunctionType,
-          EvaluateWithGradientConstForm>::value ||
+          Forms::template EvaluateWithGradientForm>::value ||
       HasEvaluateWithGradient<FunctionType,
-          EvaluateWithGradientStaticForm>::value;
+          Forms::template EvaluateWithGradientConstForm>::value ||
+      HasEvaluateWithGradient<FunctionType,
+          Forms::template EvaluateWithGradientStaticForm>::value;
 };
 
 /**
@@ -211,35 +251,42 @@ struct CheckEvaluateWithGradient
  *
  * This is required by the FunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 struct CheckDecomposableEvaluateWithGradient
 {
+  typedef TypedForms<MatType, GradType> Forms;
+
   const static bool value =
       HasEvaluateWithGradient<FunctionType,
-          DecomposableEvaluateWithGradientForm>::value ||
+          Forms::template DecomposableEvaluateWithGradientForm>::value ||
       HasEvaluateWithGradient<FunctionType,
-          DecomposableEvaluateWithGradientConstForm>::value ||
+          Forms::template DecomposableEvaluateWithGradientConstForm>::value ||
       HasEvaluateWithGradient<FunctionType,
-          DecomposableEvaluateWithGradientStaticForm>::value;
+          Forms::template DecomposableEvaluateWithGradientStaticForm>::value;
 };
 
 /**
  * Perform checks for the regular FunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 inline void CheckFunctionTypeAPI()
 {
-  static_assert(CheckEvaluate<FunctionType>::value,
+  static_assert(CheckEvaluate<FunctionType, MatType, GradType>::value,
       "The FunctionType does not have a correct definition of Evaluate(). "
       "Please check that the FunctionType fully satisfies the requirements of "
       "the FunctionType API; see the optimizer tutorial for details.");
 
-  static_assert(CheckGradient<FunctionType>::value,
+  static_assert(CheckGradient<FunctionType, MatType, GradType>::value,
       "The FunctionType does not have a correct definition of Gradient(). "
       "Please check that the FunctionType fully satisfies the requirements of "
       "the FunctionType API; see the optimizer tutorial for details.");
 
-  static_assert(CheckEvaluateWithGradient<FunctionType>::value,
+  static_assert(CheckEvaluateWithGradient<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of "
       "EvaluateWithGradient().  Please check that the FunctionType fully "
       "satisfies the requirements of the FunctionType API; see the optimizer "
@@ -249,22 +296,27 @@ inline void CheckFunctionTypeAPI()
 /**
  * Perform checks for the DecomposableFunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 inline void CheckDecomposableFunctionTypeAPI()
 {
-  static_assert(CheckDecomposableEvaluate<FunctionType>::value,
+  static_assert(CheckDecomposableEvaluate<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of a decomposable "
       "Evaluate() method.  Please check that the FunctionType fully satisfies"
       " the requirements of the DecomposableFunctionType API; see the optimizer"
       " tutorial for more details.");
 
-  static_assert(CheckDecomposableGradient<FunctionType>::value,
+  static_assert(CheckDecomposableGradient<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of a decomposable "
       "Gradient() method.  Please check that the FunctionType fully satisfies"
       " the requirements of the DecomposableFunctionType API; see the optimizer"
       " tutorial for more details.");
 
-  static_assert(CheckDecomposableEvaluateWithGradient<FunctionType>::value,
+  static_assert(CheckDecomposableEvaluateWithGradient<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of a decomposable "
       "EvaluateWithGradient() method.  Please check that the FunctionType "
       "fully satisfies the requirements of the DecomposableFunctionType API; "
@@ -286,7 +338,9 @@ inline void CheckDecomposableFunctionTypeAPI()
 /**
  * Perform checks for the SparseFunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 inline void CheckSparseFunctionTypeAPI()
 {
   static_assert(CheckNumFunctions<FunctionType>::value,
@@ -295,13 +349,14 @@ inline void CheckSparseFunctionTypeAPI()
       "the SparseFunctionType API; see the optimizer tutorial for more "
       "details.");
 
-  static_assert(CheckDecomposableEvaluate<FunctionType>::value,
+  static_assert(CheckDecomposableEvaluate<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of Evaluate(). "
       "Please check that the FunctionType fully satisfies the requirements of "
       "the SparseFunctionType API; see the optimizer tutorial for more "
       "details.");
 
-  static_assert(CheckSparseGradient<FunctionType>::value,
+  static_assert(CheckSparseGradient<FunctionType, MatType, GradType>::value,
       "The FunctionType does not have a correct definition of a sparse "
       "Gradient() method. Please check that the FunctionType fully satisfies "
       "the requirements of the SparseFunctionType API; see the optimizer "
@@ -311,10 +366,12 @@ inline void CheckSparseFunctionTypeAPI()
 /**
  * Perform checks for the NonDifferentiableFunctionType API.
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 inline void CheckNonDifferentiableFunctionTypeAPI()
 {
-  static_assert(CheckEvaluate<FunctionType>::value,
+  static_assert(CheckEvaluate<FunctionType, MatType, GradType>::value,
       "The FunctionType does not have a correct definition of Evaluate(). "
       "Please check that the FunctionType fully satisfies the requirements of "
       "the NonDifferentiableFunctionType API; see the optimizer tutorial for "
@@ -387,10 +444,13 @@ inline void CheckConstrainedFunctionTypeAPI()
  * Perform checks for the NonDifferentiableDecomposableFunctionType API.  (I
  * know, it is a long name...)
  */
-template<typename FunctionType>
+template<typename FunctionType,
+         typename MatType = arma::mat,
+         typename GradType = MatType>
 inline void CheckNonDifferentiableDecomposableFunctionTypeAPI()
 {
-  static_assert(CheckDecomposableEvaluate<FunctionType>::value,
+  static_assert(CheckDecomposableEvaluate<FunctionType, MatType,
+      GradType>::value,
       "The FunctionType does not have a correct definition of Evaluate(). "
       "Please check that the FunctionType fully satisfies the requirements of "
       "the NonDifferentiableDecomposableFunctionType API; see the optimizer "
@@ -39,46 +39,174 @@ ENS_HAS_EXACT_METHOD_FORM(NumFeatures, HasNumFeatures)
 //! Detect a PartialGradient() method.
 ENS_HAS_EXACT_METHOD_FORM(PartialGradient, HasPartialGradient)
 
+/**
+ * TypedForms holds the method forms of the FunctionType API that depend on the
+ * type of the coordinates (MatType) and the type of the gradient (GradType).
+ * Objective values are returned as MatType::elem_type, so for an arma::fmat
+ * iterate the forms expect, e.g., float Evaluate(const arma::fmat&).  These can
+ * be used with the method checkers like
+ *
+ *   HasEvaluate<FunctionType, TypedForms<MatType>::template EvaluateForm>
+ *
+ * The non-templated forms below (EvaluateForm, GradientForm, ...) are the
+ * arma::mat instantiations of these forms.
+ *
+ * @tparam MatType Type of the coordinates.
+ * @tparam GradType Type of the gradient.
+ */
+template<typename MatType, typename GradType = MatType>
+struct TypedForms
+{
+  //! The type of the objective value.
+  typedef typename MatType::elem_type ElemType;
+
+  //! This is the form of a non-const Evaluate() method.
+  template<typename FunctionType>
+  using EvaluateForm = ElemType(FunctionType::*)(const MatType&);
+
+  //! This is the form of a const Evaluate() method.
+  template<typename FunctionType>
+  using EvaluateConstForm = ElemType(FunctionType::*)(const MatType&) const;
+
+  //! This is the form of a static Evaluate() method.
+  template<typename FunctionType>
+  using EvaluateStaticForm = ElemType(*)(const MatType&);
+
+  //! This is the form of a non-const Gradient() method.
+  template<typename FunctionType>
+  using GradientForm = void(FunctionType::*)(const MatType&, GradType&);
+
+  //! This is the form of a const Gradient() method.
+  template<typename FunctionType>
+  using GradientConstForm =
+      void(FunctionType::*)(const MatType&, GradType&) const;
+
+  //! This is the form of a static Gradient() method.
+  template<typename FunctionType>
+  using GradientStaticForm = void(*)(const MatType&, GradType&);
+
+  //! This is the form of a non-const EvaluateWithGradient() method.
+  template<typename FunctionType>
+  using EvaluateWithGradientForm =
+      ElemType(FunctionType::*)(const MatType&, GradType&);
+
+  //! This is the form of a const EvaluateWithGradient() method.
+  template<typename FunctionType>
+  using EvaluateWithGradientConstForm =
+      ElemType(FunctionType::*)(const MatType&, GradType&) const;
+
+  //! This is the form of a static EvaluateWithGradient() method.
+  template<typename FunctionType>
+  using EvaluateWithGradientStaticForm =
+      ElemType(*)(const MatType&, GradType&);
+
+  //! This is the form of a decomposable Evaluate() method.
+  template<typename FunctionType>
+  using DecomposableEvaluateForm = ElemType(FunctionType::*)(
+      const MatType&, const size_t, const size_t);
+
+  //! This is the form of a decomposable const Evaluate() method.
+  template<typename FunctionType>
+  using DecomposableEvaluateConstForm = ElemType(FunctionType::*)(
+      const MatType&, const size_t, const size_t) const;
+
+  //! This is the form of a decomposable static Evaluate() method.
+  template<typename FunctionType>
+  using DecomposableEvaluateStaticForm = ElemType(*)(
+      const MatType&, const size_t, const size_t);
+
+  //! This is the form of a decomposable non-const Gradient() method.
+  template<typename FunctionType>
+  using DecomposableGradientForm = void(FunctionType::*)(
+      const MatType&, const size_t, GradType&, const size_t);
+
+  //! This the form of a decomposable const Gradient() method.
+  template<typename FunctionType>
+  using DecomposableGradientConstForm = void(FunctionType::*)(
+      const MatType&, const size_t, GradType&, const size_t) const;
+
+  //! This is the form of a decomposable static Gradient() method.
+  template<typename FunctionType>
+  using DecomposableGradientStaticForm = void(*)(
+      const MatType&, const size_t, GradType&, const size_t);
+
+  //! This is the form of a decomposable non-const EvaluateWithGradient()
+  //! method.
+  template<typename FunctionType>
+  using DecomposableEvaluateWithGradientForm = ElemType(FunctionType::*)(
+      const MatType&, const size_t, GradType&, const size_t);
+
+  //! This is the form of a decomposable const EvaluateWithGradient() method.
+  template<typename FunctionType>
+  using DecomposableEvaluateWithGradientConstForm = ElemType(FunctionType::*)(
+      const MatType&, const size_t, GradType&, const size_t) const;
+
+  //! This is the form of a decomposable static EvaluateWithGradient() method.
+  template<typename FunctionType>
+  using DecomposableEvaluateWithGradientStaticForm = ElemType(*)(
+      const MatType&, const size_t, GradType&, const size_t);
+
+  //! This is the form of a non-const sparse Gradient() method.
+  template<typename FunctionType>
+  using SparseGradientForm = void(FunctionType::*)(
+      const MatType&, const size_t, arma::SpMat<ElemType>&, const size_t);
+
+  //! This is the form of a const sparse Gradient() method.
+  template<typename FunctionType>
+  using SparseGradientConstForm = void(FunctionType::*)(
+      const MatType&, const size_t, arma::SpMat<ElemType>&, const size_t)
+      const;
+
+  //! This is the form of a static sparse Gradient() method.
+  template<typename FunctionType>
+  using SparseGradientStaticForm = void(*)(
+      const MatType&, const size_t, arma::SpMat<ElemType>&, const size_t);
+};
+
 //! This is the form of a non-const Evaluate() method.
 template<typename FunctionType>
-using EvaluateForm = double(FunctionType::*)(const arma::mat&);
+using EvaluateForm =
+    TypedForms<arma::mat>::EvaluateForm<FunctionType>;
 
 //! This is the form of a const Evaluate() method.
 template<typename FunctionType>
 using EvaluateConstForm =
-    double(FunctionType::*)(const arma::mat&) const;
+    TypedForms<arma::mat>::EvaluateConstForm<FunctionType>;
 
 //! This is the form of a static Evaluate() method.
 template<typename FunctionType>
-using EvaluateStaticForm = double(*)(const arma::mat&);
+using EvaluateStaticForm =
+    TypedForms<arma::mat>::EvaluateStaticForm<FunctionType>;
 
 //! This is the form of a non-const Gradient() method.
 template<typename FunctionType>
-using GradientForm = void(FunctionType::*)(const arma::mat&, arma::mat&);
+using GradientForm =
+    TypedForms<arma::mat>::GradientForm<FunctionType>;
 
 //! This is the form of a const Gradient() method.
 template<typename FunctionType>
 using GradientConstForm =
-    void(FunctionType::*)(const arma::mat&, arma::mat&) const;
+    TypedForms<arma::mat>::GradientConstForm<FunctionType>;
 
 //! This is the form of a static Gradient() method.
 template<typename FunctionType>
-using GradientStaticForm = void(*)(const arma::mat&, arma::mat&);
+using GradientStaticForm =
+    TypedForms<arma::mat>::GradientStaticForm<FunctionType>;
 
 //! This is the form of a non-const EvaluateWithGradient() method.
 template<typename FunctionType>
 using EvaluateWithGradientForm =
-    double(FunctionType::*)(const arma::mat&, arma::mat&);
+    TypedForms<arma::mat>::EvaluateWithGradientForm<FunctionType>;
 
 //! This is the form of a const EvaluateWithGradient() method.
 template<typename FunctionType>
 using EvaluateWithGradientConstForm =
-    double(FunctionType::*)(const arma::mat&, arma::mat&) const;
+    TypedForms<arma::mat>::EvaluateWithGradientConstForm<FunctionType>;
 
 //! This is the form of a static EvaluateWithGradient() method.
 template<typename FunctionType>
 using EvaluateWithGradientStaticForm =
-    double(*)(const arma::mat&, arma::mat&);
+    TypedForms<arma::mat>::EvaluateWithGradientStaticForm<FunctionType>;
 
 //! This is the form of a non-const NumFunctions() method.
 template <typename FunctionType>
@@ -106,48 +234,48 @@ using ShuffleStaticForm = void(*)();
 
 //! This is the form of a decomposable Evaluate() method.
 template<typename FunctionType>
-using DecomposableEvaluateForm = double(FunctionType::*)(
-    const arma::mat&, const size_t, const size_t);
+using DecomposableEvaluateForm =
+    TypedForms<arma::mat>::DecomposableEvaluateForm<FunctionType>;
 
 //! This is the form of a decomposable const Evaluate() method.
 template<typename FunctionType>
-using DecomposableEvaluateConstForm = double(FunctionType::*)(
-    const arma::mat&, const size_t, const size_t) const;
+using DecomposableEvaluateConstForm =
+    TypedForms<arma::mat>::DecomposableEvaluateConstForm<FunctionType>;
 
 //! This is the form of a decomposable static Evaluate() method.
 template<typename FunctionType>
-using DecomposableEvaluateStaticForm = double(*)(
-    const arma::mat&, const size_t, const size_t);
+using DecomposableEvaluateStaticForm =
+    TypedForms<arma::mat>::DecomposableEvaluateStaticForm<FunctionType>;
 
 //! This is the form of a decomposable non-const Gradient() method.
 template<typename FunctionType>
-using DecomposableGradientForm = void(FunctionType::*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t);
+using DecomposableGradientForm =
+    TypedForms<arma::mat>::DecomposableGradientForm<FunctionType>;
 
 //! This the form of a decomposable const Gradient() method.
 template<typename FunctionType>
-using DecomposableGradientConstForm = void(FunctionType::*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t) const;
+using DecomposableGradientConstForm =
+    TypedForms<arma::mat>::DecomposableGradientConstForm<FunctionType>;
 
 //! This is the form of a decomposable static Gradient() method.
 template<typename FunctionType>
-using DecomposableGradientStaticForm = void(*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t);
+using DecomposableGradientStaticForm =
+    TypedForms<arma::mat>::DecomposableGradientStaticForm<FunctionType>;
 
 //! This is the form of a decomposable non-const EvaluateWithGradient() method.
 template<typename FunctionType>
-using DecomposableEvaluateWithGradientForm = double(FunctionType::*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t);
+using DecomposableEvaluateWithGradientForm =
+    TypedForms<arma::mat>::DecomposableEvaluateWithGradientForm<FunctionType>;
 
 //! This is the form of a decomposable const EvaluateWithGradient() method.
 template<typename FunctionType>
-using DecomposableEvaluateWithGradientConstForm = double(FunctionType::*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t) const;
+using DecomposableEvaluateWithGradientConstForm = TypedForms<arma::mat>::
+    DecomposableEvaluateWithGradientConstForm<FunctionType>;
 
 //! This is the form of a decomposable static EvaluateWithGradient() method.
 template<typename FunctionType>
-using DecomposableEvaluateWithGradientStaticForm = double(*)(
-    const arma::mat&, const size_t, arma::mat&, const size_t);
+using DecomposableEvaluateWithGradientStaticForm = TypedForms<arma::mat>::
+    DecomposableEvaluateWithGradientStaticForm<FunctionType>;
 
 //! This is the form of a non-const NumConstraints() method.
 template<typename FunctionType>
@@ -192,18 +320,18 @@ using GradientConstraintStaticForm = void(*)(
 
 //! This is the form of a non-const sparse Gradient() method.
 template<typename FunctionType>
-using SparseGradientForm = void(FunctionType::*)(
-    const arma::mat&, const size_t, arma::sp_mat&, const size_t);
+using SparseGradientForm =
+    TypedForms<arma::mat>::SparseGradientForm<FunctionType>;
 
 //! This is the form of a const sparse Gradient() method.
 template<typename FunctionType>
-using SparseGradientConstForm = void(FunctionType::*)(
-    const arma::mat&, const size_t, arma::sp_mat&, const size_t) const;
+using SparseGradientConstForm =
+    TypedForms<arma::mat>::SparseGradientConstForm<FunctionType>;
 
 //! This is the form of a static sparse Gradient() method.
 template<typename FunctionType>
-using SparseGradientStaticForm = void(*)(
-    const arma::mat&, const size_t, arma::sp_mat&, const size_t);
+using SparseGradientStaticForm =
+    TypedForms<arma::mat>::SparseGradientStaticForm<FunctionType>;
 
 //! This is the form of a non-const NumFeatures() method.
 template<typename FunctionType>
@@ -58,6 +58,12 @@ namespace ens {
  * dataset, and Evaluate(coordinates, 0) will evaluate the objective function on
  * the first point in the dataset (presumably, the dataset is held internally in
  * the DecomposableFunctionType).
+ *
+ * Each step changes the aggregate Hessian approximation by a rank-two term, so
+ * its inverse is maintained with Sherman-Morrison updates instead of being
+ * recomputed, and a step takes O(n^2) time for n coordinates instead of
+ * O(n^3).  To keep rounding errors from accumulating, the inverse is
+ * recomputed once per pass over the batches.
  */
 class IQN
 {
@@ -114,7 +120,30 @@ class IQN
   //! Modify the tolerance for termination.
   double& Tolerance() { return tolerance; }
 
+  //! Get the aggregate Hessian approximation of the last optimization.
+  const arma::mat& Hessian() const { return hessian; }
+
+  //! Get the inverse of the aggregate Hessian approximation of the last
+  //! optimization, as maintained by the updates.
+  const arma::mat& HessianInverse() const { return hessianInverse; }
+
  private:
+  /**
+   * Update the given inverse of a symmetric matrix A to the inverse of
+   * A + c v v^T with the Sherman-Morrison formula, in O(n^2) time.  If the
+   * updated matrix is (numerically) singular, the inverse is not modified and
+   * false is returned.
+   *
+   * @param inverse Inverse to update.
+   * @param v Vector of the rank-one term.
+   * @param c Scale of the rank-one term.
+   * @param workspace Workspace vector.
+   */
+  static bool UpdateInverse(arma::mat& inverse,
+                            const arma::vec& v,
+                            const double c,
+                            arma::vec& workspace);
+
   //! The step size for each example.
   double stepSize;
 
@@ -126,6 +155,12 @@ class IQN
 
   //! The tolerance for termination.
   double tolerance;
+
+  //! The aggregate Hessian approximation.
+  arma::mat hessian;
+
+  //! The inverse of the aggregate Hessian approximation.
+  arma::mat hessianInverse;
 };
 
 } // namespace ens
@@ -50,7 +50,14 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   arma::cube t(iterate.n_elem, 1, numBatches);
   arma::cube Q(iterate.n_elem, iterate.n_elem, numBatches);
   arma::mat initialIterate = arma::randn(iterate.n_rows, iterate.n_cols);
-  arma::mat B = arma::eye(iterate.n_elem, iterate.n_elem);
+  arma::mat& B = hessian;
+  B.eye(iterate.n_elem, iterate.n_elem);
+
+  // The inverse of the aggregate Hessian approximation, which is kept up to
+  // date with the rank-two changes of B, so that it only has to be computed
+  // from scratch once per pass.
+  arma::mat& BInv = hessianInverse;
+  BInv.eye(iterate.n_elem, iterate.n_elem);
 
   arma::mat g = arma::zeros(iterate.n_rows, iterate.n_cols);
   for (size_t i = 0, f = 0; i < numFunctions; f++)
@@ -78,8 +85,20 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
       1, false, false);
   arma::mat gVec = arma::mat(g.memptr(), iterate.n_elem, 1, false, false);
 
+  // Workspaces for the updates.
+  arma::vec s, yy, Qs, workspace;
+
+  // Whether an unstable update has been reported already.
+  bool warned = false;
+
   for (size_t i = 1; i != maxIterations; ++i)
   {
+    // The Sherman-Morrison updates accumulate rounding errors, so recompute
+    // the inverse once per pass; this costs O(n^3) per pass, and not per
+    // step.
+    if (i > 1)
+      BInv = arma::inv(B);
+
     for (size_t j = 0, f = 0; f < numFunctions; j++)
     {
       // Cyclicly iterating through the number of functions.
@@ -95,29 +114,47 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
             effectiveBatchSize);
         gradient /= effectiveBatchSize;
 
-        const arma::mat s = iterateVec - t.slice(it);
-        const arma::mat yy = arma::vectorise(gradient - y.slice(it));
-
-        const arma::mat stochasticHessian = Q.slice(it) + yy * yy.t() /
-            arma::as_scalar(yy.t() * s) - Q.slice(it) * s * s.t() *
-            Q.slice(it) / arma::as_scalar(s.t() * Q.slice(it) * s);
-
-        // Update aggregate Hessian approximation.
-        B += (1.0 / numBatches) * (stochasticHessian - Q.slice(it));
-
-        // Update aggregate Hessian-variable product.
-        u += (1.0 / numBatches) * (stochasticHessian * iterateVec -
-            Q.slice(it) * t.slice(it));
+        s = iterateVec - t.slice(it);
+        yy = arma::vectorise(gradient - y.slice(it));
+        Qs = Q.slice(it) * s;
+
+        // The new stochastic Hessian approximation of the batch is the BFGS
+        // update Q + yy yy^T / (yy^T s) - Q s s^T Q / (s^T Q s), so it and the
+        // aggregate Hessian approximation change by a rank-two term, which is
+        // applied in O(n^2) time.
+        const double ys = arma::dot(yy, s);
+        const double sQs = arma::dot(s, Qs);
+
+        // Update aggregate Hessian-variable product; since s = x - t, the
+        // change Q' x - Q t is Q s plus the rank-two term applied to x.
+        u += (1.0 / numBatches) * (Qs + yy * (arma::dot(yy, iterateVec) / ys) -
+            Qs * (arma::dot(Qs, iterateVec) / sQs));
+
+        // Update aggregate Hessian approximation, and its inverse with the
+        // Sherman-Morrison formula, one rank-one term at a time.  B itself is
+        // only needed when the inverse is recomputed.
+        B += (1.0 / numBatches) * (yy * yy.t() / ys - Qs * Qs.t() / sQs);
+        if (!UpdateInverse(BInv, yy, 1.0 / (numBatches * ys), workspace) ||
+            !UpdateInverse(BInv, Qs, -1.0 / (numBatches * sQs), workspace))
+        {
+          if (!warned)
+          {
+            Warn << "IQN: inverse Hessian update is unstable; recomputing the "
+                << "inverse." << std::endl;
+            warned = true;
+          }
+          BInv = arma::inv(B);
+        }
 
         // Update aggregate gradient.
         g += (1.0 / numBatches) * (gradient - y.slice(it));
 
         // Update the function information tables.
-        Q.slice(it) = stochasticHessian;
+        Q.slice(it) += yy * yy.t() / ys - Qs * Qs.t() / sQs;
         y.slice(it) = gradient;
         t.slice(it) = iterateVec;
 
-        iterateVec = stepSize * B.i() * (u - gVec) + (1 - stepSize) *
+        iterateVec = stepSize * BInv * (u - gVec) + (1 - stepSize) *
             iterateVec;
       }
 
@@ -157,6 +194,22 @@ double IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
   return overallObjective;
 }
 
+inline bool IQN::UpdateInverse(arma::mat& inverse,
+                               const arma::vec& v,
+                               const double c,
+                               arma::vec& workspace)
+{
+  // (A + c v v^T)^-1 = A^-1 - c A^-1 v v^T A^-1 / (1 + c v^T A^-1 v), where
+  // A^-1 is symmetric.
+  workspace = inverse * v;
+  const double denominator = 1.0 + c * arma::dot(v, workspace);
+  if (!std::isfinite(denominator) || std::abs(denominator) < 1e-12)
+    return false;
+
+  inverse -= (c / denominator) * (workspace * workspace.t());
+  return true;
+}
+
 } // namespace ens
 
 #endif
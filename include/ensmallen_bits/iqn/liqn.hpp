@@ -0,0 +1,202 @@
+/**
+ * @file liqn.hpp
+ * @author agent
+ *
+ * Definition of a limited-memory variant of the incremental Quasi-Newton
+ * method IQN.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_IQN_LIQN_HPP
+#define ENSMALLEN_IQN_LIQN_HPP
+
+namespace ens {
+
+/**
+ * L_IQN is a limited-memory variant of IQN.  IQN keeps a dense BFGS
+ * approximation of the Hessian of every batch, which takes O(n^2) memory per
+ * batch for n coordinates.  L_IQN instead represents the approximation of each
+ * batch by its last few curvature pairs (s, y), as L-BFGS does, so that it
+ * takes O(n m) memory per batch for m pairs.
+ *
+ * The approximations are applied matrix-free, through the unrolled form of
+ * the BFGS update,
+ *
+ * \f[
+ * Q = I + \sum_k b_k b_k^T - a_k a_k^T,
+ * \f]
+ *
+ * with \f$ b_k = y_k / \sqrt{y_k^T s_k} \f$ and
+ * \f$ a_k = Q_k s_k / \sqrt{s_k^T Q_k s_k} \f$ (see Nocedal and Wright,
+ * Numerical Optimization, section 7.2).  The vectors of all batches are stored
+ * side by side, so that the aggregate approximation is applied with two
+ * matrix-vector products, and each step solves the linear system of IQN with
+ * the conjugate gradient method instead of an inverse.  Pairs with
+ * non-positive curvature are skipped, so that the approximations stay positive
+ * definite.
+ *
+ * For more information on IQN, please refer to:
+ *
+ * @code
+ * @misc{1106.5730,
+ *   author = {Mokhtari, Aryan and Eisen, Mark and Ribeiro, Alejandro},
+ *   title  = {IQN: An Incremental Quasi-Newton Method with Local Superlinear
+ *             Convergence Rate},
+ *   year   = {2017},
+ *   eprint = {arXiv:1702.00709},
+ * }
+ * @endcode
+ *
+ * The function requirements are the same as for IQN.
+ */
+class L_IQN
+{
+ public:
+  /**
+   * Construct the L_IQN optimizer with the given parameters.  The maximum
+   * number of iterations refers to the maximum number of passes over the
+   * batches.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Size of each batch.
+   * @param maxIterations Maximum number of iterations allowed (0 means no
+   *     limit).
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param numBasis Number of curvature pairs stored per batch.
+   * @param maxCGIterations Maximum number of conjugate gradient iterations per
+   *     step.
+   */
+  L_IQN(const double stepSize = 0.01,
+        const size_t batchSize = 10,
+        const size_t maxIterations = 100000,
+        const double tolerance = 1e-5,
+        const size_t numBasis = 5,
+        const size_t maxCGIterations = 50);
+
+  /**
+   * Optimize the given function using L_IQN.  The given starting point will be
+   * modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType>
+  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of curvature pairs stored per batch.
+  size_t NumBasis() const { return numBasis; }
+  //! Modify the number of curvature pairs stored per batch.
+  size_t& NumBasis() { return numBasis; }
+
+  //! Get the maximum number of conjugate gradient iterations per step.
+  size_t MaxCGIterations() const { return maxCGIterations; }
+  //! Modify the maximum number of conjugate gradient iterations per step.
+  size_t& MaxCGIterations() { return maxCGIterations; }
+
+ private:
+  /**
+   * Apply the approximation given by the unrolled vectors to the given vector.
+   *
+   * @param a The vectors a_k, one per column.
+   * @param b The vectors b_k, one per column.
+   * @param v Vector to apply the approximation to.
+   * @param result Vector to store the result in.
+   * @param scale Factor the sum of the unrolled terms is scaled with.
+   */
+  template<typename MatType>
+  static void Apply(const MatType& a,
+                    const MatType& b,
+                    const arma::vec& v,
+                    arma::vec& result,
+                    const double scale = 1.0);
+
+  /**
+   * Recompute the unrolled vectors of the given batch from its curvature
+   * pairs, starting at the given pair.
+   *
+   * @param batch Index of the batch.
+   * @param first First pair to recompute.
+   */
+  void Unroll(const size_t batch, const size_t first);
+
+  /**
+   * Solve B x = rhs for the aggregate approximation B with the conjugate
+   * gradient method, starting from the given x.
+   *
+   * @param rhs Right-hand side.
+   * @param x Starting point; will be modified to store the solution.
+   */
+  void Solve(const arma::vec& rhs, arma::vec& x);
+
+  //! The step size for each example.
+  double stepSize;
+
+  //! The size of each batch.
+  size_t batchSize;
+
+  //! The maximum number of allowed iterations.
+  size_t maxIterations;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! The number of curvature pairs stored per batch.
+  size_t numBasis;
+
+  //! The maximum number of conjugate gradient iterations per step.
+  size_t maxCGIterations;
+
+  //! The steps s of the curvature pairs; numBasis columns per batch.
+  arma::mat sPairs;
+
+  //! The gradient differences y of the curvature pairs.
+  arma::mat yPairs;
+
+  //! The unrolled vectors a_k; unused columns are zero.
+  arma::mat aVectors;
+
+  //! The unrolled vectors b_k; unused columns are zero.
+  arma::mat bVectors;
+
+  //! The number of stored pairs of each batch.
+  std::vector<size_t> numPairs;
+
+  //! The number of batches.
+  size_t numBatches;
+
+  //! Workspaces of the conjugate gradient method.
+  arma::vec residual, direction, product;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "liqn_impl.hpp"
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * @file liqn_impl.hpp
+ * @author agent
+ *
+ * Implementation of a limited-memory variant of the incremental Quasi-Newton
+ * method IQN.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_IQN_LIQN_IMPL_HPP
+#define ENSMALLEN_IQN_LIQN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "liqn.hpp"
+
+#include <ensmallen_bits/function.hpp>
+
+namespace ens {
+
+inline L_IQN::L_IQN(const double stepSize,
+                    const size_t batchSize,
+                    const size_t maxIterations,
+                    const double tolerance,
+                    const size_t numBasis,
+                    const size_t maxCGIterations) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    numBasis(numBasis),
+    maxCGIterations(maxCGIterations),
+    numBatches(0)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType>
+double L_IQN::Optimize(DecomposableFunctionType& function, arma::mat& iterate)
+{
+  traits::CheckDecomposableFunctionTypeAPI<DecomposableFunctionType>();
+
+  if (numBasis == 0)
+  {
+    throw std::invalid_argument("L_IQN::Optimize(): the number of curvature "
+        "pairs must be positive");
+  }
+
+  // Find the number of functions.
+  const size_t numFunctions = function.NumFunctions();
+  numBatches = numFunctions / batchSize;
+  if (numFunctions % batchSize != 0)
+    ++numBatches; // Capture last few.
+
+  // To keep track of where we are and how things are going.
+  double overallObjective = 0;
+
+  // Every approximation starts as the identity, with no curvature pairs.
+  const size_t n = iterate.n_elem;
+  sPairs.zeros(n, numBasis * numBatches);
+  yPairs.zeros(n, numBasis * numBatches);
+  aVectors.zeros(n, numBasis * numBatches);
+  bVectors.zeros(n, numBasis * numBatches);
+  numPairs.assign(numBatches, 0);
+
+  arma::cube y(iterate.n_rows, iterate.n_cols, numBatches);
+  arma::mat t(n, numBatches);
+  arma::mat initialIterate = arma::randn(iterate.n_rows, iterate.n_cols);
+
+  arma::mat g = arma::zeros(iterate.n_rows, iterate.n_cols);
+  for (size_t i = 0, f = 0; i < numFunctions; f++)
+  {
+    // Find the effective batch size (the last batch may be smaller).
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+
+    t.col(f) = arma::vectorise(initialIterate);
+    function.Gradient(initialIterate, i, y.slice(f), effectiveBatchSize);
+
+    g += y.slice(f);
+    y.slice(f) /= (double) effectiveBatchSize;
+
+    i += effectiveBatchSize;
+  }
+  g /= numFunctions;
+
+  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  arma::vec u = t.col(0);
+
+  // Convenience aliases to avoid multiple use of arma::vectorise.
+  arma::vec iterateVec(iterate.memptr(), n, false, true);
+  arma::vec gVec(g.memptr(), n, false, true);
+
+  // Workspaces for the updates.
+  arma::vec s, yy, oldProduct, newProduct;
+  arma::vec solution = iterateVec;
+
+  for (size_t i = 1; i != maxIterations; ++i)
+  {
+    for (size_t j = 0, f = 0; f < numFunctions; j++)
+    {
+      // Cyclicly iterating through the number of functions.
+      const size_t it = ((j + 1) % numBatches);
+
+      // Find the effective batch size (the last batch may be smaller).
+      const size_t effectiveBatchSize = std::min(batchSize, numFunctions -
+          it * batchSize);
+
+      const arma::vec tVec(t.colptr(it), n, false, true);
+      if (arma::norm(iterateVec - tVec) > 0)
+      {
+        function.Gradient(iterate, it * batchSize, gradient,
+            effectiveBatchSize);
+        gradient /= effectiveBatchSize;
+
+        s = iterateVec - tVec;
+        yy = arma::vectorise(gradient - y.slice(it));
+
+        // Remove the old contribution Q t of the batch from the aggregate
+        // Hessian-variable product.
+        const size_t offset = it * numBasis;
+        const size_t last = offset + numBasis - 1;
+        Apply(aVectors.cols(offset, last), bVectors.cols(offset, last), tVec,
+            oldProduct);
+        u -= (1.0 / numBatches) * oldProduct;
+
+        // Store the new curvature pair, dropping the oldest one if the memory
+        // is full; pairs with non-positive curvature are skipped.
+        if (arma::dot(yy, s) > std::numeric_limits<double>::epsilon() *
+            arma::dot(yy, yy))
+        {
+          if (numPairs[it] == numBasis)
+          {
+            if (numBasis > 1)
+            {
+              sPairs.cols(offset, last - 1) = sPairs.cols(offset + 1, last);
+              yPairs.cols(offset, last - 1) = yPairs.cols(offset + 1, last);
+            }
+
+            sPairs.col(last) = s;
+            yPairs.col(last) = yy;
+            Unroll(it, 0);
+          }
+          else
+          {
+            sPairs.col(offset + numPairs[it]) = s;
+            yPairs.col(offset + numPairs[it]) = yy;
+            ++numPairs[it];
+            Unroll(it, numPairs[it] - 1);
+          }
+        }
+
+        // Add the new contribution Q' x.
+        Apply(aVectors.cols(offset, last), bVectors.cols(offset, last),
+            iterateVec, newProduct);
+        u += (1.0 / numBatches) * newProduct;
+
+        // Update aggregate gradient.
+        g += (1.0 / numBatches) * (gradient - y.slice(it));
+
+        // Update the function information tables.
+        y.slice(it) = gradient;
+        t.col(it) = iterateVec;
+
+        // The solution of the previous step is a good starting point.
+        Solve(u - gVec, solution);
+        iterateVec = stepSize * solution + (1 - stepSize) * iterateVec;
+      }
+
+      f += effectiveBatchSize;
+    }
+
+    overallObjective = 0;
+    for (size_t f = 0; f < numFunctions; f += batchSize)
+    {
+      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
+      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+    }
+    overallObjective /= numFunctions;
+
+    // Output current objective function.
+    Info << "L_IQN: iteration " << i << ", objective " << overallObjective
+        << "." << std::endl;
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Warn << "L_IQN: converged to " << overallObjective << "; terminating"
+          << " with failure.  Try a smaller step size?" << std::endl;
+      return overallObjective;
+    }
+
+    if (overallObjective < tolerance)
+    {
+      Info << "L_IQN: minimized within tolerance " << tolerance << "; "
+          << "terminating optimization." << std::endl;
+      return overallObjective;
+    }
+  }
+
+  Info << "L_IQN: maximum iterations (" << maxIterations << ") reached; "
+      << "terminating optimization." << std::endl;
+
+  return overallObjective;
+}
+
+template<typename MatType>
+inline void L_IQN::Apply(const MatType& a,
+                         const MatType& b,
+                         const arma::vec& v,
+                         arma::vec& result,
+                         const double scale)
+{
+  result = v + scale * (b * (b.t() * v) - a * (a.t() * v));
+}
+
+inline void L_IQN::Unroll(const size_t batch, const size_t first)
+{
+  const size_t offset = batch * numBasis;
+  arma::vec Qs;
+  for (size_t k = first; k < numPairs[batch]; ++k)
+  {
+    const size_t col = offset + k;
+    const arma::vec s(sPairs.colptr(col), sPairs.n_rows, false, true);
+    const arma::vec y(yPairs.colptr(col), yPairs.n_rows, false, true);
+
+    // Apply the approximation made of the older pairs to s.
+    if (k == 0)
+    {
+      Qs = s;
+    }
+    else
+    {
+      Apply(aVectors.cols(offset, col - 1), bVectors.cols(offset, col - 1), s,
+          Qs);
+    }
+
+    aVectors.col(col) = Qs / std::sqrt(arma::dot(s, Qs));
+    bVectors.col(col) = y / std::sqrt(arma::dot(y, s));
+  }
+}
+
+inline void L_IQN::Solve(const arma::vec& rhs, arma::vec& x)
+{
+  // The aggregate approximation is the mean of the approximations of the
+  // batches, I + (b b^T - a a^T) / numBatches summed over all vectors; unused
+  // columns are zero and do not contribute.
+  const double scale = 1.0 / numBatches;
+
+  Apply(aVectors, bVectors, x, product, scale);
+  residual = rhs - product;
+  direction = residual;
+
+  // Iterate until the residual is small relative to the right-hand side.
+  double residualNorm = arma::dot(residual, residual);
+  const double threshold = 1e-20 * arma::dot(rhs, rhs);
+  for (size_t k = 0; k < maxCGIterations && residualNorm > threshold; ++k)
+  {
+    Apply(aVectors, bVectors, direction, product, scale);
+    const double alpha = residualNorm / arma::dot(direction, product);
+    x += alpha * direction;
+    residual -= alpha * product;
+
+    const double newResidualNorm = arma::dot(residual, residual);
+    direction = residual + (newResidualNorm / residualNorm) * direction;
+    residualNorm = newResidualNorm;
+  }
+}
+
+} // namespace ens
+
+#endif
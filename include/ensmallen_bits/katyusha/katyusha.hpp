@@ -79,6 +79,9 @@ class KatyushaType
    * @param tolerance Maximum absolute tolerance to terminate algorithm.
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *    function is visited in linear order.
+   * @param numThreads Number of parts the full gradient pass is split into
+   *    for thread-parallel evaluation (1 means no parallelism, 0 means one
+   *    part per OpenMP thread).  See NumThreads().
    */
   KatyushaType(const double convexity = 1.0,
                const double lipschitz = 10.0,
@@ -86,7 +89,8 @@ class KatyushaType
                const size_t maxIterations = 1000,
                const size_t innerIterations = 0,
                const double tolerance = 1e-5,
-               const bool shuffle = true);
+               const bool shuffle = true,
+               const size_t numThreads = 1);
 
   /**
    * Optimize the given function using Katyusha. The given starting point will
@@ -136,6 +140,18 @@ class KatyushaType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  /**
+   * Get the number of parts the full objective and gradient pass of each outer
+   * iteration is split into.  If it is not 1, the batches are evaluated in
+   * that many parallel ranges (or one per OpenMP thread if it is 0), so the
+   * EvaluateWithGradient() method of the function must be safe to call
+   * concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the full objective and gradient pass is split
+  //! into.
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! The convexity regularization term.
   double convexity;
@@ -158,6 +174,9 @@ class KatyushaType
   //! Controls whether or not the individual functions are shuffled when
   //! iterating.
   bool shuffle;
+
+  //! The number of parts the full gradient pass is split into.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
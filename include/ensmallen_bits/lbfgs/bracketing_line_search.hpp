@@ -0,0 +1,196 @@
+/**
+ * @file bracketing_line_search.hpp
+ * @author Dongryeol Lee
+ * @author Ryan Curtin
+ *
+ * The bracketing line search of L-BFGS.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LBFGS_BRACKETING_LINE_SEARCH_HPP
+#define ENSMALLEN_LBFGS_BRACKETING_LINE_SEARCH_HPP
+
+#include <ensmallen_bits/callbacks/callbacks.hpp>
+
+namespace ens {
+
+/**
+ * A bracketing line search for L-BFGS, which starts with a step size of 1,
+ * and multiplies it by a fixed factor (0.5 or 2.1) until the step size
+ * satisfies the Armijo and Wolfe conditions, or until the maximum number of
+ * trials is reached.  The best trial is accepted.
+ *
+ * The parameters of the search (Armijo constant, Wolfe parameter, number of
+ * trials, minimum and maximum step) are taken from the optimizer.
+ */
+class BracketingLineSearch
+{
+ public:
+  /**
+   * Perform the line search along the search direction.  The iterate, the
+   * function value and the gradient are set to the accepted point.
+   *
+   * @param optimizer The optimizer, which holds the parameters of the search.
+   * @param function Function to optimize.
+   * @param functionValue Value of the function at the initial point.
+   * @param iterate The initial point to begin the line search from.
+   * @param gradient The gradient at the initial point.
+   * @param newIterateTmp Workspace for the trial points.
+   * @param searchDirection A vector specifying the search direction.
+   * @param terminate Set to true if a callback requested termination.
+   * @param callbacks Callbacks to be invoked for each evaluation.
+   *
+   * @return false if no step size is suitable or no trial has a finite
+   *     function value, true otherwise.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename... CallbackTypes>
+  bool Search(OptimizerType& optimizer,
+              FunctionType& function,
+              double& functionValue,
+              arma::mat& iterate,
+              arma::mat& gradient,
+              arma::mat& newIterateTmp,
+              const arma::mat& searchDirection,
+              bool& terminate,
+              CallbackTypes&... callbacks)
+  {
+    // Default first step size of 1.0.
+    double stepSize = 1.0;
+
+    // The initial linear term approximation in the direction of the
+    // search direction.
+    double initialSearchDirectionDotGradient =
+        arma::dot(gradient, searchDirection);
+
+    // If it is not a descent direction, just report failure.
+    if (initialSearchDirectionDotGradient > 0.0)
+    {
+      Warn << "L-BFGS line search direction is not a descent direction "
+          << "(terminating)!" << std::endl;
+      return false;
+    }
+
+    // Save the initial function value.
+    double initialFunctionValue = functionValue;
+
+    // Unit linear approximation to the decrease in function value.
+    double linearApproxFunctionValueDecrease = optimizer.ArmijoConstant() *
+        initialSearchDirectionDotGradient;
+
+    // The number of iteration in the search.
+    size_t numIterations = 0;
+
+    // Armijo step size scaling factor for increase and decrease.
+    const double inc = 2.1;
+    const double dec = 0.5;
+    double width = 0;
+    double bestStepSize = 1.0;
+    double bestObjective = std::numeric_limits<double>::infinity();
+
+    // Whether the last trial is the best one; otherwise the gradient of the
+    // best trial is held in bestGradient.
+    bool lastIsBest = false;
+
+    while (true)
+    {
+      // Perform a step and evaluate the gradient and the function values at
+      // that point.
+      newIterateTmp = iterate;
+      newIterateTmp += stepSize * searchDirection;
+      functionValue = function.EvaluateWithGradient(newIterateTmp, gradient);
+
+      // A termination request only takes effect after the line search, so
+      // that the iterate is always left at a consistent point.
+      terminate |= Callback::Evaluate(optimizer, function, newIterateTmp,
+          functionValue, callbacks...);
+      terminate |= Callback::Gradient(optimizer, function, newIterateTmp,
+          gradient, callbacks...);
+
+      lastIsBest = (functionValue < bestObjective);
+      if (lastIsBest)
+      {
+        bestStepSize = stepSize;
+        bestObjective = functionValue;
+      }
+      numIterations++;
+
+      // A step that overflows (or leaves the domain of the function) is too
+      // large.
+      if (!std::isfinite(functionValue) ||
+          functionValue > initialFunctionValue + stepSize *
+          linearApproxFunctionValueDecrease)
+      {
+        width = dec;
+      }
+      else
+      {
+        // Check Wolfe's condition.
+        double searchDirectionDotGradient = arma::dot(gradient,
+            searchDirection);
+
+        if (searchDirectionDotGradient < optimizer.Wolfe() *
+            initialSearchDirectionDotGradient)
+        {
+          width = inc;
+        }
+        else
+        {
+          if (searchDirectionDotGradient > -optimizer.Wolfe() *
+              initialSearchDirectionDotGradient)
+          {
+            width = dec;
+          }
+          else
+          {
+            break;
+          }
+        }
+      }
+
+      // Terminate when the step size gets too small or too big or it
+      // exceeds the max number of iterations.
+      const bool cond1 = (stepSize < optimizer.MinStep());
+      const bool cond2 = (stepSize > optimizer.MaxStep());
+      const bool cond3 = (numIterations >= optimizer.MaxLineSearchTrials());
+      if (cond1 || cond2 || cond3)
+        break;
+
+      // Keep the gradient of the best trial, since the next trial overwrites
+      // it.
+      if (lastIsBest)
+        bestGradient = gradient;
+
+      // Scale the step size.
+      stepSize *= width;
+    }
+
+    // If no trial has a finite function value, keep the iterate, and leave the
+    // value of the last trial, so that the optimizer sees it.
+    if (!std::isfinite(bestObjective))
+      return false;
+
+    // Move to the new iterate, and restore the function value and gradient of
+    // the best trial if it was not the last one.
+    iterate += bestStepSize * searchDirection;
+    if (!lastIsBest)
+    {
+      functionValue = bestObjective;
+      gradient = bestGradient;
+    }
+
+    return true;
+  }
+
+ private:
+  //! The gradient of the best trial so far.
+  arma::mat bestGradient;
+};
+
+} // namespace ens
+
+#endif
@@ -14,23 +14,43 @@
 #define ENSMALLEN_LBFGS_LBFGS_HPP
 
 #include <ensmallen_bits/function.hpp>
+#include "bracketing_line_search.hpp"
+#include "lbfgs_history.hpp"
+#include "more_thuente_line_search.hpp"
 
 namespace ens {
 
 /**
- * The generic L-BFGS optimizer, which uses a back-tracking line search
- * algorithm to minimize a function.  The parameters for the algorithm (number
- * of memory points, maximum step size, and so forth) are all configurable via
- * either the constructor or standalone modifier functions.  A function which
- * can be optimized by this class's Optimize() method must implement the
- * following methods:
+ * The generic L-BFGS optimizer, which uses a line search algorithm to minimize
+ * a function.  The parameters for the algorithm (number of memory points,
+ * maximum step size, and so forth) are all configurable via either the
+ * constructor or standalone modifier functions.  A function which can be
+ * optimized by this class's Optimize() method must implement the following
+ * methods:
  *
  *  - a default constructor
  *  - double Evaluate(const arma::mat& coordinates);
  *  - void Gradient(const arma::mat& coordinates, arma::mat& gradient);
  *  - arma::mat& GetInitialPoint();
+ *
+ * The line search is a policy: BracketingLineSearch multiplies the step size
+ * by fixed factors, and MoreThuenteLineSearch interpolates the trials, which
+ * usually takes fewer evaluations.  A line search policy must implement the
+ * following method, which moves the iterate to the accepted point and sets
+ * the function value and gradient to those of the accepted point:
+ *
+ *  - template<typename OptimizerType, typename FunctionType,
+ *             typename... CallbackTypes>
+ *    bool Search(OptimizerType& optimizer, FunctionType& function,
+ *                double& functionValue, arma::mat& iterate,
+ *                arma::mat& gradient, arma::mat& newIterateTmp,
+ *                const arma::mat& searchDirection, bool& terminate,
+ *                CallbackTypes&... callbacks);
+ *
+ * @tparam LineSearchPolicyType Line search policy.
  */
-class L_BFGS
+template<typename LineSearchPolicyType = BracketingLineSearch>
+class L_BFGSType
 {
  public:
   /**
@@ -51,16 +71,19 @@ class L_BFGS
    *     (before giving up).
    * @param minStep The minimum step of the line search.
    * @param maxStep The maximum step of the line search.
+   * @param lineSearchPolicy Instantiated line search policy.
    */
-  L_BFGS(const size_t numBasis = 10, /* same default as scipy */
-         const size_t maxIterations = 10000, /* many but not infinite */
-         const double armijoConstant = 1e-4,
-         const double wolfe = 0.9,
-         const double minGradientNorm = 1e-6,
-         const double factr = 1e-15,
-         const size_t maxLineSearchTrials = 50,
-         const double minStep = 1e-20,
-         const double maxStep = 1e20);
+  L_BFGSType(const size_t numBasis = 10, /* same default as scipy */
+             const size_t maxIterations = 10000, /* many but not infinite */
+             const double armijoConstant = 1e-4,
+             const double wolfe = 0.9,
+             const double minGradientNorm = 1e-6,
+             const double factr = 1e-15,
+             const size_t maxLineSearchTrials = 50,
+             const double minStep = 1e-20,
+             const double maxStep = 1e20,
+             const LineSearchPolicyType& lineSearchPolicy =
+                 LineSearchPolicyType());
 
   /**
    * Return the point where the lowest function value has been found.
@@ -78,13 +101,22 @@ class L_BFGS
    * given starting point will be modified to store the finishing point of the
    * algorithm, and the final objective value is returned.
    *
+   * Any number of callbacks may be given after the iterate; see Callback for
+   * the events they can handle.  L-BFGS has no epochs; StepTaken() is fired
+   * after each iteration, and the evaluations of the line search fire
+   * Evaluate() and Gradient().
+   *
    * @tparam FunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize; must have Evaluate() and Gradient().
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename FunctionType>
-  double Optimize(FunctionType& function, arma::mat& iterate);
+  template<typename FunctionType, typename... CallbackTypes>
+  double Optimize(FunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the memory size.
   size_t NumBasis() const { return numBasis; }
@@ -131,6 +163,12 @@ class L_BFGS
   //! Modify the maximum line search step size.
   double& MaxStep() { return maxStep; }
 
+  //! Get the line search policy.
+  const LineSearchPolicyType& LineSearchPolicy() const
+  { return lineSearchPolicy; }
+  //! Modify the line search policy.
+  LineSearchPolicyType& LineSearchPolicy() { return lineSearchPolicy; }
+
  private:
   //! Size of memory for this L-BFGS optimizer.
   size_t numBasis;
@@ -150,82 +188,21 @@ class L_BFGS
   double minStep;
   //! Maximum step of the line search.
   double maxStep;
+  //! The line search policy.
+  LineSearchPolicyType lineSearchPolicy;
+};
 
-  /**
-   * Calculate the scaling factor, gamma, which is used to scale the Hessian
-   * approximation matrix.  See method M3 in Section 4 of Liu and Nocedal
-   * (1989).
-   *
-   * @return The calculated scaling factor.
-   * @param gradient The gradient at the initial point.
-   * @param s Differences between the iterate and old iterate matrix.
-   * @param y Differences between the gradient and the old gradient matrix.
-   */
-  double ChooseScalingFactor(const size_t iterationNum,
-                             const arma::mat& gradient,
-                             const arma::cube& s,
-                             const arma::cube& y);
+// Convenience typedefs.
 
-  /**
-   * Perform a back-tracking line search along the search direction to
-   * calculate a step size satisfying the Wolfe conditions.  The parameter
-   * iterate will be modified if the method is successful.
-   *
-   * @param function Function to optimize.
-   * @param functionValue Value of the function at the initial point.
-   * @param iterate The initial point to begin the line search from.
-   * @param gradient The gradient at the initial point.
-   * @param searchDirection A vector specifying the search direction.
-   * @param stepSize Variable the calculated step size will be stored in.
-   *
-   * @return false if no step size is suitable, true otherwise.
-   */
-  template<typename FunctionType>
-  bool LineSearch(FunctionType& function,
-                  double& functionValue,
-                  arma::mat& iterate,
-                  arma::mat& gradient,
-                  arma::mat& newIterateTmp,
-                  const arma::mat& searchDirection);
-
-  /**
-   * Find the L-BFGS search direction.
-   *
-   * @param gradient The gradient at the current point.
-   * @param iterationNum The iteration number.
-   * @param scalingFactor Scaling factor to use (see ChooseScalingFactor_()).
-   * @param s Differences between the iterate and old iterate matrix.
-   * @param y Differences between the gradient and the old gradient matrix.
-   * @param searchDirection Vector to store search direction in.
-   */
-  void SearchDirection(const arma::mat& gradient,
-                       const size_t iterationNum,
-                       const double scalingFactor,
-                       const arma::cube& s,
-                       const arma::cube& y,
-                       arma::mat& searchDirection);
+/**
+ * L-BFGS with the bracketing line search.
+ */
+using L_BFGS = L_BFGSType<BracketingLineSearch>;
 
-  /**
-   * Update the y and s matrices, which store the differences
-   * between the iterate and old iterate and the differences between the
-   * gradient and the old gradient, respectively.
-   *
-   * @param iterationNum Iteration number.
-   * @param iterate Current point.
-   * @param oldIterate Point at last iteration.
-   * @param gradient Gradient at current point (iterate).
-   * @param oldGradient Gradient at last iteration point (oldIterate).
-   * @param s Differences between the iterate and old iterate matrix.
-   * @param y Differences between the gradient and the old gradient matrix.
-   */
-  void UpdateBasisSet(const size_t iterationNum,
-                      const arma::mat& iterate,
-                      const arma::mat& oldIterate,
-                      const arma::mat& gradient,
-                      const arma::mat& oldGradient,
-                      arma::cube& s,
-                      arma::cube& y);
-};
+/**
+ * L-BFGS with the More-Thuente line search.
+ */
+using MoreThuenteL_BFGS = L_BFGSType<MoreThuenteLineSearch>;
 
 } // namespace ens
 
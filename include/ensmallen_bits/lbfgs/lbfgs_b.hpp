@@ -0,0 +1,228 @@
+/**
+ * @file lbfgs_b.hpp
+ * @author agent
+ *
+ * L-BFGS for box-constrained problems.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LBFGS_LBFGS_B_HPP
+#define ENSMALLEN_LBFGS_LBFGS_B_HPP
+
+#include <ensmallen_bits/function.hpp>
+#include "lbfgs_history.hpp"
+
+namespace ens {
+
+/**
+ * L-BFGS-B minimizes a function subject to bounds on each coordinate,
+ *
+ * \f[
+ * \min_x f(x) \quad \textrm{s.t.} \quad l \le x \le u,
+ * \f]
+ *
+ * in a single solve.  Every iteration computes a generalized Cauchy point on
+ * the projected steepest descent path; the coordinates at a bound there are
+ * held fixed, and the quadratic model with the L-BFGS Hessian approximation
+ * is minimized over the others, starting from the Cauchy point (the direct
+ * primal method of the reference below).  The minimizer is projected onto the
+ * box, and a back-tracking line search is run along the segment to it, which
+ * stays feasible.  If that is not a descent direction, the line search is run
+ * towards the Cauchy point instead.
+ *
+ * Unlike the reference, the Cauchy point is computed with the scaled identity
+ * the L-BFGS approximation starts from, for which it is the projection of the
+ * scaled steepest descent step, instead of the piecewise search with the full
+ * approximation; the subspace minimization uses the full approximation.  The
+ * line search only checks the Armijo condition.  Curvature pairs with
+ * non-positive curvature are skipped.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Byrd1995,
+ *   author  = {Byrd, Richard H. and Lu, Peihuang and Nocedal, Jorge and
+ *              Zhu, Ciyou},
+ *   title   = {A Limited Memory Algorithm for Bound Constrained
+ *              Optimization},
+ *   journal = {SIAM Journal on Scientific Computing},
+ *   volume  = {16},
+ *   number  = {5},
+ *   year    = {1995},
+ *   pages   = {1190--1208},
+ * }
+ * @endcode
+ *
+ * The function requirements are the same as for L_BFGS.  The bounds are
+ * either matrices of the size of the coordinates, or 1x1 matrices (or scalars)
+ * that apply to all coordinates; infinite bounds are allowed.
+ */
+class L_BFGS_B
+{
+ public:
+  /**
+   * Initialize the L-BFGS-B object with the given bounds.
+   *
+   * @param lowerBound Lower bound of the coordinates.
+   * @param upperBound Upper bound of the coordinates.
+   * @param numBasis Number of memory points to be stored.
+   * @param maxIterations Maximum number of iterations for the optimization
+   *     (0 means no limit and may run indefinitely).
+   * @param armijoConstant Controls the accuracy of the line search routine for
+   *     determining the Armijo condition.
+   * @param minGradientNorm Minimum norm of the projected gradient required to
+   *     continue the optimization.
+   * @param factr Minimum relative function value decrease to continue
+   *     the optimization.
+   * @param maxLineSearchTrials The maximum number of trials for the line search
+   *     (before giving up).
+   * @param minStep The minimum step of the line search.
+   */
+  L_BFGS_B(const arma::mat& lowerBound,
+           const arma::mat& upperBound,
+           const size_t numBasis = 10,
+           const size_t maxIterations = 10000,
+           const double armijoConstant = 1e-4,
+           const double minGradientNorm = 1e-6,
+           const double factr = 1e-15,
+           const size_t maxLineSearchTrials = 50,
+           const double minStep = 1e-20);
+
+  /**
+   * Initialize the L-BFGS-B object with the same bounds for all coordinates.
+   *
+   * @param lowerBound Lower bound of the coordinates.
+   * @param upperBound Upper bound of the coordinates.
+   * @param numBasis Number of memory points to be stored.
+   * @param maxIterations Maximum number of iterations for the optimization
+   *     (0 means no limit and may run indefinitely).
+   * @param armijoConstant Controls the accuracy of the line search routine for
+   *     determining the Armijo condition.
+   * @param minGradientNorm Minimum norm of the projected gradient required to
+   *     continue the optimization.
+   * @param factr Minimum relative function value decrease to continue
+   *     the optimization.
+   * @param maxLineSearchTrials The maximum number of trials for the line search
+   *     (before giving up).
+   * @param minStep The minimum step of the line search.
+   */
+  L_BFGS_B(const double lowerBound,
+           const double upperBound,
+           const size_t numBasis = 10,
+           const size_t maxIterations = 10000,
+           const double armijoConstant = 1e-4,
+           const double minGradientNorm = 1e-6,
+           const double factr = 1e-15,
+           const size_t maxLineSearchTrials = 50,
+           const double minStep = 1e-20);
+
+  /**
+   * Use L-BFGS-B to optimize the given function, starting at the given iterate
+   * point (which is first projected onto the bounds).  The given starting
+   * point will be modified to store the finishing point of the algorithm, and
+   * the final objective value is returned.
+   *
+   * Any number of callbacks may be given after the iterate, as for L_BFGS.
+   *
+   * @tparam FunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
+   * @param function Function to optimize; must have Evaluate() and Gradient().
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
+   * @return Objective value of the final point.
+   */
+  template<typename FunctionType, typename... CallbackTypes>
+  double Optimize(FunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
+
+  //! Get the memory size.
+  size_t NumBasis() const { return numBasis; }
+  //! Modify the memory size.
+  size_t& NumBasis() { return numBasis; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the Armijo condition constant.
+  double ArmijoConstant() const { return armijoConstant; }
+  //! Modify the Armijo condition constant.
+  double& ArmijoConstant() { return armijoConstant; }
+
+  //! Get the minimum projected gradient norm.
+  double MinGradientNorm() const { return minGradientNorm; }
+  //! Modify the minimum projected gradient norm.
+  double& MinGradientNorm() { return minGradientNorm; }
+
+  //! Get the factr value.
+  double Factr() const { return factr; }
+  //! Modify the factr value.
+  double& Factr() { return factr; }
+
+  //! Get the maximum number of line search trials.
+  size_t MaxLineSearchTrials() const { return maxLineSearchTrials; }
+  //! Modify the maximum number of line search trials.
+  size_t& MaxLineSearchTrials() { return maxLineSearchTrials; }
+
+  //! Return the minimum line search step size.
+  double MinStep() const { return minStep; }
+  //! Modify the minimum line search step size.
+  double& MinStep() { return minStep; }
+
+  //! Get the lower bound of the coordinates.
+  const arma::mat& LowerBound() const { return lowerBound; }
+  //! Modify the lower bound of the coordinates.
+  arma::mat& LowerBound() { return lowerBound; }
+
+  //! Get the upper bound of the coordinates.
+  const arma::mat& UpperBound() const { return upperBound; }
+  //! Modify the upper bound of the coordinates.
+  arma::mat& UpperBound() { return upperBound; }
+
+ private:
+  /**
+   * Expand the bounds to the size of the coordinates, and check them.
+   *
+   * @param rows Number of rows of the coordinates.
+   * @param cols Number of columns of the coordinates.
+   * @param lower Matrix to store the lower bounds in.
+   * @param upper Matrix to store the upper bounds in.
+   */
+  void Bounds(const size_t rows,
+              const size_t cols,
+              arma::mat& lower,
+              arma::mat& upper) const;
+
+  //! Size of memory for this L-BFGS-B optimizer.
+  size_t numBasis;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Parameter for determining the Armijo condition.
+  double armijoConstant;
+  //! Minimum projected gradient norm required to continue the optimization.
+  double minGradientNorm;
+  //! Minimum relative function value decrease to continue the optimization.
+  double factr;
+  //! Maximum number of trials for the line search.
+  size_t maxLineSearchTrials;
+  //! Minimum step of the line search.
+  double minStep;
+
+  //! The lower bound of the coordinates.
+  arma::mat lowerBound;
+
+  //! The upper bound of the coordinates.
+  arma::mat upperBound;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "lbfgs_b_impl.hpp"
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @file lbfgs_b_impl.hpp
+ * @author agent
+ *
+ * Implementation of L-BFGS for box-constrained problems.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LBFGS_LBFGS_B_IMPL_HPP
+#define ENSMALLEN_LBFGS_LBFGS_B_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "lbfgs_b.hpp"
+
+namespace ens {
+
+inline L_BFGS_B::L_BFGS_B(const arma::mat& lowerBound,
+                          const arma::mat& upperBound,
+                          const size_t numBasis,
+                          const size_t maxIterations,
+                          const double armijoConstant,
+                          const double minGradientNorm,
+                          const double factr,
+                          const size_t maxLineSearchTrials,
+                          const double minStep) :
+    numBasis(numBasis),
+    maxIterations(maxIterations),
+    armijoConstant(armijoConstant),
+    minGradientNorm(minGradientNorm),
+    factr(factr),
+    maxLineSearchTrials(maxLineSearchTrials),
+    minStep(minStep),
+    lowerBound(lowerBound),
+    upperBound(upperBound)
+{ /* Nothing to do. */ }
+
+inline L_BFGS_B::L_BFGS_B(const double lowerBound,
+                          const double upperBound,
+                          const size_t numBasis,
+                          const size_t maxIterations,
+                          const double armijoConstant,
+                          const double minGradientNorm,
+                          const double factr,
+                          const size_t maxLineSearchTrials,
+                          const double minStep) :
+    numBasis(numBasis),
+    maxIterations(maxIterations),
+    armijoConstant(armijoConstant),
+    minGradientNorm(minGradientNorm),
+    factr(factr),
+    maxLineSearchTrials(maxLineSearchTrials),
+    minStep(minStep),
+    lowerBound(1, 1),
+    upperBound(1, 1)
+{
+  this->lowerBound(0) = lowerBound;
+  this->upperBound(0) = upperBound;
+}
+
+inline void L_BFGS_B::Bounds(const size_t rows,
+                             const size_t cols,
+                             arma::mat& lower,
+                             arma::mat& upper) const
+{
+  if (lowerBound.n_elem == 1)
+  {
+    lower.set_size(rows, cols);
+    lower.fill(lowerBound(0));
+  }
+  else if (lowerBound.n_rows == rows && lowerBound.n_cols == cols)
+  {
+    lower = lowerBound;
+  }
+  else
+  {
+    throw std::invalid_argument("L_BFGS_B::Optimize(): the lower bound must "
+        "be a scalar or have the size of the coordinates");
+  }
+
+  if (upperBound.n_elem == 1)
+  {
+    upper.set_size(rows, cols);
+    upper.fill(upperBound(0));
+  }
+  else if (upperBound.n_rows == rows && upperBound.n_cols == cols)
+  {
+    upper = upperBound;
+  }
+  else
+  {
+    throw std::invalid_argument("L_BFGS_B::Optimize(): the upper bound must "
+        "be a scalar or have the size of the coordinates");
+  }
+
+  if (arma::any(arma::vectorise(lower > upper)))
+  {
+    throw std::invalid_argument("L_BFGS_B::Optimize(): the lower bound must "
+        "not be greater than the upper bound");
+  }
+}
+
+template<typename FunctionType, typename... CallbackTypes>
+double L_BFGS_B::Optimize(FunctionType& function,
+                          arma::mat& iterate,
+                          CallbackTypes&&... callbacks)
+{
+  // Use the Function<> wrapper to ensure the function has all of the functions
+  // that we need.
+  typedef Function<FunctionType> FullFunctionType;
+  FullFunctionType& f = static_cast<FullFunctionType&>(function);
+
+  // Check that we have all the functions we will need.
+  traits::CheckFunctionTypeAPI<FullFunctionType>();
+
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+
+  arma::mat lower, upper;
+  Bounds(rows, cols, lower, upper);
+
+  // Start from the projection of the starting point onto the box.
+  iterate = arma::min(arma::max(iterate, lower), upper);
+
+  // The curvature pairs of the past iterations.
+  LBFGSHistory history(numBasis, rows, cols);
+
+  arma::mat gradient(rows, cols);
+  arma::mat newGradient(rows, cols);
+  arma::mat oldIterate(rows, cols);
+  arma::mat oldGradient(rows, cols);
+  arma::mat cauchyPoint(rows, cols);
+  arma::vec subspaceStep;
+  arma::mat searchDirection(rows, cols);
+  arma::mat newIterate(rows, cols);
+
+  // Whether to optimize until convergence.
+  const bool optimizeUntilConvergence = (maxIterations == 0);
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+  terminate |= Callback::BeginOptimization(*this, f, iterate, callbacks...);
+
+  // The initial function value and gradient.
+  double functionValue = f.EvaluateWithGradient(iterate, gradient);
+  terminate |= Callback::Evaluate(*this, f, iterate, functionValue,
+      callbacks...);
+  terminate |= Callback::Gradient(*this, f, iterate, gradient, callbacks...);
+
+  for (size_t itNum = 0; (optimizeUntilConvergence ||
+       (itNum != maxIterations)) && !terminate; ++itNum)
+  {
+    const double prevFunctionValue = functionValue;
+
+    // Break when the projected gradient becomes too small; coordinates at a
+    // bound whose gradient points outwards do not count.
+    newIterate = arma::min(arma::max(iterate - gradient, lower), upper);
+    if (arma::abs(newIterate - iterate).max() < minGradientNorm)
+    {
+      Info << "L-BFGS-B projected gradient norm too small (terminating "
+          << "successfully)." << std::endl;
+      break;
+    }
+
+    // Break if the objective is not a number.
+    if (std::isnan(functionValue))
+    {
+      Warn << "L-BFGS-B terminated with objective " << functionValue << "; "
+          << "are the objective and gradient functions implemented correctly?"
+          << std::endl;
+      break;
+    }
+
+    const double scalingFactor = history.ScalingFactor(gradient);
+
+    // The generalized Cauchy point of the quadratic model with the Hessian
+    // approximation I / scalingFactor.
+    cauchyPoint = arma::min(arma::max(iterate - scalingFactor * gradient,
+        lower), upper);
+
+    // The coordinates at a bound at the Cauchy point stay there; the model is
+    // minimized over the others, starting from the Cauchy point, and the
+    // minimizer is projected onto the box.
+    const arma::uvec free = arma::find((cauchyPoint > lower) %
+        (cauchyPoint < upper));
+    newIterate = cauchyPoint;
+    if (free.n_elem > 0 && history.SubspaceStep(gradient,
+        cauchyPoint - iterate, free, scalingFactor, subspaceStep))
+    {
+      for (size_t j = 0; j < free.n_elem; ++j)
+      {
+        const size_t i = free[j];
+        newIterate[i] = std::min(std::max(cauchyPoint[i] + subspaceStep[j],
+            lower[i]), upper[i]);
+      }
+    }
+    searchDirection = newIterate - iterate;
+
+    // Fall back to the Cauchy point if the projected step does not descend.
+    double derivative = arma::dot(gradient, searchDirection);
+    if (derivative >= 0.0)
+    {
+      searchDirection = cauchyPoint - iterate;
+      derivative = arma::dot(gradient, searchDirection);
+    }
+
+    if (derivative >= 0.0)
+    {
+      Info << "L-BFGS-B found no descent direction (terminating "
+          << "successfully)." << std::endl;
+      break;
+    }
+
+    // Back-tracking line search along the segment to the projected point,
+    // which lies in the box.
+    oldIterate = iterate;
+    oldGradient = gradient;
+    double stepSize = 1.0;
+    bool accepted = false;
+    for (size_t trial = 0; trial < maxLineSearchTrials &&
+        stepSize >= minStep; ++trial)
+    {
+      newIterate = oldIterate + stepSize * searchDirection;
+      const double newFunctionValue = f.EvaluateWithGradient(newIterate,
+          newGradient);
+
+      // A termination request only takes effect after the line search, so that
+      // the iterate is always left at a consistent point.
+      terminate |= Callback::Evaluate(*this, f, newIterate, newFunctionValue,
+          callbacks...);
+      terminate |= Callback::Gradient(*this, f, newIterate, newGradient,
+          callbacks...);
+
+      if (newFunctionValue <= functionValue + armijoConstant * stepSize *
+          derivative)
+      {
+        iterate = newIterate;
+        gradient.swap(newGradient);
+        functionValue = newFunctionValue;
+        accepted = true;
+        break;
+      }
+
+      stepSize *= 0.5;
+    }
+
+    if (!accepted)
+    {
+      Warn << "Line search failed.  Stopping optimization." << std::endl;
+      break;
+    }
+
+    terminate |= Callback::StepTaken(*this, f, iterate, callbacks...);
+
+    // It is possible that the difference between the two coordinates is zero.
+    // In this case we terminate successfully.
+    if (accu(iterate != oldIterate) == 0)
+    {
+      Info << "L-BFGS-B step size of 0 (terminating successfully)."
+          << std::endl;
+      break;
+    }
+
+    // If we can't make progress on the gradient, then we'll also accept
+    // a stable function value.
+    const double denom = std::max(
+        std::max(fabs(prevFunctionValue), fabs(functionValue)), 1.0);
+    if ((prevFunctionValue - functionValue) / denom <= factr)
+    {
+      Info << "L-BFGS-B function value stable (terminating successfully)."
+          << std::endl;
+      break;
+    }
+
+    // Store the curvature pair if it keeps the approximation positive
+    // definite.
+    const double sy = arma::dot(iterate - oldIterate, gradient - oldGradient);
+    const double yy = arma::dot(gradient - oldGradient,
+        gradient - oldGradient);
+    if (sy > std::numeric_limits<double>::epsilon() * yy)
+      history.Update(iterate, oldIterate, gradient, oldGradient);
+  }
+
+  Callback::EndOptimization(*this, f, iterate, callbacks...);
+  return functionValue;
+}
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,299 @@
+/**
+ * @file lbfgs_history.hpp
+ * @author agent
+ *
+ * The curvature pairs of L-BFGS, in the compact representation.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LBFGS_LBFGS_HISTORY_HPP
+#define ENSMALLEN_LBFGS_LBFGS_HISTORY_HPP
+
+namespace ens {
+
+/**
+ * The last numBasis curvature pairs (s, y) of L-BFGS, and the inverse Hessian
+ * approximation they define.  The pairs are stored as the columns of a single
+ * n x 2m matrix W = [S Y], used as a ring buffer, together with the Gram
+ * matrices S^T Y and Y^T Y, which are updated with each new pair.  The
+ * product of the inverse Hessian approximation with a gradient g is computed
+ * with the compact representation
+ *
+ * \f[
+ * H g = \gamma g + S p - \gamma Y R^{-1} S^T g, \quad
+ * p = R^{-T} ((D + \gamma Y^T Y) R^{-1} S^T g - \gamma Y^T g),
+ * \f]
+ *
+ * where R is the upper triangle of S^T Y (in the order the pairs were stored)
+ * and D its diagonal.  The two products with W are matrix-vector products, so
+ * W is read twice per direction instead of four times per pair as in the
+ * two-loop recursion; everything else works on m x m matrices.
+ *
+ * The Gram matrix S^T S is kept as well, for the compact representation of
+ * the Hessian approximation itself, which SubspaceStep() uses.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Byrd1994,
+ *   author  = {Byrd, Richard H. and Nocedal, Jorge and Schnabel, Robert B.},
+ *   title   = {Representations of Quasi-Newton Matrices and their Use in
+ *              Limited Memory Methods},
+ *   journal = {Mathematical Programming},
+ *   volume  = {63},
+ *   number  = {1},
+ *   year    = {1994},
+ *   pages   = {129--156},
+ * }
+ * @endcode
+ */
+class LBFGSHistory
+{
+ public:
+  /**
+   * Create an empty history for coordinates of the given size.
+   *
+   * @param numBasis Number of curvature pairs to be stored.
+   * @param rows Number of rows of the coordinates.
+   * @param cols Number of columns of the coordinates.
+   */
+  LBFGSHistory(const size_t numBasis, const size_t rows, const size_t cols) :
+      numBasis(numBasis),
+      rows(rows),
+      cols(cols),
+      pairs(rows * cols, 2 * numBasis, arma::fill::zeros),
+      sy(numBasis, numBasis, arma::fill::zeros),
+      yy(numBasis, numBasis, arma::fill::zeros),
+      ss(numBasis, numBasis, arma::fill::zeros),
+      next(0),
+      size(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Store the curvature pair of the given step, overwriting the oldest pair
+   * if the history is full.
+   *
+   * @param iterate Current point.
+   * @param oldIterate Point at last iteration.
+   * @param gradient Gradient at current point (iterate).
+   * @param oldGradient Gradient at last iteration point (oldIterate).
+   */
+  void Update(const arma::mat& iterate,
+              const arma::mat& oldIterate,
+              const arma::mat& gradient,
+              const arma::mat& oldGradient)
+  {
+    const size_t n = pairs.n_rows;
+    arma::vec s(pairs.colptr(next), n, false, true);
+    arma::vec y(pairs.colptr(numBasis + next), n, false, true);
+    s = arma::vectorise(iterate - oldIterate);
+    y = arma::vectorise(gradient - oldGradient);
+
+    // Only the row and column of the new pair change in the Gram matrices.
+    // The unused columns are zero, so their entries are zero too.
+    const arma::vec ws = pairs.t() * s;
+    const arma::vec wy = pairs.t() * y;
+    sy.row(next) = ws.tail(numBasis).t();
+    sy.col(next) = wy.head(numBasis);
+    yy.row(next) = wy.tail(numBasis).t();
+    yy.col(next) = wy.tail(numBasis);
+    ss.row(next) = ws.head(numBasis).t();
+    ss.col(next) = ws.head(numBasis);
+
+    next = (next + 1) % numBasis;
+    size = std::min(size + 1, numBasis);
+  }
+
+  /**
+   * Calculate the scaling factor, gamma, which is used to scale the Hessian
+   * approximation matrix.  See method M3 in Section 4 of Liu and Nocedal
+   * (1989).
+   *
+   * @param gradient The gradient at the current point.
+   * @return The calculated scaling factor.
+   */
+  double ScalingFactor(const arma::mat& gradient) const
+  {
+    if (size == 0)
+      return 1.0 / std::sqrt(arma::dot(gradient, gradient));
+
+    const size_t last = (next + numBasis - 1) % numBasis;
+    return sy(last, last) / yy(last, last);
+  }
+
+  /**
+   * Find the L-BFGS search direction, -H g.
+   *
+   * @param gradient The gradient at the current point.
+   * @param scalingFactor Scaling factor to use (see ScalingFactor()).
+   * @param searchDirection Matrix to store the search direction in.
+   */
+  void SearchDirection(const arma::mat& gradient,
+                       const double scalingFactor,
+                       arma::mat& searchDirection) const
+  {
+    searchDirection.set_size(rows, cols);
+    if (size == 0)
+    {
+      searchDirection = -scalingFactor * gradient;
+      return;
+    }
+
+    const size_t n = pairs.n_rows;
+    const arma::vec g(const_cast<double*>(gradient.memptr()), n, false, true);
+    arma::vec direction(searchDirection.memptr(), n, false, true);
+
+    // The positions of the stored pairs, from the oldest to the newest.
+    arma::uvec order(size);
+    const size_t oldest = (next + numBasis - size) % numBasis;
+    for (size_t i = 0; i < size; ++i)
+      order[i] = (oldest + i) % numBasis;
+
+    // [S^T g; Y^T g] in a single pass over the pairs.
+    const arma::vec wg = pairs.t() * g;
+    const arma::vec sg = wg.elem(order);
+    const arma::vec yg = wg.elem(order + numBasis);
+
+    const arma::mat r = arma::trimatu(sy.submat(order, order));
+    const arma::vec u = arma::solve(arma::trimatu(r), sg);
+    const arma::vec p = arma::solve(arma::trimatl(r.t()),
+        arma::diagvec(r) % u + scalingFactor * (yy.submat(order, order) * u -
+        yg));
+
+    // -H g = -gamma g - S p + gamma Y u, in a single pass over the pairs.
+    arma::vec coefficients(2 * numBasis, arma::fill::zeros);
+    coefficients.elem(order) = -p;
+    coefficients.elem(order + numBasis) = scalingFactor * u;
+    direction = pairs * coefficients;
+    direction -= scalingFactor * g;
+  }
+
+  /**
+   * Minimize the quadratic model of the function with the Hessian
+   * approximation B over the given free coordinates, starting from a point
+   * offset from the current point, with the other coordinates held fixed.
+   * The step in the free coordinates is
+   *
+   * \f[
+   * d = -(Z^T B Z)^{-1} Z^T (g + B z),
+   * \f]
+   *
+   * where Z selects the free coordinates and z is the offset.  It is computed
+   * with the compact representation B = \theta I - W M W^T, W = [Y, \theta S],
+   * \theta = 1 / \gamma, and the Sherman-Morrison-Woodbury formula for the
+   * reduced matrix, so only 2m x 2m systems are solved; this is the direct
+   * primal method of Byrd et al. (1995).
+   *
+   * @param gradient The gradient at the current point.
+   * @param offset The offset of the starting point from the current point.
+   * @param free The indices of the free coordinates.
+   * @param scalingFactor Scaling factor to use (see ScalingFactor()).
+   * @param step Vector to store the step in the free coordinates in.
+   * @return false if the reduced system is singular.
+   */
+  bool SubspaceStep(const arma::mat& gradient,
+                    const arma::mat& offset,
+                    const arma::uvec& free,
+                    const double scalingFactor,
+                    arma::vec& step) const
+  {
+    const double theta = 1.0 / scalingFactor;
+
+    // Z^T (g + theta z); the rest of B z is subtracted below.
+    arma::vec residual = gradient.elem(free) + theta * offset.elem(free);
+    if (size == 0)
+    {
+      step = -scalingFactor * residual;
+      return true;
+    }
+
+    const size_t n = pairs.n_rows;
+    const arma::vec z(const_cast<double*>(offset.memptr()), n, false, true);
+
+    // The positions of the stored pairs, from the oldest to the newest.
+    arma::uvec order(size);
+    const size_t oldest = (next + numBasis - size) % numBasis;
+    for (size_t i = 0; i < size; ++i)
+      order[i] = (oldest + i) % numBasis;
+
+    // The middle matrix M^{-1} = [-D, L^T; L, theta S^T S], where L is the
+    // strictly lower triangle of S^T Y.
+    const arma::mat syOrdered = sy.submat(order, order);
+    const arma::mat l = syOrdered - arma::trimatu(syOrdered);
+    arma::mat middle(2 * size, 2 * size);
+    middle.submat(0, 0, size - 1, size - 1) = -arma::diagmat(syOrdered);
+    middle.submat(0, size, size - 1, 2 * size - 1) = l.t();
+    middle.submat(size, 0, 2 * size - 1, size - 1) = l;
+    middle.submat(size, size, 2 * size - 1, 2 * size - 1) =
+        theta * ss.submat(order, order);
+
+    // W^T z in a single pass over the pairs.
+    const arma::vec wz = pairs.t() * z;
+    const arma::vec wzOrdered = arma::join_cols(wz.elem(order + numBasis),
+        theta * wz.elem(order));
+
+    // The rows of W of the free coordinates.
+    const arma::uvec columns = arma::join_cols(order + numBasis, order);
+    arma::mat freePairs = pairs.submat(free, columns);
+    freePairs.cols(size, 2 * size - 1) *= theta;
+
+    arma::vec mwz;
+    if (!arma::solve(mwz, middle, wzOrdered))
+      return false;
+    residual -= freePairs * mwz;
+
+    // (Z^T B Z)^{-1} = I / theta + W_F (M^{-1} - W_F^T W_F / theta)^{-1} W_F^T
+    // / theta^2.
+    arma::vec v;
+    if (!arma::solve(v, middle - freePairs.t() * freePairs / theta,
+        freePairs.t() * residual))
+    {
+      return false;
+    }
+
+    step = -scalingFactor * residual -
+        (scalingFactor * scalingFactor) * (freePairs * v);
+    return true;
+  }
+
+  //! Get the number of curvature pairs to be stored.
+  size_t NumBasis() const { return numBasis; }
+
+  //! Get the number of curvature pairs currently stored.
+  size_t Size() const { return size; }
+
+ private:
+  //! The number of curvature pairs to be stored.
+  size_t numBasis;
+
+  //! The number of rows of the coordinates.
+  size_t rows;
+
+  //! The number of columns of the coordinates.
+  size_t cols;
+
+  //! The curvature pairs, [S Y]; column i of S and of Y form a pair.
+  arma::mat pairs;
+
+  //! The Gram matrix S^T Y.
+  arma::mat sy;
+
+  //! The Gram matrix Y^T Y.
+  arma::mat yy;
+
+  //! The Gram matrix S^T S.
+  arma::mat ss;
+
+  //! The position the next pair is stored at.
+  size_t next;
+
+  //! The number of pairs currently stored.
+  size_t size;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,444 @@
+/**
+ * @file more_thuente_line_search.hpp
+ * @author agent
+ *
+ * The More-Thuente line search for L-BFGS.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_LBFGS_MORE_THUENTE_LINE_SEARCH_HPP
+#define ENSMALLEN_LBFGS_MORE_THUENTE_LINE_SEARCH_HPP
+
+#include <ensmallen_bits/callbacks/callbacks.hpp>
+
+namespace ens {
+
+/**
+ * The line search of More and Thuente, which finds a step size satisfying the
+ * strong Wolfe conditions by safeguarded cubic and quadratic interpolation of
+ * the function values and directional derivatives of the trials.  A step size
+ * of 1 is tried first, which is usually accepted by L-BFGS, so that most
+ * iterations take a single evaluation; otherwise the interpolation converges
+ * in a few trials.  The function value and gradient of the accepted point are
+ * kept, so no extra evaluation is needed.
+ *
+ * The parameters of the search are taken from the optimizer: the Armijo
+ * constant is the sufficient decrease parameter, the Wolfe parameter bounds
+ * the directional derivative, and the number of trials and the step size are
+ * bounded by the maximum number of line search trials and the minimum and
+ * maximum step.  This is a port of the dcsrch and dcstep routines of
+ * MINPACK-2.
+ *
+ * @code
+ * @article{More1994,
+ *   author  = {Mor\'{e}, Jorge J. and Thuente, David J.},
+ *   title   = {Line Search Algorithms with Guaranteed Sufficient Decrease},
+ *   journal = {ACM Transactions on Mathematical Software},
+ *   volume  = {20},
+ *   number  = {3},
+ *   year    = {1994},
+ *   pages   = {286--307},
+ * }
+ * @endcode
+ */
+class MoreThuenteLineSearch
+{
+ public:
+  /**
+   * Construct the line search.
+   *
+   * @param xTolerance Relative width of the interval of uncertainty below
+   *     which the search stops.
+   */
+  MoreThuenteLineSearch(const double xTolerance = 1e-16) :
+      xTolerance(xTolerance)
+  { /* Nothing to do. */ }
+
+  /**
+   * Perform the line search along the search direction.  The iterate, the
+   * function value and the gradient are set to the accepted point.
+   *
+   * @param optimizer The optimizer, which holds the parameters of the search.
+   * @param function Function to optimize.
+   * @param functionValue Value of the function at the initial point.
+   * @param iterate The initial point to begin the line search from.
+   * @param gradient The gradient at the initial point.
+   * @param newIterateTmp Workspace for the trial points.
+   * @param searchDirection A vector specifying the search direction.
+   * @param terminate Set to true if a callback requested termination.
+   * @param callbacks Callbacks to be invoked for each evaluation.
+   *
+   * @return false if no step size decreases the function, true otherwise.
+   */
+  template<typename OptimizerType,
+           typename FunctionType,
+           typename... CallbackTypes>
+  bool Search(OptimizerType& optimizer,
+              FunctionType& function,
+              double& functionValue,
+              arma::mat& iterate,
+              arma::mat& gradient,
+              arma::mat& newIterateTmp,
+              const arma::mat& searchDirection,
+              bool& terminate,
+              CallbackTypes&... callbacks)
+  {
+    const double initialDerivative = arma::dot(gradient, searchDirection);
+
+    // If it is not a descent direction, just report failure.
+    if (initialDerivative >= 0.0)
+    {
+      Warn << "L-BFGS line search direction is not a descent direction "
+          << "(terminating)!" << std::endl;
+      return false;
+    }
+
+    const double initialFunctionValue = functionValue;
+    const double ftol = optimizer.ArmijoConstant();
+    const double gtol = optimizer.Wolfe();
+    const double minStep = optimizer.MinStep();
+    const double maxStep = optimizer.MaxStep();
+    const double derivativeTest = ftol * initialDerivative;
+
+    // The best step (stx), the other end of the interval of uncertainty
+    // (sty), and their function values and directional derivatives.
+    double stx = 0.0, fx = initialFunctionValue, dx = initialDerivative;
+    double sty = 0.0, fy = initialFunctionValue, dy = initialDerivative;
+    double stMin = 0.0;
+    double step = std::min(std::max(1.0, minStep), maxStep);
+    double stMax = step + 4.0 * step;
+    double width = maxStep - minStep;
+    double previousWidth = 2.0 * width;
+    bool bracketed = false;
+    bool firstStage = true;
+
+    // The smallest step so far whose trial is not finite; larger steps are
+    // not tried again.
+    double stepLimit = std::numeric_limits<double>::infinity();
+
+    // The best point so far, which is accepted if the search stops before the
+    // strong Wolfe conditions hold.
+    double bestStep = 0.0;
+    double bestObjective = initialFunctionValue;
+    bestGradient = gradient;
+    bool lastIsBest = false;
+
+    for (size_t trial = 1; ; ++trial)
+    {
+      newIterateTmp = iterate;
+      newIterateTmp += step * searchDirection;
+      functionValue = function.EvaluateWithGradient(newIterateTmp, gradient);
+
+      // A termination request only takes effect after the line search, so
+      // that the iterate is always left at a consistent point.
+      terminate |= Callback::Evaluate(optimizer, function, newIterateTmp,
+          functionValue, callbacks...);
+      terminate |= Callback::Gradient(optimizer, function, newIterateTmp,
+          gradient, callbacks...);
+
+      const double derivative = arma::dot(gradient, searchDirection);
+      const double sufficientValue = initialFunctionValue + step *
+          derivativeTest;
+
+      lastIsBest = (functionValue < bestObjective);
+      if (lastIsBest)
+      {
+        bestStep = step;
+        bestObjective = functionValue;
+      }
+
+      // The strong Wolfe conditions hold; accept the step.
+      if (functionValue <= sufficientValue &&
+          std::abs(derivative) <= gtol * (-initialDerivative))
+      {
+        iterate = newIterateTmp;
+        return true;
+      }
+
+      // Stop if the search can't make progress: rounding errors prevent
+      // progress, the interval is too small, a step bound is reached, or the
+      // maximum number of trials is reached.
+      if ((bracketed && (step <= stMin || step >= stMax)) ||
+          (bracketed && stMax - stMin <= xTolerance * stMax) ||
+          (step == maxStep && functionValue <= sufficientValue &&
+              derivative <= derivativeTest) ||
+          (step == minStep && (functionValue > sufficientValue ||
+              derivative >= derivativeTest)) ||
+          trial >= optimizer.MaxLineSearchTrials())
+      {
+        break;
+      }
+
+      // The step overflows (or leaves the domain of the function), so the
+      // trial can't be interpolated; bisect toward the best step instead.
+      if (!std::isfinite(functionValue) || !std::isfinite(derivative))
+      {
+        if (step <= minStep)
+          break;
+
+        stepLimit = std::min(stepLimit, step);
+        step = std::max(stx + 0.5 * (step - stx), minStep);
+        continue;
+      }
+
+      // Keep the gradient of the best trial, since the next trial overwrites
+      // it.
+      if (lastIsBest)
+        bestGradient = gradient;
+
+      // Use the modified function in the first stage, until a step with
+      // sufficient decrease and a non-negative derivative is found.
+      if (firstStage && functionValue <= sufficientValue && derivative >= 0.0)
+        firstStage = false;
+
+      if (firstStage && functionValue <= fx && functionValue > sufficientValue)
+      {
+        double fxm = fx - stx * derivativeTest;
+        double fym = fy - sty * derivativeTest;
+        double dxm = dx - derivativeTest;
+        double dym = dy - derivativeTest;
+        const double fm = functionValue - step * derivativeTest;
+        const double dm = derivative - derivativeTest;
+
+        Step(stx, fxm, dxm, sty, fym, dym, step, fm, dm, bracketed, stMin,
+            stMax);
+
+        fx = fxm + stx * derivativeTest;
+        fy = fym + sty * derivativeTest;
+        dx = dxm + derivativeTest;
+        dy = dym + derivativeTest;
+      }
+      else
+      {
+        Step(stx, fx, dx, sty, fy, dy, step, functionValue, derivative,
+            bracketed, stMin, stMax);
+      }
+
+      // Force a sufficient decrease of the interval of uncertainty.
+      if (bracketed)
+      {
+        if (std::abs(sty - stx) >= 0.66 * previousWidth)
+          step = stx + 0.5 * (sty - stx);
+        previousWidth = width;
+        width = std::abs(sty - stx);
+      }
+
+      // Set the bounds of the next step.
+      if (bracketed)
+      {
+        stMin = std::min(stx, sty);
+        stMax = std::max(stx, sty);
+      }
+      else
+      {
+        stMin = step + 1.1 * (step - stx);
+        stMax = step + 4.0 * (step - stx);
+      }
+
+      step = std::min(std::max(step, minStep), maxStep);
+      if (step >= stepLimit)
+        step = std::max(stx + 0.5 * (stepLimit - stx), minStep);
+
+      // If no further progress is possible, try the best step so far.
+      if (bracketed && (step <= stMin || step >= stMax ||
+          stMax - stMin <= xTolerance * stMax))
+      {
+        step = stx;
+      }
+    }
+
+    // The search stopped before the strong Wolfe conditions held; accept the
+    // best point, which is the initial point if no trial decreased the
+    // function.
+    functionValue = bestObjective;
+    if (!lastIsBest)
+      gradient = bestGradient;
+
+    if (bestStep == 0.0)
+      return false;
+
+    iterate += bestStep * searchDirection;
+    return true;
+  }
+
+  //! Get the relative width of the interval of uncertainty to stop at.
+  double XTolerance() const { return xTolerance; }
+  //! Modify the relative width of the interval of uncertainty to stop at.
+  double& XTolerance() { return xTolerance; }
+
+ private:
+  /**
+   * Compute the next trial step from the interval of uncertainty [stx, sty]
+   * and the current trial, and update the interval.  This is dcstep of
+   * MINPACK-2.
+   *
+   * @param stx Best step so far.
+   * @param fx Function value at stx.
+   * @param dx Directional derivative at stx.
+   * @param sty Other end of the interval of uncertainty.
+   * @param fy Function value at sty.
+   * @param dy Directional derivative at sty.
+   * @param stp Current step; will be set to the next step.
+   * @param fp Function value at stp.
+   * @param dp Directional derivative at stp.
+   * @param bracketed Whether a minimizer has been bracketed.
+   * @param stpMin Lower bound of the step.
+   * @param stpMax Upper bound of the step.
+   */
+  static void Step(double& stx, double& fx, double& dx,
+                   double& sty, double& fy, double& dy,
+                   double& stp, const double fp, const double dp,
+                   bool& bracketed,
+                   const double stpMin,
+                   const double stpMax)
+  {
+    const bool opposite = (dp * dx < 0.0);
+    double stpf;
+
+    if (fp > fx)
+    {
+      // Higher function value: the minimum is bracketed.  Take the cubic step
+      // if it is closer to stx than the quadratic step, else their average.
+      const double theta = 3.0 * (fx - fp) / (stp - stx) + dx + dp;
+      const double s = std::max(std::max(std::abs(theta), std::abs(dx)),
+          std::abs(dp));
+      double gamma = s * std::sqrt((theta / s) * (theta / s) -
+          (dx / s) * (dp / s));
+      if (stp < stx)
+        gamma = -gamma;
+      const double p = (gamma - dx) + theta;
+      const double q = ((gamma - dx) + gamma) + dp;
+      const double stpc = stx + (p / q) * (stp - stx);
+      const double stpq = stx + ((dx / ((fx - fp) / (stp - stx) + dx)) / 2.0) *
+          (stp - stx);
+      if (std::abs(stpc - stx) < std::abs(stpq - stx))
+        stpf = stpc;
+      else
+        stpf = stpc + (stpq - stpc) / 2.0;
+      bracketed = true;
+    }
+    else if (opposite)
+    {
+      // Derivatives of opposite sign: the minimum is bracketed.  Take the
+      // step farther from stp.
+      const double theta = 3.0 * (fx - fp) / (stp - stx) + dx + dp;
+      const double s = std::max(std::max(std::abs(theta), std::abs(dx)),
+          std::abs(dp));
+      double gamma = s * std::sqrt((theta / s) * (theta / s) -
+          (dx / s) * (dp / s));
+      if (stp > stx)
+        gamma = -gamma;
+      const double p = (gamma - dp) + theta;
+      const double q = ((gamma - dp) + gamma) + dx;
+      const double stpc = stp + (p / q) * (stx - stp);
+      const double stpq = stp + (dp / (dp - dx)) * (stx - stp);
+      if (std::abs(stpc - stp) > std::abs(stpq - stp))
+        stpf = stpc;
+      else
+        stpf = stpq;
+      bracketed = true;
+    }
+    else if (std::abs(dp) < std::abs(dx))
+    {
+      // The magnitude of the derivative decreases.  The cubic step is only
+      // used if it tends to infinity in the direction of the step or if its
+      // minimum is beyond stp.
+      const double theta = 3.0 * (fx - fp) / (stp - stx) + dx + dp;
+      const double s = std::max(std::max(std::abs(theta), std::abs(dx)),
+          std::abs(dp));
+      double gamma = s * std::sqrt(std::max(0.0, (theta / s) * (theta / s) -
+          (dx / s) * (dp / s)));
+      if (stp > stx)
+        gamma = -gamma;
+      const double p = (gamma - dp) + theta;
+      const double q = (gamma + (dx - dp)) + gamma;
+      const double r = p / q;
+      double stpc;
+      if (r < 0.0 && gamma != 0.0)
+        stpc = stp + r * (stx - stp);
+      else if (stp > stx)
+        stpc = stpMax;
+      else
+        stpc = stpMin;
+      const double stpq = stp + (dp / (dp - dx)) * (stx - stp);
+
+      if (bracketed)
+      {
+        // Take the step closer to stp, but not too close to sty.
+        stpf = (std::abs(stpc - stp) < std::abs(stpq - stp)) ? stpc : stpq;
+        if (stp > stx)
+          stpf = std::min(stp + 0.66 * (sty - stp), stpf);
+        else
+          stpf = std::max(stp + 0.66 * (sty - stp), stpf);
+      }
+      else
+      {
+        // Take the step farther from stp, within the bounds.
+        stpf = (std::abs(stpc - stp) > std::abs(stpq - stp)) ? stpc : stpq;
+        stpf = std::max(stpMin, std::min(stpMax, stpf));
+      }
+    }
+    else
+    {
+      // The magnitude of the derivative does not decrease.  If the minimum is
+      // not bracketed, the step is either stpMin or stpMax, else the cubic
+      // step of stp and sty.
+      if (bracketed)
+      {
+        const double theta = 3.0 * (fp - fy) / (sty - stp) + dy + dp;
+        const double s = std::max(std::max(std::abs(theta), std::abs(dy)),
+            std::abs(dp));
+        double gamma = s * std::sqrt((theta / s) * (theta / s) -
+            (dy / s) * (dp / s));
+        if (stp > sty)
+          gamma = -gamma;
+        const double p = (gamma - dp) + theta;
+        const double q = ((gamma - dp) + gamma) + dy;
+        stpf = stp + (p / q) * (sty - stp);
+      }
+      else if (stp > stx)
+      {
+        stpf = stpMax;
+      }
+      else
+      {
+        stpf = stpMin;
+      }
+    }
+
+    // Update the interval of uncertainty.
+    if (fp > fx)
+    {
+      sty = stp;
+      fy = fp;
+      dy = dp;
+    }
+    else
+    {
+      if (opposite)
+      {
+        sty = stx;
+        fy = fx;
+        dy = dx;
+      }
+      stx = stp;
+      fx = fp;
+      dx = dp;
+    }
+
+    stp = stpf;
+  }
+
+  //! The gradient of the best trial so far.
+  arma::mat bestGradient;
+
+  //! The relative width of the interval of uncertainty to stop at.
+  double xTolerance;
+};
+
+} // namespace ens
+
+#endif
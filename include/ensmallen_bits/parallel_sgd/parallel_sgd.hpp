@@ -43,8 +43,16 @@ namespace ens {
  * In these functions the parameter id refers to which individual function (or
  * gradient) is being evaluated. In case of a data-dependent function, the id
  * would refer to the index of the datapoint(or training example).
- * The data is distributed uniformly among the threads made available to the
- * program by the OpenMP runtime.
+ * In each iteration, numThreads * threadShareSize datapoints are processed,
+ * where numThreads is the number of threads made available to the program by
+ * the OpenMP runtime.  The datapoints are handed out to the threads in small
+ * chunks as the threads become idle, so a thread that is slowed down (by
+ * denser gradients or by the operating system) does not hold up the others.
+ *
+ * The objective that is used to check for convergence is computed in parallel
+ * at the start of each iteration.  For large datasets, it can instead be
+ * estimated from a fixed random sample of the functions; see the
+ * objectiveSamples parameter.
  *
  * The Gradient function interface is slightly changed from the
  * DecomposableFunctionType interface, it takes in a sparse matrix as the
@@ -74,12 +82,17 @@ class ParallelSGD
    * @param shuffle If true, the function order is shuffled; otherwise, each
    *     function is visited in linear order.
    * @param decayPolicy The step size update policy to use.
+   * @param objectiveSamples Number of functions the objective is estimated
+   *     from to check for convergence (0 means that all functions are used).
+   *     The sample is drawn once per optimization, and the estimate is scaled
+   *     to the number of functions; the returned objective is always exact.
   */
   ParallelSGD(const size_t maxIterations,
               const size_t threadShareSize,
               const double tolerance = 1e-5,
               const bool shuffle = true,
-              const DecayPolicyType& decayPolicy = DecayPolicyType());
+              const DecayPolicyType& decayPolicy = DecayPolicyType(),
+              const size_t objectiveSamples = 0);
 
   /**
    * Optimize the given function using the parallel SGD algorithm. The given
@@ -122,7 +135,29 @@ class ParallelSGD
   //! Modify the step size decay policy.
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
+  //! Get the number of functions the objective is estimated from (0 means
+  //! all functions).
+  size_t ObjectiveSamples() const { return objectiveSamples; }
+  //! Modify the number of functions the objective is estimated from (0 means
+  //! all functions).
+  size_t& ObjectiveSamples() { return objectiveSamples; }
+
  private:
+  /**
+   * Compute the sum of the objectives of the given functions in parallel.  If
+   * the indices are empty, all the functions are used.
+   *
+   * @param function Function to evaluate.
+   * @param iterate Point to evaluate at.
+   * @param indices Indices of the functions to evaluate.
+   * @param partObjectives Per-thread sums (reused between calls).
+   */
+  template<typename SparseFunctionType>
+  double ParallelEvaluate(SparseFunctionType& function,
+                          const arma::mat& iterate,
+                          const arma::Col<size_t>& indices,
+                          std::vector<double>& partObjectives) const;
+
   //! The maximum number of allowed iterations.
   size_t maxIterations;
 
@@ -138,6 +173,9 @@ class ParallelSGD
 
   //! The step size decay policy.
   DecayPolicyType decayPolicy;
+
+  //! The number of functions the objective is estimated from.
+  size_t objectiveSamples;
 };
 
 } // namespace ens
@@ -25,12 +25,14 @@ ParallelSGD<DecayPolicyType>::ParallelSGD(
     const size_t threadShareSize,
     const double tolerance,
     const bool shuffle,
-    const DecayPolicyType& decayPolicy) :
+    const DecayPolicyType& decayPolicy,
+    const size_t objectiveSamples) :
     maxIterations(maxIterations),
     threadShareSize(threadShareSize),
     tolerance(tolerance),
     shuffle(shuffle),
-    decayPolicy(decayPolicy)
+    decayPolicy(decayPolicy),
+    objectiveSamples(objectiveSamples)
 { /* Nothing to do. */ }
 
 template <typename DecayPolicyType>
@@ -42,12 +44,46 @@ double ParallelSGD<DecayPolicyType>::Optimize(
   // Check that we have all the functions that we need.
   traits::CheckSparseFunctionTypeAPI<SparseFunctionType>();
 
+  const size_t numFunctions = function.NumFunctions();
+
+  size_t numThreads = 1;
+  #ifdef ENS_USE_OPENMP
+    numThreads = omp_get_max_threads();
+  #endif
+
   double overallObjective = DBL_MAX;
   double lastObjective;
 
   // The order in which the functions will be visited.
   arma::Col<size_t> visitationOrder = arma::linspace<arma::Col<size_t>>(0,
-      (function.NumFunctions() - 1), function.NumFunctions());
+      (numFunctions - 1), numFunctions);
+
+  // The functions the objective is estimated from, if it is sampled.  The
+  // sample is fixed, so that the change of the estimate between iterations
+  // reflects the change of the iterate and not of the sample.
+  const bool sampled = (objectiveSamples > 0 &&
+      objectiveSamples < numFunctions);
+  arma::Col<size_t> objectiveIndices;
+  if (sampled)
+  {
+    objectiveIndices = arma::shuffle(visitationOrder);
+    objectiveIndices = objectiveIndices.head(objectiveSamples);
+  }
+  const double objectiveScale = sampled ?
+      (double) numFunctions / objectiveSamples : 1.0;
+  std::vector<double> partObjectives;
+
+  // The points processed in each iteration are split into chunks, which the
+  // threads take one at a time; use several chunks per thread, so that the
+  // work is balanced when some points are more expensive than others.
+  const size_t iterationSize = std::min(numThreads * threadShareSize,
+      numFunctions);
+  const size_t chunkSize = std::max(threadShareSize / 8, size_t(1));
+  const size_t numChunks = (iterationSize + chunkSize - 1) / chunkSize;
+
+  // Each thread reuses its gradient, so that its storage is not allocated for
+  // every point.
+  std::vector<arma::sp_mat> threadGradients(numThreads);
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -57,7 +93,8 @@ double ParallelSGD<DecayPolicyType>::Optimize(
     // Calculate the overall objective.
     lastObjective = overallObjective;
 
-    overallObjective = function.Evaluate(iterate);
+    overallObjective = objectiveScale * ParallelEvaluate(function, iterate,
+        objectiveIndices, partObjectives);
 
     // Output current objective function.
     Info << "Parallel SGD: iteration " << i << ", objective "
@@ -75,7 +112,7 @@ double ParallelSGD<DecayPolicyType>::Optimize(
     {
       Info << "SGD: minimized within tolerance " << tolerance << "; "
         << "terminating optimization." << std::endl;
-      return overallObjective;
+      break;
     }
 
     // Get the stepsize for this iteration
@@ -90,45 +127,102 @@ double ParallelSGD<DecayPolicyType>::Optimize(
 
     ENS_PRAGMA_OMP_PARALLEL
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize
       size_t threadId = 0;
       #ifdef ENS_USE_OPENMP
         threadId = omp_get_thread_num();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
-      {
-        // Each instance affects only some components of the decision variable.
-        // So the gradient is sparse.
-        arma::sp_mat gradient;
-
-        // Evaluate the sparse gradient.
-        function.Gradient(iterate, visitationOrder[j], gradient, 1);
+      // Each instance affects only some components of the decision variable.
+      // So the gradient is sparse.
+      arma::sp_mat& gradient = threadGradients[threadId];
 
-        // Update the decision variable with non-zero components of the
-        // gradient.
-        for (size_t i = 0; i < gradient.n_cols; ++i)
+      // The loop variable is signed for OpenMP 2.0 compilers.
+      ENS_PRAGMA_OMP_FOR_DYNAMIC
+      for (ptrdiff_t c = 0; c < (ptrdiff_t) numChunks; ++c)
+      {
+        const size_t chunkBegin = size_t(c) * chunkSize;
+        const size_t chunkEnd = std::min(chunkBegin + chunkSize,
+            iterationSize);
+        for (size_t j = chunkBegin; j < chunkEnd; ++j)
         {
-          // Iterate over the non-zero elements.
-          for (arma::sp_mat::iterator cur = gradient.begin_col(i);
-              cur != gradient.end_col(i); ++cur)
+          // Evaluate the sparse gradient.
+          function.Gradient(iterate, visitationOrder[j], gradient, 1);
+
+          // Update the decision variable with non-zero components of the
+          // gradient.
+          for (size_t k = 0; k < gradient.n_cols; ++k)
           {
-            ENS_PRAGMA_OMP_ATOMIC
-            iterate(cur.row(), i) -= stepSize * (*cur);
+            // Iterate over the non-zero elements.
+            for (arma::sp_mat::iterator cur = gradient.begin_col(k);
+                cur != gradient.end_col(k); ++cur)
+            {
+              ENS_PRAGMA_OMP_ATOMIC
+              iterate(cur.row(), k) -= stepSize * (*cur);
+            }
           }
         }
       }
     }
   }
 
+  // The estimate is only good enough to check for convergence.
+  if (sampled)
+  {
+    overallObjective = ParallelEvaluate(function, iterate, arma::Col<size_t>(),
+        partObjectives);
+  }
+
   Info << "\n Parallel SGD terminated with objective : "
     << overallObjective << std::endl;
   return overallObjective;
 }
 
+template <typename DecayPolicyType>
+template <typename SparseFunctionType>
+double ParallelSGD<DecayPolicyType>::ParallelEvaluate(
+    SparseFunctionType& function,
+    const arma::mat& iterate,
+    const arma::Col<size_t>& indices,
+    std::vector<double>& partObjectives) const
+{
+  const size_t numPoints = indices.is_empty() ? function.NumFunctions() :
+      indices.n_elem;
+
+  size_t numParts = 1;
+  #ifdef ENS_USE_OPENMP
+    numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, numPoints), size_t(1));
+  partObjectives.assign(numParts, 0.0);
+
+  // The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
+  {
+    const size_t begin = (size_t(p) * numPoints) / numParts;
+    const size_t end = ((size_t(p) + 1) * numPoints) / numParts;
+    if (begin == end)
+      continue;
+
+    if (indices.is_empty())
+    {
+      partObjectives[p] = function.Evaluate(iterate, begin, end - begin);
+    }
+    else
+    {
+      for (size_t j = begin; j < end; ++j)
+        partObjectives[p] += function.Evaluate(iterate, indices[j], 1);
+    }
+  }
+
+  // Reduce in a fixed order, so that the result is deterministic.
+  double objective = 0.0;
+  for (size_t p = 0; p < numParts; ++p)
+    objective += partObjectives[p];
+
+  return objective;
+}
+
 } // namespace ens
 
 #endif
@@ -14,6 +14,8 @@
 #ifndef ENSMALLEN_PROBLEMS_LOGISTIC_REGRESSION_FUNCTION_HPP
 #define ENSMALLEN_PROBLEMS_LOGISTIC_REGRESSION_FUNCTION_HPP
 
+#include <ensmallen_bits/utility/visitation_order.hpp>
+
 namespace ens {
 namespace test {
 
@@ -32,13 +34,13 @@ class LogisticRegressionFunction
 
   LogisticRegressionFunction(const MatType& predictors,
                              const arma::Row<size_t>& responses,
-                             const arma::vec& initialPoint,
+                             const MatType& initialPoint,
                              const double lambda = 0);
 
   //! Return the initial point for the optimization.
-  const arma::mat& InitialPoint() const { return initialPoint; }
+  const MatType& InitialPoint() const { return initialPoint; }
   //! Modify the initial point for the optimization.
-  arma::mat& InitialPoint() { return initialPoint; }
+  MatType& InitialPoint() { return initialPoint; }
 
   //! Return the regularization parameter (lambda).
   const double& Lambda() const { return lambda; }
@@ -51,10 +53,22 @@ class LogisticRegressionFunction
   const arma::Row<size_t>& Responses() const { return responses; }
 
   /**
-  * Shuffle the order of function visitation.  This may be called by the optimizer.
-  */
+   * Shuffle the order of function visitation.  This may be called by the
+   * optimizer.  The data is not reordered; instead, a permutation of the
+   * points is kept, and the points of each batch are gathered through it (or
+   * accessed in place, when they are consecutive in memory).  See
+   * ShuffleBlockSize() to shuffle blocks of consecutive points instead of
+   * individual points.
+   */
   void Shuffle();
 
+  //! Get the number of consecutive points that are kept together when
+  //! shuffling (1 shuffles individual points).
+  size_t ShuffleBlockSize() const { return shuffleBlockSize; }
+  //! Modify the number of consecutive points that are kept together when
+  //! shuffling (1 shuffles individual points).
+  size_t& ShuffleBlockSize() { return shuffleBlockSize; }
+
   /**
    * Evaluate the logistic regression log-likelihood function with the given
    * parameters.  Note that if a point has 0 probability of being classified
@@ -66,7 +80,7 @@ class LogisticRegressionFunction
    *
    * @param parameters Vector of logistic regression parameters.
    */
-  double Evaluate(const arma::mat& parameters) const;
+  typename MatType::elem_type Evaluate(const MatType& parameters) const;
 
   /**
    * Evaluate the logistic regression log-likelihood function with the given
@@ -85,9 +99,9 @@ class LogisticRegressionFunction
    * @param batchSize Number of points to be passed at a time to use for
    *     objective function evaluation.
    */
-  double Evaluate(const arma::mat& parameters,
-                  const size_t begin,
-                  const size_t batchSize = 1) const;
+  typename MatType::elem_type Evaluate(const MatType& parameters,
+                                       const size_t begin,
+                                       const size_t batchSize = 1) const;
 
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
@@ -96,7 +110,7 @@ class LogisticRegressionFunction
    * @param parameters Vector of logistic regression parameters.
    * @param gradient Vector to output gradient into.
    */
-  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+  void Gradient(const MatType& parameters, MatType& gradient) const;
 
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
@@ -112,7 +126,7 @@ class LogisticRegressionFunction
    *     function gradient evaluation.
    */
   template<typename GradType>
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const MatType& parameters,
                 const size_t begin,
                 GradType& gradient,
                 const size_t batchSize = 1) const;
@@ -128,26 +142,28 @@ class LogisticRegressionFunction
    *    be computed.
    * @param gradient Sparse matrix to output gradient into.
    */
-  void PartialGradient(const arma::mat& parameters,
-                       const size_t j,
-                       arma::sp_mat& gradient) const;
+  void PartialGradient(
+      const MatType& parameters,
+      const size_t j,
+      arma::SpMat<typename MatType::elem_type>& gradient) const;
 
   /**
    * Evaluate the objective function and gradient of the logistic regression
    * log-likelihood function simultaneously with the given parameters.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
-                              GradType& gradient) const;
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   GradType& gradient) const;
 
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
-                              const size_t begin,
-                              GradType& gradient,
-                              const size_t batchSize = 1) const;
+  typename MatType::elem_type EvaluateWithGradient(
+      const MatType& parameters,
+      const size_t begin,
+      GradType& gradient,
+      const size_t batchSize = 1) const;
 
   //! Return the initial point for the optimization.
-  const arma::mat& GetInitialPoint() const { return initialPoint; }
+  const MatType& GetInitialPoint() const { return initialPoint; }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return predictors.n_cols; }
@@ -172,7 +188,7 @@ class LogisticRegressionFunction
    */
   double ComputeAccuracy(const MatType& predictors,
                          const arma::Row<size_t>& responses,
-                         const arma::mat& parameters,
+                         const MatType& parameters,
                          const double decisionBoundary = 0.5) const;
 
   /**
@@ -189,20 +205,39 @@ class LogisticRegressionFunction
    */
   void Classify(const MatType& dataset,
                 arma::Row<size_t>& labels,
-                const arma::mat& parameters,
+                const MatType& parameters,
                 const double decisionBoundary = 0.5) const;
 
  private:
+  //! The type of the elements of the data and the parameters.
+  typedef typename MatType::elem_type ElemType;
+  //! The row vector type used for intermediate results.
+  typedef arma::Row<ElemType> RowType;
+
+  /**
+   * Get the predictors and responses of the given batch, in visitation order.
+   * If the points of the batch are consecutive in memory, the outputs are
+   * aliases of the data; otherwise, they are gathered copies.
+   */
+  void GetBatch(const size_t begin,
+                const size_t batchSize,
+                MatType& batchPredictors,
+                arma::Row<size_t>& batchResponses) const;
+
   //! The initial point, from which to start the optimization.
-  arma::mat initialPoint;
-  //! The matrix of data points (predictors).  This is an alias until shuffling
-  //! is done.
+  MatType initialPoint;
+  //! The matrix of data points (predictors).  This is an alias of the data
+  //! given to the constructor.
   MatType predictors;
-  //! The vector of responses to the input data points.  This is an alias until
-  //! shuffling is done.
+  //! The vector of responses to the input data points.  This is an alias of
+  //! the responses given to the constructor.
   arma::Row<size_t> responses;
   //! The regularization parameter for L2-regularization.
   double lambda;
+  //! The order in which the points are visited (empty until shuffled).
+  arma::uvec visitationOrder;
+  //! The number of consecutive points that are kept together when shuffling.
+  size_t shuffleBlockSize;
 };
 
 // Convenience typedefs.
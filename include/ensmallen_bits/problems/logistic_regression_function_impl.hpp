@@ -29,9 +29,10 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
     responses(arma::Row<size_t>(
         const_cast<arma::Row<size_t>&>(responses).memptr(),
         responses.n_elem, false, false)),
-    lambda(lambda)
+    lambda(lambda),
+    shuffleBlockSize(1)
 {
-  initialPoint = arma::rowvec(predictors.n_rows + 1, arma::fill::zeros);
+  initialPoint = RowType(predictors.n_rows + 1, arma::fill::zeros);
 
   // Sanity check.
   if (responses.n_elem != predictors.n_cols)
@@ -49,7 +50,7 @@ template<typename MatType>
 LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
     const MatType& predictors,
     const arma::Row<size_t>& responses,
-    const arma::vec& initialPoint,
+    const MatType& initialPoint,
     const double lambda) :
     initialPoint(initialPoint),
     predictors(MatType(const_cast<MatType&>(predictors).memptr(), predictors.n_rows,
@@ -57,12 +58,13 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
     responses(arma::Row<size_t>(
         const_cast<arma::Row<size_t>&>(responses).memptr(),
         responses.n_elem, false, false)),
-    lambda(lambda)
+    lambda(lambda),
+    shuffleBlockSize(1)
 {
   // To check if initialPoint is compatible with predictors.
   if (initialPoint.n_rows != (predictors.n_rows + 1) ||
       initialPoint.n_cols != 1)
-    this->initialPoint = arma::rowvec(predictors.n_rows + 1, arma::fill::zeros);
+    this->initialPoint = RowType(predictors.n_rows + 1, arma::fill::zeros);
 }
 
 /**
@@ -71,25 +73,38 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
 template<typename MatType>
 void LogisticRegressionFunction<MatType>::Shuffle()
 {
-  MatType newPredictors;
-  arma::Row<size_t> newResponses;
-
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      predictors.n_cols - 1, predictors.n_cols));
-
-  newPredictors = predictors.cols(ordering);
-  newResponses = responses.cols(ordering);
-
-  // If we are an alias, make sure we don't write to the original data.
-  if (predictors.mem_state >= 1)
-    predictors.reset();
+  ShuffleVisitationOrder(predictors.n_cols, shuffleBlockSize, visitationOrder);
+}
 
-  if (responses.mem_state >= 1)
-    responses.reset();
+/**
+ * Get the predictors and responses of a batch.
+ */
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::GetBatch(
+    const size_t begin,
+    const size_t batchSize,
+    MatType& batchPredictors,
+    arma::Row<size_t>& batchResponses) const
+{
+  if (IsContiguousBatch(visitationOrder, begin, batchSize))
+  {
+    const size_t first = visitationOrder.is_empty() ? begin :
+        visitationOrder[begin];
 
-  // Take ownership of the new data.
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+    // We promise to be well-behaved... the elements won't be modified.
+    batchPredictors = MatType(const_cast<ElemType*>(predictors.colptr(first)),
+        predictors.n_rows, batchSize, false, false);
+    batchResponses = arma::Row<size_t>(
+        const_cast<size_t*>(responses.memptr() + first), batchSize, false,
+        false);
+  }
+  else
+  {
+    const arma::uvec indices = visitationOrder.subvec(begin,
+        begin + batchSize - 1);
+    batchPredictors = predictors.cols(indices);
+    batchResponses = responses.cols(indices);
+  }
 }
 
 /**
@@ -97,8 +112,9 @@ void LogisticRegressionFunction<MatType>::Shuffle()
  * parameters.
  */
 template<typename MatType>
-double LogisticRegressionFunction<MatType>::Evaluate(
-    const arma::mat& parameters) const
+typename MatType::elem_type
+LogisticRegressionFunction<MatType>::Evaluate(
+    const MatType& parameters) const
 {
   // The objective function is the log-likelihood function (w is the parameters
   // vector for the model; y is the responses; x is the predictors; sig() is the
@@ -109,13 +125,13 @@ double LogisticRegressionFunction<MatType>::Evaluate(
 
   // For the regularization, we ignore the first term, which is the intercept
   // term and take every term except the last one in the decision variable.
-  const double regularization = 0.5 * lambda *
+  const ElemType regularization = 0.5 * lambda *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
   // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
   // does not need to be multiplied by any of the predictors.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+  const RowType sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
       parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
   // Assemble full objective function.  Often the objective function and the
@@ -124,9 +140,9 @@ double LogisticRegressionFunction<MatType>::Evaluate(
   // terms for computational efficiency.  Note that the conversion causes some
   // copy and slowdown, but this is so negligible compared to the rest of the
   // calculation it is not worth optimizing for.
-  const double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoid %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  const ElemType result = arma::accu(arma::log(1.0 -
+      arma::conv_to<RowType>::from(responses) + sigmoid %
+      (2 * arma::conv_to<RowType>::from(responses) - 1.0)));
 
   // Invert the result, because it's a minimization.
   return regularization - result;
@@ -137,26 +153,30 @@ double LogisticRegressionFunction<MatType>::Evaluate(
  * parameters for a given batch from a given point.
  */
 template<typename MatType>
-double LogisticRegressionFunction<MatType>::Evaluate(
-                  const arma::mat& parameters,
+typename MatType::elem_type
+LogisticRegressionFunction<MatType>::Evaluate(
+                  const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize) const
 {
+  // Get the points of the batch, in visitation order.
+  MatType batchPredictors;
+  arma::Row<size_t> batchResponses;
+  GetBatch(begin, batchSize, batchPredictors, batchResponses);
+
   // Calculate the regularization term.
-  const double regularization = lambda *
+  const ElemType regularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
   // Calculate the sigmoid function values.
-  const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+  const RowType sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batchPredictors)));
 
   // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
+  RowType respD = arma::conv_to<RowType>::from(batchResponses);
+  const ElemType result = arma::accu(arma::log(1.0 - respD + sigmoid %
       (2 * respD - 1.0)));
 
   // Invert the result, because it's a minimization.
@@ -166,14 +186,14 @@ double LogisticRegressionFunction<MatType>::Evaluate(
 //! Evaluate the gradient of the logistic regression objective function.
 template<typename MatType>
 void LogisticRegressionFunction<MatType>::Gradient(
-    const arma::mat& parameters,
-    arma::mat& gradient) const
+    const MatType& parameters,
+    MatType& gradient) const
 {
   // Regularization term.
-  arma::mat regularization;
+  MatType regularization;
   regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
 
-  const arma::rowvec sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
+  const RowType sigmoids = (1 / (1 + arma::exp(-parameters(0, 0)
       - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
   gradient.set_size(arma::size(parameters));
@@ -187,28 +207,30 @@ void LogisticRegressionFunction<MatType>::Gradient(
 template<typename MatType>
 template<typename GradType>
 void LogisticRegressionFunction<MatType>::Gradient(
-                const arma::mat& parameters,
+                const MatType& parameters,
                 const size_t begin,
                 GradType& gradient,
                 const size_t batchSize) const
 {
+  // Get the points of the batch, in visitation order.
+  MatType batchPredictors;
+  arma::Row<size_t> batchResponses;
+  GetBatch(begin, batchSize, batchPredictors, batchResponses);
+
   // Regularization term.
-  arma::mat regularization;
+  MatType regularization;
   regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
       / predictors.n_cols * batchSize;
 
-  const arma::rowvec exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
+  const RowType exponents = parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batchPredictors;
   // Calculating the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
+  const RowType sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
 
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = -arma::accu(batchResponses - sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - batchResponses) *
+      batchPredictors.t() + regularization;
 }
 
 /**
@@ -217,11 +239,11 @@ void LogisticRegressionFunction<MatType>::Gradient(
  */
 template <typename MatType>
 void LogisticRegressionFunction<MatType>::PartialGradient(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t j,
-    arma::sp_mat& gradient) const
+    arma::SpMat<typename MatType::elem_type>& gradient) const
 {
-  const arma::rowvec diffs = responses - (1 / (1 + arma::exp(-parameters(0, 0)
+  const RowType diffs = responses - (1 / (1 + arma::exp(-parameters(0, 0)
       - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
   gradient.set_size(arma::size(parameters));
@@ -239,20 +261,21 @@ void LogisticRegressionFunction<MatType>::PartialGradient(
 
 template<typename MatType>
 template<typename GradType>
-double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
-    const arma::mat& parameters,
+typename MatType::elem_type
+LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const MatType& parameters,
     GradType& gradient) const
 {
   // Regularization term.
-  arma::mat regularization = lambda *
+  MatType regularization = lambda *
       parameters.tail_cols(parameters.n_elem - 1);
 
-  const double objectiveRegularization = lambda / 2.0 *
+  const ElemType objectiveRegularization = lambda / 2.0 *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
   // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+  const RowType sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
       parameters.tail_cols(parameters.n_elem - 1) * predictors)));
 
   gradient.set_size(arma::size(parameters));
@@ -261,9 +284,9 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
       predictors.t() + regularization;
 
   // Now compute the objective function using the sigmoids.
-  double result = arma::accu(arma::log(1.0 -
-      arma::conv_to<arma::rowvec>::from(responses) + sigmoids %
-      (2 * arma::conv_to<arma::rowvec>::from(responses) - 1.0)));
+  ElemType result = arma::accu(arma::log(1.0 -
+      arma::conv_to<RowType>::from(responses) + sigmoids %
+      (2 * arma::conv_to<RowType>::from(responses) - 1.0)));
 
   // Invert the result, because it's a minimization.
   return objectiveRegularization - result;
@@ -271,38 +294,40 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 
 template<typename MatType>
 template<typename GradType>
-double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
-    const arma::mat& parameters,
+typename MatType::elem_type
+LogisticRegressionFunction<MatType>::EvaluateWithGradient(
+    const MatType& parameters,
     const size_t begin,
     GradType& gradient,
     const size_t batchSize) const
 {
+  // Get the points of the batch, in visitation order.
+  MatType batchPredictors;
+  arma::Row<size_t> batchResponses;
+  GetBatch(begin, batchSize, batchPredictors, batchResponses);
+
   // Regularization term.
-  arma::mat regularization =
+  MatType regularization =
       lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
       batchSize;
 
-  const double objectiveRegularization = lambda *
+  const ElemType objectiveRegularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
       arma::dot(parameters.tail_cols(parameters.n_elem - 1),
                 parameters.tail_cols(parameters.n_elem - 1));
 
   // Calculate the sigmoid function values.
-  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+  const RowType sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batchPredictors)));
 
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = -arma::accu(batchResponses - sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - batchResponses) *
+      batchPredictors.t() + regularization;
 
   // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
-  const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
+  RowType respD = arma::conv_to<RowType>::from(batchResponses);
+  const ElemType result = arma::accu(arma::log(1.0 - respD + sigmoids %
       (2 * respD - 1.0)));
 
   // Invert the result, because it's a minimization.
@@ -313,7 +338,7 @@ template<typename MatType>
 void LogisticRegressionFunction<MatType>::Classify(
     const MatType& dataset,
     arma::Row<size_t>& labels,
-    const arma::mat& parameters,
+    const MatType& parameters,
     const double decisionBoundary) const
 {
   // Calculate sigmoid function for each point.  The (1.0 - decisionBoundary)
@@ -328,7 +353,7 @@ template<typename MatType>
 double LogisticRegressionFunction<MatType>::ComputeAccuracy(
     const MatType& predictors,
     const arma::Row<size_t>& responses,
-    const arma::mat& parameters,
+    const MatType& parameters,
     const double decisionBoundary) const
 {
   // Predict responses using the current model.
@@ -13,6 +13,8 @@
 #ifndef ENSMALLEN_PROBLEMS_SOFTMAX_REGRESSION_FUNCTION_HPP
 #define ENSMALLEN_PROBLEMS_SOFTMAX_REGRESSION_FUNCTION_HPP
 
+#include <ensmallen_bits/utility/visitation_order.hpp>
+
 namespace ens {
 namespace test {
 
@@ -40,10 +42,19 @@ class SoftmaxRegressionFunction
   const arma::mat InitializeWeights();
 
   /**
-   * Shuffle the dataset.
+   * Shuffle the dataset.  The data is not reordered; instead, a permutation of
+   * the points is kept, and the points of each batch are gathered through it
+   * (or accessed in place, when they are consecutive in memory).
    */
   void Shuffle();
 
+  //! Get the number of consecutive points that are kept together when
+  //! shuffling (1 shuffles individual points).
+  size_t ShuffleBlockSize() const { return shuffleBlockSize; }
+  //! Modify the number of consecutive points that are kept together when
+  //! shuffling (1 shuffles individual points).
+  size_t& ShuffleBlockSize() { return shuffleBlockSize; }
+
   /**
    * Initialize Softmax Regression weights (trainable parameters) with the given
    * parameters.
@@ -78,7 +89,7 @@ class SoftmaxRegressionFunction
    * @param groundTruth Pointer to arma::mat which stores the computed matrix.
    */
   void GetGroundTruthMatrix(const arma::Row<size_t>& labels,
-                            arma::sp_mat& groundTruth);
+                            arma::sp_mat& groundTruth) const;
 
   /**
    * Evaluate the probabilities matrix with the passed parameters.
@@ -183,8 +194,30 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
-  //! Training data matrix.  This is an alias until the data is shuffled.
+  /**
+   * Get the data points and the ground truth of the given batch, in visitation
+   * order.  If the points of the batch are consecutive in memory, the data is
+   * an alias; otherwise, it is a gathered copy.
+   */
+  void GetBatch(const size_t start,
+                const size_t batchSize,
+                arma::mat& batchData,
+                arma::sp_mat& batchGroundTruth) const;
+
+  /**
+   * Compute the probabilities matrix of the given data points; see
+   * GetProbabilitiesMatrix().
+   */
+  void GetBatchProbabilities(const arma::mat& parameters,
+                             const arma::mat& batchData,
+                             arma::mat& probabilities) const;
+
+  //! Training data matrix.  This is an alias of the data given to the
+  //! constructor.
   arma::mat data;
+  //! Labels of the training data.  This is an alias of the labels given to the
+  //! constructor.
+  arma::Row<size_t> labels;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
   //! Initial parameter point.
@@ -195,6 +228,10 @@ class SoftmaxRegressionFunction
   double lambda;
   //! Intercept term flag.
   bool fitIntercept;
+  //! The order in which the points are visited (empty until shuffled).
+  arma::uvec visitationOrder;
+  //! The number of consecutive points that are kept together when shuffling.
+  size_t shuffleBlockSize;
 };
 
 } // namespace test
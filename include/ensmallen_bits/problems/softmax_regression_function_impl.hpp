@@ -26,9 +26,12 @@ inline SoftmaxRegressionFunction::SoftmaxRegressionFunction(
     const bool fitIntercept) :
     data(arma::mat(const_cast<arma::mat&>(data).memptr(), data.n_rows,
       data.n_cols, false, false)),
+    labels(arma::Row<size_t>(const_cast<arma::Row<size_t>&>(labels).memptr(),
+      labels.n_elem, false, false)),
     numClasses(numClasses),
     lambda(lambda),
-    fitIntercept(fitIntercept)
+    fitIntercept(fitIntercept),
+    shuffleBlockSize(1)
 {
   // Initialize the parameters to suitable values.
   initialPoint = InitializeWeights();
@@ -42,37 +45,35 @@ inline SoftmaxRegressionFunction::SoftmaxRegressionFunction(
  */
 inline void SoftmaxRegressionFunction::Shuffle()
 {
-  // Determine new ordering.
-  arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
-      data.n_cols - 1, data.n_cols));
-
-  // Re-sort data.
-  arma::mat newData = data.cols(ordering);
-  if (data.mem_state >= 1)
-    data.reset();
-  data = std::move(newData);
-
-  // Assemble data for batch constructor.  We need reverse orderings though...
-  arma::uvec reverseOrdering(ordering.n_elem);
-  for (size_t i = 0; i < ordering.n_elem; ++i)
-    reverseOrdering[ordering[i]] = i;
-
-  arma::umat newLocations(2, groundTruth.n_nonzero);
-  arma::vec values(groundTruth.n_nonzero);
-  arma::sp_mat::const_iterator it = groundTruth.begin();
-  size_t loc = 0;
-  while (it != groundTruth.end())
+  ShuffleVisitationOrder(data.n_cols, shuffleBlockSize, visitationOrder);
+}
+
+/**
+ * Get the data points and the ground truth of a batch.
+ */
+inline void SoftmaxRegressionFunction::GetBatch(
+    const size_t start,
+    const size_t batchSize,
+    arma::mat& batchData,
+    arma::sp_mat& batchGroundTruth) const
+{
+  if (IsContiguousBatch(visitationOrder, start, batchSize))
   {
-    newLocations(0, loc) = reverseOrdering(it.col());
-    newLocations(1, loc) = it.row();
-    values(loc) = (*it);
+    const size_t first = visitationOrder.is_empty() ? start :
+        visitationOrder[start];
 
-    ++it;
-    ++loc;
+    // We promise to be well-behaved... the elements won't be modified.
+    batchData = arma::mat(const_cast<double*>(data.colptr(first)), data.n_rows,
+        batchSize, false, false);
+    batchGroundTruth = groundTruth.cols(first, first + batchSize - 1);
+  }
+  else
+  {
+    const arma::uvec indices = visitationOrder.subvec(start,
+        start + batchSize - 1);
+    batchData = data.cols(indices);
+    GetGroundTruthMatrix(labels.cols(indices), batchGroundTruth);
   }
-
-  groundTruth = arma::sp_mat(newLocations, values, groundTruth.n_rows,
-      groundTruth.n_cols);
 }
 
 /**
@@ -117,7 +118,7 @@ inline void SoftmaxRegressionFunction::InitializeWeights(
  * calculations in the Evaluate() and Gradient() methods.
  */
 inline void SoftmaxRegressionFunction::GetGroundTruthMatrix(
-    const arma::Row<size_t>& labels, arma::sp_mat& groundTruth)
+    const arma::Row<size_t>& labels, arma::sp_mat& groundTruth) const
 {
   // Calculate the ground truth matrix according to the labels passed. The
   // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
@@ -154,6 +155,20 @@ inline void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
     arma::mat& probabilities,
     const size_t start,
     const size_t batchSize) const
+{
+  arma::mat batchData;
+  arma::sp_mat batchGroundTruth;
+  GetBatch(start, batchSize, batchData, batchGroundTruth);
+  GetBatchProbabilities(parameters, batchData, probabilities);
+}
+
+/**
+ * Evaluate the probabilities matrix of the given data points.
+ */
+inline void SoftmaxRegressionFunction::GetBatchProbabilities(
+    const arma::mat& parameters,
+    const arma::mat& batchData,
+    arma::mat& probabilities) const
 {
   arma::mat hypothesis;
 
@@ -166,14 +181,12 @@ inline void SoftmaxRegressionFunction::GetProbabilitiesMatrix(
     // Since the cost of join may be high due to the copy of original data,
     // split the hypothesis computation to two components.
     hypothesis = arma::exp(
-        arma::repmat(parameters.col(0), 1, batchSize) +
-        parameters.cols(1, parameters.n_cols - 1) *
-        data.cols(start, start + batchSize - 1));
+        arma::repmat(parameters.col(0), 1, batchData.n_cols) +
+        parameters.cols(1, parameters.n_cols - 1) * batchData);
   }
   else
   {
-    hypothesis = arma::exp(parameters *
-        data.cols(start, start + batchSize - 1));
+    hypothesis = arma::exp(parameters * batchData);
   }
 
   probabilities = hypothesis / arma::repmat(arma::sum(hypothesis, 0),
@@ -203,7 +216,7 @@ inline double SoftmaxRegressionFunction::Evaluate(
   // x_i is the input vector for a particular training example.
   // theta_j is the parameter vector associated with a particular class.
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+  GetBatchProbabilities(parameters, data, probabilities);
 
   // Calculate the log likelihood and regularization terms.
   double logLikelihood, weightDecay, cost;
@@ -227,14 +240,18 @@ inline double SoftmaxRegressionFunction::Evaluate(
     const size_t start,
     const size_t batchSize) const
 {
+  arma::mat batchData;
+  arma::sp_mat batchGroundTruth;
+  GetBatch(start, batchSize, batchData, batchGroundTruth);
+
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  GetBatchProbabilities(parameters, batchData, probabilities);
 
   // Calculate the log likelihood and regularization terms.
   double logLikelihood, weightDecay;
 
-  logLikelihood = arma::accu(groundTruth.cols(start, start + batchSize - 1) %
-      arma::log(probabilities)) / batchSize;
+  logLikelihood = arma::accu(batchGroundTruth % arma::log(probabilities)) /
+      batchSize;
   weightDecay = 0.5 * lambda * arma::accu(parameters * parameters);
 
   return -logLikelihood + weightDecay;
@@ -253,7 +270,7 @@ inline void SoftmaxRegressionFunction::Gradient(
   // x_i is the input vector for a particular training example.
   // theta_j is the parameter vector associated with a particular class.
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+  GetBatchProbabilities(parameters, data, probabilities);
 
   // Calculate the parameter gradients.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
@@ -282,26 +299,28 @@ inline void SoftmaxRegressionFunction::Gradient(
     arma::mat& gradient,
     const size_t batchSize) const
 {
+  arma::mat batchData;
+  arma::sp_mat batchGroundTruth;
+  GetBatch(start, batchSize, batchData, batchGroundTruth);
+
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
+  GetBatchProbabilities(parameters, batchData, probabilities);
 
   // Calculate the parameter gradients.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
   if (fitIntercept)
   {
-    arma::mat inner = probabilities - groundTruth.cols(start, start +
-        batchSize - 1);
+    arma::mat inner = probabilities - batchGroundTruth;
     gradient.col(0) =
         inner * arma::ones<arma::mat>(batchSize, 1) / batchSize +
         lambda * parameters.col(0);
     gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.cols(start, start + batchSize - 1).t() / batchSize +
+        inner * batchData.t() / batchSize +
         lambda * parameters.cols(1, parameters.n_cols - 1);
   }
   else
   {
-    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
-        * data.cols(start, start + batchSize - 1).t() / batchSize
+    gradient = (probabilities - batchGroundTruth) * batchData.t() / batchSize
         + lambda * parameters;
   }
 }
@@ -314,7 +333,7 @@ inline void SoftmaxRegressionFunction::PartialGradient(
   gradient.zeros(arma::size(parameters));
 
   arma::mat probabilities;
-  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+  GetBatchProbabilities(parameters, data, probabilities);
 
   // Calculate the required part of the gradient.
   arma::mat inner = probabilities - groundTruth;
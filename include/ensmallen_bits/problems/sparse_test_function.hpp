@@ -35,6 +35,9 @@ class SparseTestFunction
   //! Get the starting point.
   arma::mat GetInitialPoint() const { return arma::mat("0 0 0 0;"); }
 
+  //! Shuffle the order of function visitation.
+  void Shuffle();
+
   //! Evaluate a function.
   double Evaluate(const arma::mat& coordinates,
                   const size_t i,
@@ -63,6 +66,9 @@ class SparseTestFunction
 
   //! The vector having coefficients of the first order term
   arma::vec bi;
+
+  //! The order in which the functions are visited.
+  arma::uvec visitationOrder;
 };
 
 } // namespace test
@@ -22,6 +22,15 @@ inline SparseTestFunction::SparseTestFunction()
 {
   intercepts = arma::vec("20 12 15 100");
   bi = arma::vec("-4 -2 -3 -8");
+  visitationOrder = arma::linspace<arma::uvec>(0, NumFunctions() - 1,
+      NumFunctions());
+}
+
+//! Shuffle the order of function visitation.
+inline void SparseTestFunction::Shuffle()
+{
+  visitationOrder = arma::shuffle(arma::linspace<arma::uvec>(0,
+      NumFunctions() - 1, NumFunctions()));
 }
 
 //! Evaluate a function.
@@ -33,8 +42,9 @@ inline double SparseTestFunction::Evaluate(
   double result = 0.0;
   for (size_t j = i; j < i + batchSize; ++j)
   {
-    result += coordinates[j] * coordinates[j] + bi[j] * coordinates[j] +
-        intercepts[j];
+    const size_t k = visitationOrder[j];
+    result += coordinates[k] * coordinates[k] + bi[k] * coordinates[k] +
+        intercepts[k];
   }
 
   return result;
@@ -61,7 +71,10 @@ inline void SparseTestFunction::Gradient(const arma::mat& coordinates,
 {
   gradient.zeros(arma::size(coordinates));
   for (size_t j = i; j < i + batchSize; ++j)
-    gradient[j] = 2 * coordinates[j] + bi[j];
+  {
+    const size_t k = visitationOrder[j];
+    gradient[k] = 2 * coordinates[k] + bi[k];
+  }
 }
 
 //! Evaluate the gradient of a feature function.
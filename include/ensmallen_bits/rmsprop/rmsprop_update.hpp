@@ -57,34 +57,52 @@ class RMSPropUpdate
   }
 
   /**
-   * The Initialize method is called by SGD Optimizer method before the start of
-   * the iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Initialize(const size_t rows, const size_t cols)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    // Leaky sum of squares of parameter gradient.
-    meanSquaredGradient = arma::zeros<arma::mat>(rows, cols);
-  }
+   public:
+    /**
+     * This is called by the optimizer before the start of the iteration update
+     * process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const RMSPropUpdate& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        meanSquaredGradient(arma::zeros<MatType>(rows, cols))
+    { /* Do nothing. */ }
 
-  /**
-   * Update step for RMSProp.
-   *
-   * @param iterate Parameters that minimize the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
-   */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
-  {
-    meanSquaredGradient *= alpha;
-    meanSquaredGradient += (1 - alpha) * (gradient % gradient);
-    iterate -= stepSize * gradient / (arma::sqrt(meanSquaredGradient) +
-        epsilon);
-  }
+    /**
+     * Update step for RMSProp.
+     *
+     * @param iterate Parameters that minimize the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      meanSquaredGradient *= parent.alpha;
+      meanSquaredGradient += (1 - parent.alpha) * (gradient % gradient);
+      iterate -= stepSize * gradient / (arma::sqrt(meanSquaredGradient) +
+          parent.epsilon);
+    }
+
+   private:
+    //! Instantiated parent object.
+    const RMSPropUpdate& parent;
+
+    // Leaky sum of squares of parameter gradient.
+    MatType meanSquaredGradient;
+  };
 
   //! Get the value used to initialise the squared gradient parameter.
   double Epsilon() const { return epsilon; }
@@ -102,9 +120,84 @@ class RMSPropUpdate
 
   // The smoothing parameter.
   double alpha;
+};
+
+/**
+ * Lazy RMSProp update for sparse gradients (GradType = arma::SpMat<>).  Only
+ * the coordinates with a nonzero gradient in the current batch are touched, so
+ * each step costs O(nnz(gradient)) instead of O(rows * cols).  The decay of the
+ * mean squared gradient that a coordinate missed while its gradient was zero
+ * is applied when the coordinate is next touched; since the dense update does
+ * not move a coordinate with zero gradient, the result is identical to the
+ * dense update.
+ */
+template<typename MatType, typename eT>
+class RMSPropUpdate::Policy<MatType, arma::SpMat<eT>>
+{
+ public:
+  /**
+   * This is called by the optimizer before the start of the iteration update
+   * process.
+   *
+   * @param parent Instantiated parent class.
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  Policy(const RMSPropUpdate& parent, const size_t rows, const size_t cols) :
+      parent(parent),
+      meanSquaredGradient(arma::zeros<MatType>(rows, cols)),
+      lastIteration(rows, cols, arma::fill::zeros),
+      iteration(0)
+  { /* Do nothing. */ }
+
+  /**
+   * Lazy update step for RMSProp.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The sparse gradient matrix.
+   */
+  void Update(MatType& iterate,
+              const double stepSize,
+              const arma::SpMat<eT>& gradient)
+  {
+    ++iteration;
+
+    typename arma::SpMat<eT>::const_iterator it = gradient.begin();
+    for ( ; it != gradient.end(); ++it)
+    {
+      const size_t row = it.row();
+      const size_t col = it.col();
+      const double g = (*it);
+
+      // Catch up on the decay from the iterations this coordinate skipped.
+      const size_t skipped = iteration - lastIteration(row, col) - 1;
+      if (skipped > 0)
+      {
+        meanSquaredGradient(row, col) *= std::pow(parent.alpha,
+            (double) skipped);
+      }
+      lastIteration(row, col) = iteration;
+
+      meanSquaredGradient(row, col) = parent.alpha *
+          meanSquaredGradient(row, col) + (1 - parent.alpha) * g * g;
+      iterate(row, col) -= stepSize * g /
+          (std::sqrt(meanSquaredGradient(row, col)) + parent.epsilon);
+    }
+  }
+
+ private:
+  //! Instantiated parent object.
+  const RMSPropUpdate& parent;
 
   // Leaky sum of squares of parameter gradient.
-  arma::mat meanSquaredGradient;
+  MatType meanSquaredGradient;
+
+  // The iteration at which each coordinate was last updated.
+  arma::Mat<size_t> lastIteration;
+
+  // The number of iterations.
+  size_t iteration;
 };
 
 } // namespace ens
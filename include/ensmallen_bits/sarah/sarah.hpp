@@ -83,6 +83,9 @@ class SARAHType
    *     function is visited in linear order.
    * @param updatePolicy Instantiated update policy used to adjust the given
    *     parameters.
+   * @param numThreads Number of parts the full gradient pass is split into
+   *     for thread-parallel evaluation (1 means no parallelism, 0 means one
+   *     part per OpenMP thread).  See NumThreads().
    */
   SARAHType(const double stepSize = 0.01,
             const size_t batchSize = 32,
@@ -90,7 +93,8 @@ class SARAHType
             const size_t innerIterations = 0,
             const double tolerance = 1e-5,
             const bool shuffle = true,
-            const UpdatePolicyType& updatePolicy = UpdatePolicyType());
+            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
+            const size_t numThreads = 1);
 
   /**
    * Optimize the given function using SARAH. The given starting point will be
@@ -135,6 +139,18 @@ class SARAHType
   //! Modify whether or not the individual functions are shuffled.
   bool& Shuffle() { return shuffle; }
 
+  /**
+   * Get the number of parts the full objective and gradient pass of each outer
+   * iteration is split into.  If it is not 1, the batches are evaluated in
+   * that many parallel ranges (or one per OpenMP thread if it is 0), so the
+   * EvaluateWithGradient() method of the function must be safe to call
+   * concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the full objective and gradient pass is split
+  //! into.
+  size_t& NumThreads() { return numThreads; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -162,6 +178,9 @@ class SARAHType
 
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
+
+  //! The number of parts the full gradient pass is split into.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
@@ -16,6 +16,7 @@
 #include "sarah.hpp"
 
 #include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/utility/full_evaluate_with_gradient.hpp>
 
 namespace ens {
 
@@ -27,14 +28,16 @@ SARAHType<UpdatePolicyType>::SARAHType(
     const size_t innerIterations,
     const double tolerance,
     const bool shuffle,
-    const UpdatePolicyType& updatePolicy) :
+    const UpdatePolicyType& updatePolicy,
+    const size_t numThreads) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
     innerIterations(innerIterations),
     tolerance(tolerance),
     shuffle(shuffle),
-    updatePolicy(updatePolicy)
+    updatePolicy(updatePolicy),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
@@ -71,13 +74,10 @@ double SARAHType<UpdatePolicyType>::Optimize(
       std::numeric_limits<size_t>::max() : maxIterations;
   for (size_t i = 0; i < actualMaxIterations; ++i)
   {
-    // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
-    {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
-    }
+    // Calculate the objective function and the full gradient in a single
+    // pass over the data.
+    overallObjective = FullEvaluateWithGradient(function, iterate, v,
+        batchSize, numThreads);
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
     {
@@ -96,20 +96,6 @@ double SARAHType<UpdatePolicyType>::Optimize(
 
     lastObjective = overallObjective;
 
-    // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    function.Gradient(iterate, 0, v, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
-
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      v += gradient;
-
-      f += effectiveBatchSize;
-    }
     v /= (double) numFunctions;
 
     // Update iterate with full gradient (v).
@@ -131,7 +117,8 @@ double SARAHType<UpdatePolicyType>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
 
       // Calculate variance reduced gradient.
       function.Gradient(iterate, currentFunction, gradient,
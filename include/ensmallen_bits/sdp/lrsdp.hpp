@@ -38,11 +38,15 @@ class LRSDP
    * @param numDenseConstraints Number of dense constraints in the problem.
    * @param initialPoint Initial point of the optimization.
    * @param maxIterations Maximum number of iterations.
+   * @param numThreads Number of parts the constraints are split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).
    */
   LRSDP(const size_t numSparseConstraints,
         const size_t numDenseConstraints,
         const arma::mat& initialPoint,
-        const size_t maxIterations = 1000);
+        const size_t maxIterations = 1000,
+        const size_t numThreads = 1);
 
   /**
    * Create an LRSDP object with the given SDP problem to be solved, and the
@@ -88,6 +92,11 @@ class LRSDP
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of parts the constraints are split into.
+  size_t NumThreads() const { return function.NumThreads(); }
+  //! Modify the number of parts the constraints are split into.
+  size_t& NumThreads() { return function.NumThreads(); }
+
  private:
   //! Augmented lagrangian optimizer.
   AugLagrangian augLag;
@@ -21,14 +21,16 @@ namespace ens {
 /**
  * The objective function that LRSDP is trying to optimize.
  *
- * Note: LRSDPfunction is designed and implemented to specifically work
- * with a combination of AugLagrangian and L-BFGS optimizer. Implemenation
- * of LRSDPFunction includes caching R * R^T matrix in order to avoid redundant
- * computations(Specifically with above two optimizers) of R * R^T matrix
- * through AugLagrangian optimizer call, as only L-BFGS takes part in updating
- * R(coordinates) matrix. So, be careful while using LRSDP with some other
- * optimizer. You may need to modify caching process of R * R^T matrix.
- * See EvaluateImpl() in lrsdp_function_impl.hpp for more details.
+ * The objective and the constraints are evaluated from the n x r factor R
+ * without forming R * R^T: Tr(A * (R R^T)) is the sum over the nonzeros A_ij
+ * of A_ij <R_i, R_j> for a sparse A, and Tr(R^T * A * R) for a dense A.  So
+ * the memory is O(n r) plus the problem data, and sparse constraints take
+ * O(nnz(A) r) time.  See EvaluateImpl() in lrsdp_function_impl.hpp for more
+ * details.
+ *
+ * The constraints of the augmented Lagrangian can be evaluated in parallel
+ * with OpenMP: set NumThreads() to split them into that many contiguous
+ * ranges, each of which accumulates its own part of the gradient.
  */
 template <typename SDPType>
 class LRSDPFunction
@@ -39,9 +41,13 @@ class LRSDPFunction
    *
    * @param sdp
    * @param initialPoint
+   * @param numThreads Number of parts the constraints are split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).
    */
   LRSDPFunction(const SDPType& sdp,
-                const arma::mat& initialPoint);
+                const arma::mat& initialPoint,
+                const size_t numThreads = 1);
 
   /**
    * Construct the LRSDPFunction with the given initial point and number of
@@ -53,10 +59,14 @@ class LRSDPFunction
    * @param numSparseConstraints
    * @param numDenseConstraints
    * @param initialPoint
+   * @param numThreads Number of parts the constraints are split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).
    */
   LRSDPFunction(const size_t numSparseConstraints,
                 const size_t numDenseConstraints,
-                const arma::mat& initialPoint);
+                const arma::mat& initialPoint,
+                const size_t numThreads = 1);
 
   /**
    * Evaluate the objective function of the LRSDP (no constraints) at the given
@@ -95,11 +105,10 @@ class LRSDPFunction
   //! Modify the SDP object representing the problem.
   SDPType& SDP() { return sdp; }
 
-  //! Get R*R^T matrix.
-  const arma::mat& RRT() const { return rrt; }
-
-  //! Modify R*R^T matrix.
-  arma::mat& RRT()  { return rrt; }
+  //! Get the number of parts the constraints are split into.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the constraints are split into.
+  size_t& NumThreads() { return numThreads; }
 
  private:
   //! SDP object representing the problem
@@ -108,8 +117,8 @@ class LRSDPFunction
   //! Initial point.
   arma::mat initialPoint;
 
-  //! Cache R*R^T matrix.
-  arma::mat rrt;
+  //! The number of parts the constraints are split into.
+  size_t numThreads;
 };
 
 // Declare specializations in lrsdp_function.cpp.
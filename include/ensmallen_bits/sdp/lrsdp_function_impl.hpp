@@ -20,9 +20,11 @@ namespace ens {
 
 template <typename SDPType>
 LRSDPFunction<SDPType>::LRSDPFunction(const SDPType& sdp,
-                                      const arma::mat& initialPoint):
+                                      const arma::mat& initialPoint,
+                                      const size_t numThreads):
     sdp(sdp),
-    initialPoint(initialPoint)
+    initialPoint(initialPoint),
+    numThreads(numThreads)
 {
   if (initialPoint.n_rows < initialPoint.n_cols)
   {
@@ -30,17 +32,16 @@ LRSDPFunction<SDPType>::LRSDPFunction(const SDPType& sdp,
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
   }
-
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
 }
 
 template <typename SDPType>
 LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
                                       const size_t numDenseConstraints,
-                                      const arma::mat& initialPoint):
+                                      const arma::mat& initialPoint,
+                                      const size_t numThreads):
     sdp(initialPoint.n_rows, numSparseConstraints, numDenseConstraints),
-    initialPoint(initialPoint)
+    initialPoint(initialPoint),
+    numThreads(numThreads)
 {
   if (initialPoint.n_rows < initialPoint.n_cols)
   {
@@ -48,19 +49,13 @@ LRSDPFunction<SDPType>::LRSDPFunction(const size_t numSparseConstraints,
         << "more columns than rows.  It may be more efficient to find the "
         << "transposed solution." << std::endl;
   }
-
-  // Initialize R*R^T matrix.
-  rrt = initialPoint * trans(initialPoint);
 }
 
 template <typename SDPType>
-double LRSDPFunction<SDPType>::Evaluate(const arma::mat& /* coordinates */)
-                                        const
+double LRSDPFunction<SDPType>::Evaluate(const arma::mat& coordinates) const
 {
-  // Note: We don't require to update the R*R^T matrix here as the current
-  // function is only used by AugLagrangian, which do not update the coordinates
-  // matrix.
-  return accu(SDP().C() % rrt);
+  // Tr(C * (R R^T)) = Tr(R^T * C * R), without forming R R^T.
+  return accu(coordinates % (SDP().C() * coordinates));
 }
 
 template <typename SDPType>
@@ -76,13 +71,20 @@ double LRSDPFunction<SDPType>::EvaluateConstraint(
     const size_t index,
     const arma::mat& coordinates) const
 {
-  // Note: We don't require to update the R*R^T matrix here as the current
-  // function is only used by AugLagrangian, which do not update the coordinates
-  // matrix.
-
-  // Using cached R*R^T gives better optimization for sparse matrices.
+  // For a sparse A, Tr(A * (R R^T)) is the sum over the nonzeros A_ij of
+  // A_ij <R_i, R_j>, where R_i is row i of R.
   if (index < SDP().NumSparseConstraints())
-    return accu(SDP().SparseA()[index] % rrt) - SDP().SparseB()[index];
+  {
+    double result = 0.0;
+    arma::sp_mat::const_iterator it = SDP().SparseA()[index].begin();
+    for ( ; it != SDP().SparseA()[index].end(); ++it)
+    {
+      result += (*it) * arma::dot(coordinates.row(it.row()),
+          coordinates.row(it.col()));
+    }
+
+    return result - SDP().SparseB()[index];
+  }
   const size_t index1 = index - SDP().NumSparseConstraints();
 
   // For computation optimization we will be taking R^T * A first.
@@ -100,67 +102,149 @@ void LRSDPFunction<SDPType>::GradientConstraint(
          "for arbitrary optimizers!");
 }
 
-//! Utility function for updating R*R^T matrix.
-//! Note: Caching R*R^T provide significant computation optimization
-//! by reducing redundant R*R^T calculations in case of functions are not used
-//! updating coordinates matrix, hence leaving R*R^T unchanged.
-template <typename SDPType>
-void UpdateRRT(LRSDPFunction<SDPType>& function,
-               const arma::mat& newrrt)
+//! Utility function for calculating Tr(A * (R R^T)) of a sparse A from
+//! R^T, as the sum over the nonzeros A_ij of A_ij <R_i, R_j>.  The rows of R
+//! are the (contiguous) columns of R^T.
+static inline double LowRankTrace(const arma::sp_mat& a, const arma::mat& rt)
+{
+  double result = 0.0;
+  arma::sp_mat::const_iterator it = a.begin();
+  for ( ; it != a.end(); ++it)
+  {
+    result += (*it) * arma::dot(rt.unsafe_col(it.row()),
+        rt.unsafe_col(it.col()));
+  }
+
+  return result;
+}
+
+//! Utility function for calculating Tr(A * (R R^T)) = Tr(R^T * A * R) of a
+//! dense A from R^T.
+static inline double LowRankTrace(const arma::mat& a, const arma::mat& rt)
+{
+  return accu((rt * a) % rt);
+}
+
+//! Utility function for adding coefficient * (A * R)^T to the matrix g of the
+//! size of R^T, for a sparse A, in one pass over the nonzeros of A.
+static inline void AddLowRankProduct(arma::mat& g,
+                                     const arma::sp_mat& a,
+                                     const arma::mat& rt,
+                                     const double coefficient)
+{
+  arma::sp_mat::const_iterator it = a.begin();
+  for ( ; it != a.end(); ++it)
+    g.unsafe_col(it.row()) += (coefficient * (*it)) * rt.unsafe_col(it.col());
+}
+
+//! Utility function for adding coefficient * (A * R)^T to the matrix g of the
+//! size of R^T, for a dense A.
+static inline void AddLowRankProduct(arma::mat& g,
+                                     const arma::mat& a,
+                                     const arma::mat& rt,
+                                     const double coefficient)
 {
-  function.RRT() = newrrt;
+  g += coefficient * (rt * trans(a));
+}
+
+//! Utility function for finding the number of parts the constraints are
+//! split into for thread-parallel evaluation (numThreads == 0 means one part
+//! per OpenMP thread).
+static inline size_t ConstraintParts(const size_t numThreads,
+                                     const size_t numConstraints)
+{
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  return std::max(std::min(numParts, numConstraints), size_t(1));
 }
 
 //! Utility function for calculating part of the objective when AugLagrangian is
-//! used with an LRSDPFunction.
+//! used with an LRSDPFunction.  The constraints are split into numThreads
+//! contiguous ranges, which are evaluated in parallel and summed in order.
 template <typename MatrixType>
 static inline void
 UpdateObjective(double& objective,
-                const arma::mat& rrt,
+                const arma::mat& rt,
                 const std::vector<MatrixType>& ais,
                 const arma::vec& bis,
                 const arma::vec& lambda,
                 const size_t lambdaOffset,
-                const double sigma)
+                const double sigma,
+                const size_t numThreads)
 {
-  for (size_t i = 0; i < ais.size(); ++i)
+  const size_t numParts = ConstraintParts(numThreads, ais.size());
+  std::vector<double> partObjectives(numParts, 0.0);
+
+  // The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
   {
-    // Take the trace subtracted by the b_i.
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    objective -= (lambda[lambdaOffset + i] * constraint);
-    objective += (sigma / 2.) * constraint * constraint;
+    const size_t partBegin = (size_t(p) * ais.size()) / numParts;
+    const size_t partEnd = ((size_t(p) + 1) * ais.size()) / numParts;
+    for (size_t i = partBegin; i < partEnd; ++i)
+    {
+      // Take the trace subtracted by the b_i.
+      const double constraint = LowRankTrace(ais[i], rt) - bis[i];
+      partObjectives[p] -= (lambda[lambdaOffset + i] * constraint);
+      partObjectives[p] += (sigma / 2.) * constraint * constraint;
+    }
   }
+
+  // Reduce in a fixed order, so that the result is deterministic.
+  for (size_t p = 0; p < numParts; ++p)
+    objective += partObjectives[p];
 }
 
 //! Utility function for calculating part of the gradient when AugLagrangian is
-//! used with an LRSDPFunction.
+//! used with an LRSDPFunction.  The gradient is accumulated transposed, in the
+//! shape of R^T.  The constraints are split into numThreads contiguous ranges;
+//! each range is accumulated into its own r x n matrix in parallel, and these
+//! are summed in order.
 template <typename MatrixType>
 static inline void
-UpdateGradient(arma::mat& s,
-               const arma::mat& rrt,
+UpdateGradient(arma::mat& g,
+               const arma::mat& rt,
                const std::vector<MatrixType>& ais,
                const arma::vec& bis,
                const arma::vec& lambda,
                const size_t lambdaOffset,
-               const double sigma)
+               const double sigma,
+               const size_t numThreads)
 {
-  for (size_t i = 0; i < ais.size(); ++i)
+  const size_t numParts = ConstraintParts(numThreads, ais.size());
+
+  // The first range is accumulated into the output directly.
+  std::vector<arma::mat> partGradients(numParts - 1);
+
+  // The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
   {
-    // Here taking R^T * A first is not recommended as we are already
-    // using pre-computed R * R^T. Taking R^T * A first will result in increase
-    // in number of computations.
-    const double constraint = accu(ais[i] % rrt) - bis[i];
-    const double y = lambda[lambdaOffset + i] - sigma * constraint;
-    s -= y * ais[i];
+    arma::mat& partGradient = (p == 0) ? g : partGradients[p - 1];
+    if (p > 0)
+      partGradient.zeros(g.n_rows, g.n_cols);
+
+    const size_t partBegin = (size_t(p) * ais.size()) / numParts;
+    const size_t partEnd = ((size_t(p) + 1) * ais.size()) / numParts;
+    for (size_t i = partBegin; i < partEnd; ++i)
+    {
+      const double constraint = LowRankTrace(ais[i], rt) - bis[i];
+      const double y = lambda[lambdaOffset + i] - sigma * constraint;
+      AddLowRankProduct(partGradient, ais[i], rt, -y);
+    }
   }
+
+  // Reduce in a fixed order, so that the result is deterministic.
+  for (size_t p = 1; p < numParts; ++p)
+    g += partGradients[p - 1];
 }
 
 template <typename SDPType>
 static inline double
-EvaluateImpl(LRSDPFunction<SDPType>& function,
+EvaluateImpl(const LRSDPFunction<SDPType>& function,
              const arma::mat& coordinates,
              const arma::vec& lambda,
              const double sigma)
@@ -169,44 +253,21 @@ EvaluateImpl(LRSDPFunction<SDPType>& function,
   // L(R, y, s) = Tr(C * (R R^T)) -
   //     sum_{i = 1}^{m} (y_i (Tr(A_i * (R R^T)) - b_i)) +
   //     (sigma / 2) * sum_{i = 1}^{m} (Tr(A_i * (R R^T)) - b_i)^2
-
-  // Let's start with the objective: Tr(C * (R R^T)).
-  // Simple, possibly slow solution-- see below for optimization opportunity
-  //
-  // Note that Tr(C^T * (R R^T)) = Tr( (CR)^T * R ), so
-  // multiplying C * R first, and then taking the trace dot should be more
-  // memory efficient.
   //
-  // Similarly for the constraints, taking R^T * A first should be
-  // more efficient.
-  //
-  // For computation optimization we will be taking R^T * C first.
-  // Objective function = Tr((R^T * C) * R)
-
-  // Calculate R*R^T for updating cache.
-  const arma::mat rrt = coordinates * trans(coordinates);
+  // R R^T is never formed: Tr(A * (R R^T)) is computed from R directly, in
+  // O(nnz(A) r) time for a sparse A and as Tr(R^T * A * R) for a dense A, so
+  // that the memory stays O(n r).  The traces are computed from R^T, whose
+  // columns are the rows of R.
+  const arma::mat rt = trans(coordinates);
 
-  // Update R*R^T matrix.
-  // Note that we can only use this optimization in case of L-BFGS optimizer
-  // or any other similar optimizer which calls Evaluate() before Gradient()
-  // with same coordinates matrix and uses only Evaluate() to update
-  // coordinates matrix.
-
-  // Note: In case optimizer also uses Gradient() for updating coordinates
-  // matrix than the same line of code can be used to update R*R^T through
-  // Gradient().
-  UpdateRRT(function, rrt);
-
-  // Optimized objective function.
-  double objective = trace((trans(coordinates) * function.SDP().C())
-                         * coordinates);
+  double objective = LowRankTrace(function.SDP().C(), rt);
 
   // Now each constraint.
-  UpdateObjective(objective, rrt, function.SDP().SparseA(),
-      function.SDP().SparseB(), lambda, 0, sigma);
-  UpdateObjective(objective, rrt, function.SDP().DenseA(),
+  UpdateObjective(objective, rt, function.SDP().SparseA(),
+      function.SDP().SparseB(), lambda, 0, sigma, function.NumThreads());
+  UpdateObjective(objective, rt, function.SDP().DenseA(),
       function.SDP().DenseB(), lambda, function.SDP().NumSparseConstraints(),
-      sigma);
+      sigma, function.NumThreads());
 
   return objective;
 }
@@ -224,19 +285,22 @@ GradientImpl(const LRSDPFunction<SDPType>& function,
   //   with
   // S' = C - sum_{i = 1}^{m} y'_i A_i
   // y'_i = y_i - sigma * (Trace(A_i * (R R^T)) - b_i)
+  //
+  // S' is never formed either: S' * R = C * R - sum_{i = 1}^{m} y'_i A_i * R
+  // is accumulated (transposed) one constraint at a time.
+  const arma::mat rt = trans(coordinates);
+  arma::mat g(rt.n_rows, rt.n_cols, arma::fill::zeros);
 
-  // Directly reterive R*R^T from cache.
-  const arma::mat rrt = function.RRT();
-  arma::mat s(function.SDP().C());
-
+  AddLowRankProduct(g, function.SDP().C(), rt, 1.0);
   UpdateGradient(
-      s, rrt, function.SDP().SparseA(), function.SDP().SparseB(),
-      lambda, 0, sigma);
+      g, rt, function.SDP().SparseA(), function.SDP().SparseB(),
+      lambda, 0, sigma, function.NumThreads());
   UpdateGradient(
-      s, rrt, function.SDP().DenseA(), function.SDP().DenseB(),
-      lambda, function.SDP().NumSparseConstraints(), sigma);
+      g, rt, function.SDP().DenseA(), function.SDP().DenseB(),
+      lambda, function.SDP().NumSparseConstraints(), sigma,
+      function.NumThreads());
 
-  gradient = 2 * s * coordinates;
+  gradient = 2 * trans(g);
 }
 
 // Template specializations for function and gradient evaluation.
@@ -21,8 +21,10 @@ template <typename SDPType>
 LRSDP<SDPType>::LRSDP(const size_t numSparseConstraints,
                       const size_t numDenseConstraints,
                       const arma::mat& initialPoint,
-                      const size_t maxIterations) :
-    function(numSparseConstraints, numDenseConstraints, initialPoint),
+                      const size_t maxIterations,
+                      const size_t numThreads) :
+    function(numSparseConstraints, numDenseConstraints, initialPoint,
+        numThreads),
     maxIterations(maxIterations)
 { }
 
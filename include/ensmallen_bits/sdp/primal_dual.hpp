@@ -93,6 +93,11 @@ class PrimalDualSolver
   //! Modify the maximum number of iterations to run before converging.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Modify the number of parts the constraints are split into for
+  //! thread-parallel evaluation (1 means no parallelism, 0 means one part per
+  //! OpenMP thread).
+  size_t& NumThreads() { return numThreads; }
+
  private:
   //! The SDP problem instance to optimize.
   SDPType sdp;
@@ -125,6 +130,9 @@ class PrimalDualSolver
 
   //! Maximum number of iterations to run. Set to 0 for no limit.
   size_t maxIterations;
+
+  //! The number of parts the constraints are split into.
+  size_t numThreads;
 };
 
 } // namespace ens
@@ -45,7 +45,8 @@ PrimalDualSolver<SDPType>::PrimalDualSolver(const SDPType& sdp)
     normXzTol(1e-7),
     primalInfeasTol(1e-7),
     dualInfeasTol(1e-7),
-    maxIterations(1000)
+    maxIterations(1000),
+    numThreads(1)
 { /* Nothing to do. */ }
 
 template <typename SDPType>
@@ -63,7 +64,8 @@ PrimalDualSolver<SDPType>::PrimalDualSolver(const SDPType& sdp,
     normXzTol(1e-7),
     primalInfeasTol(1e-7),
     dualInfeasTol(1e-7),
-    maxIterations(1000)
+    maxIterations(1000),
+    numThreads(1)
 {
   arma::mat tmp;
 
@@ -145,19 +147,87 @@ Alpha(const arma::mat& A, const arma::mat& dA, double tau, double& alpha)
 /**
  * Solve the following Lyapunov equation (for X)
  *
- *   AX + XA = H
+ *   ZX + XZ = H
  *
- * where A, H are symmetric matrices.
+ * where Z, H are symmetric matrices, given the eigendecomposition
+ * Z = Q diag(d) Q^T.  In the eigenbasis of Z the equation is diagonal, so
  *
- * TODO(stephentu): Note this method current uses arma's builtin arma::syl
- * method, which is overkill for this situation. See Lemma 7.2 of [AHO98] for
- * how to solve this Lyapunov equation using an eigenvalue decomposition of A.
+ *   X = Q ((Q^T H Q) ./ (d_i + d_j)) Q^T.
  *
+ * See Lemma 7.2 of [AHO98].
+ *
+ * @param X Matrix to store the solution in.
+ * @param zEigvec The eigenvectors Q of Z.
+ * @param zEigvalSums The sums d_i + d_j of the eigenvalues of Z.
+ * @param H The right hand side.
+ */
+static inline void
+SolveLyapunov(arma::mat& X,
+              const arma::mat& zEigvec,
+              const arma::mat& zEigvalSums,
+              const arma::mat& H)
+{
+  X = zEigvec * ((zEigvec.t() * H * zEigvec) / zEigvalSums) * zEigvec.t();
+}
+
+/**
+ * Compute, for a symmetric constraint matrix A,
+ *
+ *     Atilde = Q^T A Q  and  T = Q^T X A Q,
+ *
+ * where Z = Q diag(d) Q^T, given Q^T and Q^T X.  Atilde is only computed if
+ * transformA is true.  For a sparse A with fewer nonzeros than rows, both are
+ * sums of one outer product per nonzero A_jl, which takes O(nnz(A) n^2) time
+ * instead of O(n^3).
+ */
+static inline void
+TransformConstraint(const arma::sp_mat& A,
+                    const arma::mat& zEigvec,
+                    const arma::mat& zEigvecT,
+                    const arma::mat& zEigvecTX,
+                    const bool transformA,
+                    arma::mat& Atilde,
+                    arma::mat& T)
+{
+  const size_t n = A.n_rows;
+  if (A.n_nonzero >= n)
+  {
+    const arma::mat AQ = A * zEigvec;
+    if (transformA)
+      Atilde = zEigvecT * AQ;
+    T = zEigvecTX * AQ;
+    return;
+  }
+
+  if (transformA)
+    Atilde.zeros(n, n);
+  T.zeros(n, n);
+  arma::sp_mat::const_iterator it = A.begin();
+  for ( ; it != A.end(); ++it)
+  {
+    if (transformA)
+      Atilde += (*it) * zEigvecT.col(it.row()) * zEigvecT.col(it.col()).t();
+    T += (*it) * zEigvecTX.col(it.row()) * zEigvecT.col(it.col()).t();
+  }
+}
+
+/**
+ * Compute Atilde = Q^T A Q (if transformA is true) and T = Q^T X A Q for a
+ * dense constraint matrix A.
  */
 static inline void
-SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
+TransformConstraint(const arma::mat& A,
+                    const arma::mat& zEigvec,
+                    const arma::mat& zEigvecT,
+                    const arma::mat& zEigvecTX,
+                    const bool transformA,
+                    arma::mat& Atilde,
+                    arma::mat& T)
 {
-  arma::syl(X, A, A, -H);
+  const arma::mat AQ = A * zEigvec;
+  if (transformA)
+    Atilde = zEigvecT * AQ;
+  T = zEigvecTX * AQ;
 }
 
 /**
@@ -176,11 +246,13 @@ SolveLyapunov(arma::mat& X, const arma::mat& A, const arma::mat& H)
  *     E  = Z sym I
  *     F  = X sym I
  *
+ * and Z = zEigvec diag(d) zEigvec^T; zEigvalSums holds d_i + d_j.
  */
 static inline void
 SolveKKTSystem(const arma::sp_mat& Asparse,
                const arma::mat& Adense,
-               const arma::mat& Z,
+               const arma::mat& zEigvec,
+               const arma::mat& zEigvalSums,
                const arma::mat& M,
                const arma::mat& F,
                const arma::vec& rp,
@@ -200,7 +272,7 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
 
   // Compute the RHS of (2.12)
   math::Smat(F * rd - rc, Frd_rc_Mat);
-  SolveLyapunov(Einv_Frd_rc_Mat, Z, 2. * Frd_rc_Mat);
+  SolveLyapunov(Einv_Frd_rc_Mat, zEigvec, zEigvalSums, 2. * Frd_rc_Mat);
   math::Svec(Einv_Frd_rc_Mat, Einv_Frd_rc);
 
   arma::vec rhs = rp;
@@ -225,7 +297,8 @@ SolveKKTSystem(const arma::sp_mat& Asparse,
   // Compute dx from (2.13)
   math::Smat(F * (rd - Asparse.t() * dysparse - Adense.t() * dydense) - rc,
       Frd_ATdy_rc_Mat);
-  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, Z, 2. * Frd_ATdy_rc_Mat);
+  SolveLyapunov(Einv_Frd_ATdy_rc_Mat, zEigvec, zEigvalSums,
+      2. * Frd_ATdy_rc_Mat);
   math::Svec(Einv_Frd_ATdy_rc_Mat, Einv_Frd_ATdy_rc);
   dsx = -Einv_Frd_ATdy_rc;
 
@@ -291,16 +364,39 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
   math::Svec(X, sx);
   math::Svec(Z, sz);
 
-  arma::vec rp, rd, rc, gk;
+  arma::vec rp, rd, rc, zEigval;
 
-  arma::mat Rc, F, Einv_F_AsparseT, Einv_F_AdenseT, Gk,
-            M, DualCheck;
+  arma::mat Rc, F, zEigvec, zEigvecT, zEigvecTX, zEigvalSums, AtildeT,
+            GtildeT, M, DualCheck;
 
   rp.set_size(sdp.NumConstraints());
 
-  Einv_F_AsparseT.set_size(n2bar, sdp.NumSparseConstraints());
-  Einv_F_AdenseT.set_size(n2bar, sdp.NumDenseConstraints());
-  M.set_size(sdp.NumConstraints(), sdp.NumConstraints());
+  // M = A E^(-1) F A^T is formed either in the eigenbasis of Z, as the
+  // product of the transformed constraints Atilde^T Gtilde, which takes
+  // O(m^2 n^2) time and a second n2bar x m matrix, or in the original basis,
+  // as A G, which takes O(m n^3) time to map every Gtilde back and only
+  // O(nnz(A) m) for the product with the sparse constraints.  Pick the
+  // cheaper one; the second is cheaper when there are many sparse
+  // constraints.
+  const double numConstraints = (double) sdp.NumConstraints();
+  const double eigenbasisCost = (double) n2bar * numConstraints *
+      numConstraints;
+  const double originalBasisCost = (2.0 * std::pow((double) n, 3.0) +
+      (double) Asparse.n_nonzero + (double) n2bar *
+      sdp.NumDenseConstraints()) * numConstraints;
+  const bool inEigenbasis = (eigenbasisCost <= originalBasisCost);
+
+  if (inEigenbasis)
+    AtildeT.set_size(n2bar, sdp.NumConstraints());
+  GtildeT.set_size(n2bar, sdp.NumConstraints());
+
+  // The number of parts the constraints are transformed in.
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, sdp.NumConstraints()), size_t(1));
 
   double primalObj = 0., alpha, beta;
   for (size_t iteration = 1; iteration != maxIterations; iteration++)
@@ -324,54 +420,81 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
 
     math::SymKronId(X, F);
 
-    // We compute E^(-1) F A^T by solving Lyapunov equations.
-    // See (2.16).
-    for (size_t i = 0; i < sdp.NumSparseConstraints(); i++)
-    {
-      SolveLyapunov(Gk, Z, X * sdp.SparseA()[i] + sdp.SparseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AsparseT.col(i) = gk;
-    }
-
-    for (size_t i = 0; i < sdp.NumDenseConstraints(); i++)
+    // All the Lyapunov equations with Z of this iteration are solved in the
+    // eigenbasis of Z, where they are diagonal (Lemma 7.2 of [AHO98]), so Z
+    // is only decomposed once.
+    if (!arma::eig_sym(zEigval, zEigvec, Z))
     {
-      SolveLyapunov(Gk, Z, X * sdp.DenseA()[i] + sdp.DenseA()[i] * X);
-      math::Svec(Gk, gk);
-      Einv_F_AdenseT.col(i) = gk;
+      Warn << "PrimalDualSolver::Optimize(): eigendecomposition of Z "
+          << "failed!  Terminating optimization.";
+      return primalObj;
     }
-
-    // Form the M = A E^(-1) F A^T matrix (2.15)
+    zEigvalSums = arma::repmat(zEigval, 1, n) + arma::repmat(zEigval.t(), n, 1);
+    zEigvecT = zEigvec.t();
+    zEigvecTX = zEigvecT * X;
+
+    // Form the M = A E^(-1) F A^T matrix (2.15).  Its entries are
+    // <A_k, G_i>, where G_i = E^(-1) F A_i^T solves Z G_i + G_i Z =
+    // X A_i + A_i X (see (2.16)).  Since Q is orthogonal, they are also
+    // <Q^T A_k Q, Q^T G_i Q>, and in the eigenbasis
     //
-    // Since we split A up into its sparse and dense components,
-    // we have to handle each block separately.
-    if (sdp.NumSparseConstraints())
+    //   Q^T G_i Q = (T_i + T_i^T) ./ (d_j + d_l),  T_i = Q^T X A_i Q,
+    //
+    // so no Lyapunov equation has to be solved for the constraints.  GtildeT
+    // holds svec(Q^T G_i Q), or svec(G_i) if M is formed in the original
+    // basis.  The constraints are split into numThreads contiguous ranges,
+    // which are transformed in parallel; each one only writes its own
+    // columns.
+    //
+    // The loop variable is signed for OpenMP 2.0 compilers.
+    ENS_PRAGMA_OMP_PARALLEL_FOR
+    for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
     {
-      M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-               arma::span(0, sdp.NumSparseConstraints() - 1)) =
-          Asparse * Einv_F_AsparseT;
-      if (sdp.NumDenseConstraints())
+      arma::mat Atilde, T, Gtilde, G;
+      const size_t partBegin = (size_t(p) * sdp.NumConstraints()) / numParts;
+      const size_t partEnd = ((size_t(p) + 1) * sdp.NumConstraints()) /
+          numParts;
+      for (size_t i = partBegin; i < partEnd; i++)
       {
-        M.submat(arma::span(0, sdp.NumSparseConstraints() - 1),
-                 arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1)) =
-            Asparse * Einv_F_AdenseT;
+        if (i < sdp.NumSparseConstraints())
+        {
+          TransformConstraint(sdp.SparseA()[i], zEigvec, zEigvecT, zEigvecTX,
+              inEigenbasis, Atilde, T);
+        }
+        else
+        {
+          TransformConstraint(sdp.DenseA()[i - sdp.NumSparseConstraints()],
+              zEigvec, zEigvecT, zEigvecTX, inEigenbasis, Atilde, T);
+        }
+
+        arma::vec gtilde(GtildeT.colptr(i), n2bar, false, true);
+        Gtilde = (T + T.t()) / zEigvalSums;
+        if (inEigenbasis)
+        {
+          arma::vec atilde(AtildeT.colptr(i), n2bar, false, true);
+          math::Svec(Atilde, atilde);
+          math::Svec(Gtilde, gtilde);
+        }
+        else
+        {
+          G = zEigvec * Gtilde * zEigvecT;
+          math::Svec(G, gtilde);
+        }
       }
     }
-    if (sdp.NumDenseConstraints())
+
+    if (inEigenbasis)
     {
+      M = AtildeT.t() * GtildeT;
+    }
+    else
+    {
+      M.set_size(sdp.NumConstraints(), sdp.NumConstraints());
       if (sdp.NumSparseConstraints())
-      {
-        M.submat(arma::span(sdp.NumSparseConstraints(),
-                            sdp.NumConstraints() - 1),
-                 arma::span(0,
-                            sdp.NumSparseConstraints() - 1)) =
-            Adense * Einv_F_AsparseT;
-      }
-      M.submat(arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1),
-               arma::span(sdp.NumSparseConstraints(),
-                          sdp.NumConstraints() - 1)) =
-          Adense * Einv_F_AdenseT;
+        M.rows(0, sdp.NumSparseConstraints() - 1) = Asparse * GtildeT;
+      if (sdp.NumDenseConstraints())
+        M.rows(sdp.NumSparseConstraints(), sdp.NumConstraints() - 1) =
+            Adense * GtildeT;
     }
 
     const double sxdotsz = arma::dot(sx, sz);
@@ -383,8 +506,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // This solves step (1) of Section 7, the "predictor" step.
     Rc = -0.5*(X*Z + Z*X);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, zEigvec, zEigvalSums, M, F, rp, rd, rc,
+        dsx, dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
 
@@ -413,8 +536,8 @@ PrimalDualSolver<SDPType>::Optimize(arma::mat& X,
     // Step (3), the "corrector" step.
     Rc = mu*arma::eye<arma::mat>(n, n) - 0.5*(X*Z + Z*X + dX*dZ + dZ*dX);
     math::Svec(Rc, rc);
-    SolveKKTSystem(Asparse, Adense, Z, M, F, rp, rd, rc, dsx, dysparse, dydense,
-        dsz);
+    SolveKKTSystem(Asparse, Adense, zEigvec, zEigvalSums, M, F, rp, rd, rc,
+        dsx, dysparse, dydense, dsz);
     math::Smat(dsx, dX);
     math::Smat(dsz, dZ);
     if (!Alpha(X, dX, tau, alpha))
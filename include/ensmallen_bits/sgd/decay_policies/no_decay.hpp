@@ -35,9 +35,10 @@ class NoDecay
   * @param stepSize Step size to be used for the given iteration.
   * @param gradient The gradient matrix.
   */
-  void Update(arma::mat& /* iterate */,
+  template<typename MatType, typename GradType>
+  void Update(const MatType& /* iterate */,
               double& /* stepSize */,
-              const arma::mat& /* gradient */)
+              const GradType& /* gradient */)
   {
     // Nothing to do here.
   }
@@ -15,6 +15,8 @@
 #ifndef ENSMALLEN_SGD_SGD_HPP
 #define ENSMALLEN_SGD_SGD_HPP
 
+#include <ensmallen_bits/utility/any.hpp>
+
 #include "update_policies/vanilla_update.hpp"
 #include "update_policies/momentum_update.hpp"
 #include "update_policies/nesterov_momentum_update.hpp"
@@ -103,6 +105,9 @@ class SGD
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *                    are reset before every Optimize call.
+   * @param numThreads Number of parts each batch is split into for
+   *     thread-parallel evaluation (1 means no parallelism, 0 means one part
+   *     per OpenMP thread).  See NumThreads().
    */
   SGD(const double stepSize = 0.01,
       const size_t batchSize = 32,
@@ -111,21 +116,36 @@ class SGD
       const bool shuffle = true,
       const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
       const DecayPolicyType& decayPolicy = DecayPolicyType(),
-      const bool resetPolicy = true);
+      const bool resetPolicy = true,
+      const size_t numThreads = 1);
 
   /**
    * Optimize the given function using stochastic gradient descent.  The given
    * starting point will be modified to store the finishing point of the
    * algorithm, and the final objective value is returned.
    *
+   * The iterate may be any dense Armadillo matrix type (e.g. arma::fmat); the
+   * given function must then provide methods that accept that type.
+   *
+   * Any number of callbacks may be given after the iterate; see Callback for
+   * the events they can handle.  An epoch is one pass over the functions.
+   *
    * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam MatType Type of matrix to optimize with.
+   * @tparam GradType Type of matrix to use to represent function gradients.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
-  double Optimize(DecomposableFunctionType& function,
-                  arma::mat& iterate);
+  template<typename DecomposableFunctionType,
+           typename MatType,
+           typename GradType = MatType,
+           typename... CallbackTypes>
+  typename MatType::elem_type Optimize(DecomposableFunctionType& function,
+                                       MatType& iterate,
+                                       CallbackTypes&&... callbacks);
 
   //! Get the step size.
   double StepSize() const { return stepSize; }
@@ -159,6 +179,20 @@ class SGD
   //! are reset before Optimize call.
   bool& ResetPolicy() { return resetPolicy; }
 
+  /**
+   * Get the number of parts each batch is split into for thread-parallel
+   * evaluation.  If it is not 1, each batch is split into that many contiguous
+   * ranges of functions (or one per OpenMP thread if it is 0), the objective
+   * and gradient of each range are evaluated in parallel into separate
+   * buffers, and the buffers are then summed in a fixed order, so the result
+   * does not depend on the thread scheduling.  The EvaluateWithGradient()
+   * method of the function must then be safe to call concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts each batch is split into for thread-parallel
+  //! evaluation.
+  size_t& NumThreads() { return numThreads; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -170,6 +204,21 @@ class SGD
   DecayPolicyType& DecayPolicy() { return decayPolicy; }
 
  private:
+  /**
+   * Evaluate the objective and gradient of the given batch by splitting it
+   * into partGradients.size() ranges that are evaluated in parallel, then sum
+   * the results in order.
+   */
+  template<typename FunctionType, typename MatType, typename GradType>
+  typename MatType::elem_type ParallelEvaluateWithGradient(
+      FunctionType& function,
+      const MatType& iterate,
+      const size_t begin,
+      GradType& gradient,
+      const size_t batchSize,
+      std::vector<typename MatType::elem_type>& partObjectives,
+      std::vector<GradType>& partGradients);
+
   //! The step size for each example.
   double stepSize;
 
@@ -189,12 +238,19 @@ class SGD
   //! The update policy used to update the parameters in each iteration.
   UpdatePolicyType updatePolicy;
 
+  //! The instantiated update policy (holding the state of the last
+  //! optimization, for the MatType it was run with).
+  Any instUpdatePolicy;
+
   //! The decay policy used to update the step size.
   DecayPolicyType decayPolicy;
 
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! The number of parts each batch is split into for parallel evaluation.
+  size_t numThreads;
 };
 
 using StandardSGD = SGD<VanillaUpdate>;
@@ -18,6 +18,7 @@
 #include "sgd.hpp"
 
 #include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/callbacks/callbacks.hpp>
 
 namespace ens {
 
@@ -30,7 +31,8 @@ SGD<UpdatePolicyType, DecayPolicyType>::SGD(
     const bool shuffle,
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
-    const bool resetPolicy) :
+    const bool resetPolicy,
+    const size_t numThreads) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -38,39 +40,80 @@ SGD<UpdatePolicyType, DecayPolicyType>::SGD(
     shuffle(shuffle),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
 template<typename UpdatePolicyType, typename DecayPolicyType>
-template<typename DecomposableFunctionType>
-double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
+template<typename DecomposableFunctionType,
+         typename MatType,
+         typename GradType,
+         typename... CallbackTypes>
+typename MatType::elem_type SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    MatType& iterate,
+    CallbackTypes&&... callbacks)
 {
-  typedef Function<DecomposableFunctionType> FullFunctionType;
+  typedef typename MatType::elem_type ElemType;
+  typedef Function<DecomposableFunctionType, MatType, GradType>
+      FullFunctionType;
   FullFunctionType& f(static_cast<FullFunctionType&>(function));
 
   // Make sure we have all the methods that we need.
-  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType>();
+  traits::CheckDecomposableFunctionTypeAPI<FullFunctionType, MatType,
+      GradType>();
 
   // Find the number of functions to use.
   const size_t numFunctions = f.NumFunctions();
 
   // To keep track of where we are and how things are going.
   size_t currentFunction = 0;
-  double overallObjective = 0;
-  double lastObjective = DBL_MAX;
+  ElemType overallObjective = 0;
+  ElemType lastObjective = std::numeric_limits<ElemType>::max();
 
-  // Initialize the update policy.
-  if (resetPolicy)
-    updatePolicy.Initialize(iterate.n_rows, iterate.n_cols);
+  // Initialize the update policy.  If the policy isn't reset, we reuse the
+  // state of the last optimization, as long as it was for the same MatType.
+  typedef typename UpdatePolicyType::template Policy<MatType, GradType>
+      InstUpdatePolicyType;
+  if (resetPolicy || !instUpdatePolicy.Has<InstUpdatePolicyType>())
+  {
+    instUpdatePolicy.Set(new InstUpdatePolicyType(updatePolicy, iterate.n_rows,
+        iterate.n_cols));
+  }
+  InstUpdatePolicyType& policy = instUpdatePolicy.As<InstUpdatePolicyType>();
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+  size_t epoch = 0;
+
+  // Whether BeginEpoch() has been fired for an epoch whose EndEpoch() has not
+  // been fired yet.
+  bool epochOpen = true;
+
+  terminate |= Callback::BeginOptimization(*this, f, iterate, callbacks...);
+  terminate |= Callback::BeginEpoch(*this, f, iterate, epoch,
+      overallObjective, callbacks...);
 
   // Now iterate!
-  arma::mat gradient(iterate.n_rows, iterate.n_cols);
+  GradType gradient(iterate.n_rows, iterate.n_cols);
+
+  // If the batches are evaluated in parallel, every part gets its own
+  // gradient buffer.
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, batchSize), size_t(1));
+  std::vector<GradType> partGradients((numParts > 1) ? numParts : 0,
+      GradType(iterate.n_rows, iterate.n_cols));
+  std::vector<ElemType> partObjectives(partGradients.size());
+
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; /* incrementing done manually */)
+  for (size_t i = 0; i < actualMaxIterations && !terminate;
+      /* incrementing done manually */)
   {
     // Is this iteration the start of a sequence?
     if ((currentFunction % numFunctions) == 0 && i > 0)
@@ -79,10 +122,16 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       Info << "SGD: iteration " << i << ", objective " << overallObjective
          << "." << std::endl;
 
+      terminate |= Callback::EndEpoch(*this, f, iterate, epoch,
+          overallObjective, callbacks...);
+      epochOpen = false;
+
       if (std::isnan(overallObjective) || std::isinf(overallObjective))
       {
         Warn << "SGD: converged to " << overallObjective << "; terminating"
             << " with failure.  Try a smaller step size?" << std::endl;
+
+        Callback::EndOptimization(*this, f, iterate, callbacks...);
         return overallObjective;
       }
 
@@ -90,9 +139,14 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
       {
         Info << "SGD: minimized within tolerance " << tolerance << "; "
             << "terminating optimization." << std::endl;
+
+        Callback::EndOptimization(*this, f, iterate, callbacks...);
         return overallObjective;
       }
 
+      if (terminate)
+        break;
+
       // Reset the counter variables.
       lastObjective = overallObjective;
       overallObjective = 0;
@@ -100,6 +154,10 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
       if (shuffle) // Determine order of visitation.
         f.Shuffle();
+
+      terminate |= Callback::BeginEpoch(*this, f, iterate, ++epoch,
+          lastObjective, callbacks...);
+      epochOpen = true;
     }
 
     // Find the effective batch size; we have to take the minimum of three
@@ -114,11 +172,22 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
 
     // Technically we are computing the objective before we take the step, but
     // for many FunctionTypes it may be much quicker to do it like this.
-    overallObjective += f.EvaluateWithGradient(iterate, currentFunction,
-        gradient, effectiveBatchSize);
+    const ElemType objective = (numParts > 1) ?
+        ParallelEvaluateWithGradient(f, iterate, currentFunction, gradient,
+            effectiveBatchSize, partObjectives, partGradients) :
+        f.EvaluateWithGradient(iterate, currentFunction, gradient,
+            effectiveBatchSize);
+    overallObjective += objective;
+
+    terminate |= Callback::Evaluate(*this, f, iterate, objective,
+        callbacks...);
+    terminate |= Callback::Gradient(*this, f, iterate, gradient,
+        callbacks...);
 
     // Use the update policy to take a step.
-    updatePolicy.Update(iterate, stepSize, gradient);
+    policy.Update(iterate, stepSize, gradient);
+
+    terminate |= Callback::StepTaken(*this, f, iterate, callbacks...);
 
     // Now update the learning rate if requested by the user.
     decayPolicy.Update(iterate, stepSize, gradient);
@@ -127,8 +196,19 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     currentFunction += effectiveBatchSize;
   }
 
-  Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
-      << "terminating optimization." << std::endl;
+  // The last epoch may have been cut short by the maximum number of iterations
+  // or by a callback; it still ends, with the objective of its batches.
+  if (epochOpen)
+  {
+    terminate |= Callback::EndEpoch(*this, f, iterate, epoch,
+        overallObjective, callbacks...);
+  }
+
+  if (!terminate)
+  {
+    Info << "SGD: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
+  }
 
   // Calculate final objective.
   overallObjective = 0;
@@ -137,9 +217,51 @@ double SGD<UpdatePolicyType, DecayPolicyType>::Optimize(
     const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
     overallObjective += f.Evaluate(iterate, i, effectiveBatchSize);
   }
+
+  Callback::EndOptimization(*this, f, iterate, callbacks...);
   return overallObjective;
 }
 
+template<typename UpdatePolicyType, typename DecayPolicyType>
+template<typename FunctionType, typename MatType, typename GradType>
+typename MatType::elem_type
+SGD<UpdatePolicyType, DecayPolicyType>::ParallelEvaluateWithGradient(
+    FunctionType& function,
+    const MatType& iterate,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize,
+    std::vector<typename MatType::elem_type>& partObjectives,
+    std::vector<GradType>& partGradients)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Split the batch into contiguous ranges of (almost) equal size.  The last
+  // batch of an epoch may be smaller than the number of parts.
+  const size_t numParts = std::min(partGradients.size(), batchSize);
+
+  // The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
+  {
+    const size_t partBegin = (size_t(p) * batchSize) / numParts;
+    const size_t partEnd = ((size_t(p) + 1) * batchSize) / numParts;
+    partObjectives[p] = function.EvaluateWithGradient(iterate,
+        begin + partBegin, partGradients[p], partEnd - partBegin);
+  }
+
+  // Reduce in a fixed order, so that the result is deterministic.
+  ElemType objective = partObjectives[0];
+  gradient = partGradients[0];
+  for (size_t p = 1; p < numParts; ++p)
+  {
+    objective += partObjectives[p];
+    gradient += partGradients[p];
+  }
+
+  return objective;
+}
+
 } // namespace ens
 
 #endif
@@ -70,9 +70,10 @@ class CyclicalDecay
    * @param stepSize Step size to be used for the given iteration.
    * @param gradient The gradient matrix.
    */
-  void Update(arma::mat& /* iterate */,
+  template<typename MatType, typename GradType>
+  void Update(const MatType& /* iterate */,
               double& stepSize,
-              const arma::mat& /* gradient */)
+              const GradType& /* gradient */)
   {
     // Time to adjust the step size.
     if (epoch >= epochRestart)
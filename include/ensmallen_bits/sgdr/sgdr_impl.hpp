@@ -43,10 +43,14 @@ SGDR<UpdatePolicyType>::SGDR(
 }
 
 template<typename UpdatePolicyType>
-template<typename DecomposableFunctionType>
-double SGDR<UpdatePolicyType>::Optimize(
+template<typename DecomposableFunctionType,
+         typename MatType,
+         typename GradType,
+         typename... CallbackTypes>
+typename MatType::elem_type SGDR<UpdatePolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    MatType& iterate,
+    CallbackTypes&&... callbacks)
 {
   // If a user changed the step size he hasn't update the step size of the
   // cyclical decay instantiation, so we have to do it here.
@@ -65,7 +69,9 @@ double SGDR<UpdatePolicyType>::Optimize(
     batchSize = optimizer.BatchSize();
   }
 
-  return optimizer.Optimize(function, iterate);
+  return optimizer.template Optimize<DecomposableFunctionType, MatType,
+      GradType, CallbackTypes...>(function, iterate,
+      std::forward<CallbackTypes>(callbacks)...);
 }
 
 } // namespace ens
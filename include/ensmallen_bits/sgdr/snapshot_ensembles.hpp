@@ -89,9 +89,10 @@ class SnapshotEnsembles
    * @param stepSize Step size to be used for the given iteration.
    * @param gradient The gradient matrix.
    */
-  void Update(arma::mat& iterate,
+  template<typename MatType, typename GradType>
+  void Update(const MatType& iterate,
               double& stepSize,
-              const arma::mat& /* gradient */)
+              const GradType& /* gradient */)
   {
     // Time to adjust the step size.
     if (epoch >= epochRestart)
@@ -112,10 +113,10 @@ class SnapshotEnsembles
       // Adjust the period of restarts.
       epochRestart *= multFactor;
 
-      // Create a new snapshot.
+      // Create a new snapshot (snapshots are always held as arma::mat).
       if (epochRestart >= snapshotEpochs)
       {
-        snapshots.push_back(iterate);
+        snapshots.push_back(arma::conv_to<arma::mat>::from(iterate));
       }
 
       // Update the time for the next restart.
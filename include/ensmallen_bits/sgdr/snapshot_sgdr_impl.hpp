@@ -48,10 +48,14 @@ SnapshotSGDR<UpdatePolicyType>::SnapshotSGDR(
 }
 
 template<typename UpdatePolicyType>
-template<typename DecomposableFunctionType>
-double SnapshotSGDR<UpdatePolicyType>::Optimize(
+template<typename DecomposableFunctionType,
+         typename MatType,
+         typename GradType,
+         typename... CallbackTypes>
+typename MatType::elem_type SnapshotSGDR<UpdatePolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    MatType& iterate,
+    CallbackTypes&&... callbacks)
 {
   // If a user changed the step size he hasn't update the step size of the
   // cyclical decay instantiation, so we have to do here.
@@ -70,14 +74,18 @@ double SnapshotSGDR<UpdatePolicyType>::Optimize(
     batchSize = optimizer.BatchSize();
   }
 
-  double overallObjective = optimizer.Optimize(function, iterate);
+  typename MatType::elem_type overallObjective =
+      optimizer.template Optimize<DecomposableFunctionType, MatType,
+      GradType, CallbackTypes...>(function, iterate,
+      std::forward<CallbackTypes>(callbacks)...);
 
   // Accumulate snapshots.
   if (accumulate)
   {
     for (size_t i = 0; i < optimizer.DecayPolicy().Snapshots().size(); ++i)
     {
-      iterate += optimizer.DecayPolicy().Snapshots()[i];
+      iterate += arma::conv_to<MatType>::from(
+          optimizer.DecayPolicy().Snapshots()[i]);
     }
     iterate /= (optimizer.DecayPolicy().Snapshots().size() + 1);
 
@@ -0,0 +1,214 @@
+/**
+ * @file slbfgs.hpp
+ * @author agent
+ *
+ * Stochastic L-BFGS with variance reduction (SLBFGS).
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SLBFGS_SLBFGS_HPP
+#define ENSMALLEN_SLBFGS_SLBFGS_HPP
+
+#include <ensmallen_bits/lbfgs/lbfgs_history.hpp>
+
+namespace ens {
+
+/**
+ * SLBFGS is a stochastic quasi-Newton method for minimizing a function which
+ * can be expressed as a sum of other functions,
+ *
+ * \f[
+ * f(A) = \sum_{i = 0}^{n} f_i(A).
+ * \f]
+ *
+ * Like SVRG, every outer iteration computes the full gradient at a snapshot
+ * point, and every inner step takes the variance reduced gradient of a batch.
+ * The step is scaled by the inverse Hessian approximation of L-BFGS (see
+ * LBFGSHistory).  Every updateInterval inner steps, the mean of the iterates
+ * of these steps is taken, and a curvature pair is built from the difference
+ * of two consecutive means and the difference of the gradients of a separate
+ * batch at them, so that the curvature pairs are not as noisy as the steps.
+ * Pairs with non-positive curvature are skipped.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @inproceedings{Moritz2016,
+ *   author    = {Moritz, Philipp and Nishihara, Robert and Jordan, Michael},
+ *   title     = {A Linearly-Convergent Stochastic L-BFGS Algorithm},
+ *   booktitle = {Proceedings of the 19th International Conference on
+ *                Artificial Intelligence and Statistics},
+ *   year      = {2016},
+ *   pages     = {249--258},
+ * }
+ * @endcode
+ *
+ * The paper uses subsampled Hessian-vector products for the curvature pairs;
+ * since the functions only provide gradients, differences of batch gradients
+ * are used instead.
+ *
+ * For SLBFGS to work, a DecomposableFunctionType template parameter is
+ * required.  This class must implement the following function:
+ *
+ *   size_t NumFunctions();
+ *   double Evaluate(const arma::mat& coordinates,
+ *                   const size_t i,
+ *                   const size_t batchSize);
+ *   void Gradient(const arma::mat& coordinates,
+ *                 const size_t i,
+ *                 arma::mat& gradient,
+ *                 const size_t batchSize);
+ *
+ * NumFunctions() should return the number of functions (\f$n\f$), and in the
+ * other two functions, the parameter i refers to which individual function (or
+ * gradient) is being evaluated.
+ */
+class SLBFGS
+{
+ public:
+  /**
+   * Construct the SLBFGS optimizer with the given parameters.  The maximum
+   * number of iterations refers to the maximum number of outer iterations.
+   *
+   * @param stepSize Step size for each iteration.
+   * @param batchSize Batch size to use for each step.
+   * @param maxIterations Maximum number of outer iterations allowed (0 means
+   *     no limit).
+   * @param innerIterations The number of points processed per outer iteration
+   *     (0 means n).
+   * @param numBasis Number of curvature pairs to be stored.
+   * @param updateInterval Number of inner steps after which a curvature pair
+   *     is built.
+   * @param hessianBatchSize Batch size of the gradients of the curvature
+   *     pairs.
+   * @param tolerance Maximum absolute tolerance to terminate algorithm.
+   * @param shuffle If true, the function order is shuffled; otherwise, each
+   *     function is visited in linear order.
+   * @param numThreads Number of parts the full gradient pass is split into
+   *     for thread-parallel evaluation (1 means no parallelism, 0 means one
+   *     part per OpenMP thread).
+   */
+  SLBFGS(const double stepSize = 0.01,
+         const size_t batchSize = 32,
+         const size_t maxIterations = 1000,
+         const size_t innerIterations = 0,
+         const size_t numBasis = 10,
+         const size_t updateInterval = 10,
+         const size_t hessianBatchSize = 256,
+         const double tolerance = 1e-5,
+         const bool shuffle = true,
+         const size_t numThreads = 1);
+
+  /**
+   * Optimize the given function using SLBFGS.  The given starting point will
+   * be modified to store the finishing point of the algorithm, and the final
+   * objective value is returned.
+   *
+   * Any number of callbacks may be given after the iterate; see Callback for
+   * the events they can handle.  An epoch is one outer iteration.
+   *
+   * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
+   * @param function Function to optimize.
+   * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
+   * @return Objective value of the final point.
+   */
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
+
+  //! Get the step size.
+  double StepSize() const { return stepSize; }
+  //! Modify the step size.
+  double& StepSize() { return stepSize; }
+
+  //! Get the batch size.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the maximum number of outer iterations (0 indicates no limit).
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of outer iterations (0 indicates no limit).
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of points processed per outer iteration (0 indicates n).
+  size_t InnerIterations() const { return innerIterations; }
+  //! Modify the number of points processed per outer iteration (0 indicates
+  //! n).
+  size_t& InnerIterations() { return innerIterations; }
+
+  //! Get the number of curvature pairs to be stored.
+  size_t NumBasis() const { return numBasis; }
+  //! Modify the number of curvature pairs to be stored.
+  size_t& NumBasis() { return numBasis; }
+
+  //! Get the number of inner steps after which a curvature pair is built.
+  size_t UpdateInterval() const { return updateInterval; }
+  //! Modify the number of inner steps after which a curvature pair is built.
+  size_t& UpdateInterval() { return updateInterval; }
+
+  //! Get the batch size of the gradients of the curvature pairs.
+  size_t HessianBatchSize() const { return hessianBatchSize; }
+  //! Modify the batch size of the gradients of the curvature pairs.
+  size_t& HessianBatchSize() { return hessianBatchSize; }
+
+  //! Get the tolerance for termination.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for termination.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether or not the individual functions are shuffled.
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not the individual functions are shuffled.
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the number of parts the full gradient pass is split into.
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the full gradient pass is split into.
+  size_t& NumThreads() { return numThreads; }
+
+ private:
+  //! The step size for each example.
+  double stepSize;
+
+  //! The batch size for processing.
+  size_t batchSize;
+
+  //! The maximum number of allowed outer iterations.
+  size_t maxIterations;
+
+  //! The number of points processed per outer iteration.
+  size_t innerIterations;
+
+  //! The number of curvature pairs to be stored.
+  size_t numBasis;
+
+  //! The number of inner steps after which a curvature pair is built.
+  size_t updateInterval;
+
+  //! The batch size of the gradients of the curvature pairs.
+  size_t hessianBatchSize;
+
+  //! The tolerance for termination.
+  double tolerance;
+
+  //! Controls whether or not the individual functions are shuffled when
+  //! iterating.
+  bool shuffle;
+
+  //! The number of parts the full gradient pass is split into.
+  size_t numThreads;
+};
+
+} // namespace ens
+
+// Include implementation.
+#include "slbfgs_impl.hpp"
+
+#endif
@@ -0,0 +1,273 @@
+/**
+ * @file slbfgs_impl.hpp
+ * @author agent
+ *
+ * Implementation of stochastic L-BFGS with variance reduction (SLBFGS).
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_SLBFGS_SLBFGS_IMPL_HPP
+#define ENSMALLEN_SLBFGS_SLBFGS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "slbfgs.hpp"
+
+#include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/callbacks/callbacks.hpp>
+#include <ensmallen_bits/utility/full_evaluate_with_gradient.hpp>
+
+namespace ens {
+
+inline SLBFGS::SLBFGS(const double stepSize,
+                      const size_t batchSize,
+                      const size_t maxIterations,
+                      const size_t innerIterations,
+                      const size_t numBasis,
+                      const size_t updateInterval,
+                      const size_t hessianBatchSize,
+                      const double tolerance,
+                      const bool shuffle,
+                      const size_t numThreads) :
+    stepSize(stepSize),
+    batchSize(batchSize),
+    maxIterations(maxIterations),
+    innerIterations(innerIterations),
+    numBasis(numBasis),
+    updateInterval(updateInterval),
+    hessianBatchSize(hessianBatchSize),
+    tolerance(tolerance),
+    shuffle(shuffle),
+    numThreads(numThreads)
+{ /* Nothing to do. */ }
+
+//! Optimize the function (minimize).
+template<typename DecomposableFunctionType, typename... CallbackTypes>
+double SLBFGS::Optimize(DecomposableFunctionType& function,
+                        arma::mat& iterate,
+                        CallbackTypes&&... callbacks)
+{
+  if (numBasis == 0 || updateInterval == 0)
+  {
+    throw std::invalid_argument("SLBFGS::Optimize(): the number of curvature "
+        "pairs and the update interval must be positive");
+  }
+
+  // Find the number of functions to use.
+  const size_t numFunctions = function.NumFunctions();
+  const size_t actualInnerIterations = (innerIterations == 0) ?
+      numFunctions : innerIterations;
+  const size_t curvatureBatchSize = std::min(hessianBatchSize, numFunctions);
+
+  // To keep track of where we are and how things are going.
+  double overallObjective = 0;
+  double lastObjective = DBL_MAX;
+
+  const size_t rows = iterate.n_rows;
+  const size_t cols = iterate.n_cols;
+
+  arma::mat gradient(rows, cols);
+  arma::mat gradient0(rows, cols);
+  arma::mat fullGradient(rows, cols);
+  arma::mat direction(rows, cols);
+  arma::mat iterate0;
+
+  // The curvature pairs, and the means of the iterates they are built from.
+  LBFGSHistory history(numBasis, rows, cols);
+  arma::mat iterateSum(rows, cols, arma::fill::zeros);
+  arma::mat average(rows, cols);
+  arma::mat lastAverage;
+  arma::mat curvatureGradient(rows, cols);
+  arma::mat lastCurvatureGradient(rows, cols);
+  size_t steps = 0;
+
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+  terminate |= Callback::BeginOptimization(*this, function, iterate,
+      callbacks...);
+
+  // Whether BeginEpoch() has been fired for an epoch whose EndEpoch() has not
+  // been fired yet, and the index of that epoch.
+  bool epochOpen = false;
+  size_t epoch = 0;
+
+  const size_t actualMaxIterations = (maxIterations == 0) ?
+      std::numeric_limits<size_t>::max() : maxIterations;
+  for (size_t i = 0; i < actualMaxIterations && !terminate; ++i)
+  {
+    // Calculate the objective function and the full gradient in a single
+    // pass over the data.
+    overallObjective = FullEvaluateWithGradient(function, iterate,
+        fullGradient, batchSize, numThreads);
+
+    terminate |= Callback::Evaluate(*this, function, iterate,
+        overallObjective, callbacks...);
+
+    if (i > 0)
+    {
+      terminate |= Callback::EndEpoch(*this, function, iterate, i - 1,
+          overallObjective, callbacks...);
+      epochOpen = false;
+    }
+
+    if (std::isnan(overallObjective) || std::isinf(overallObjective))
+    {
+      Warn << "SLBFGS: converged to " << overallObjective
+          << "; terminating with failure.  Try a smaller step size?"
+          << std::endl;
+
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
+      return overallObjective;
+    }
+
+    if (std::abs(lastObjective - overallObjective) < tolerance)
+    {
+      Info << "SLBFGS: minimized within tolerance " << tolerance
+          << "; terminating optimization." << std::endl;
+
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
+      return overallObjective;
+    }
+
+    if (terminate)
+      break;
+
+    terminate |= Callback::BeginEpoch(*this, function, iterate, i,
+        overallObjective, callbacks...);
+    epochOpen = true;
+    epoch = i;
+
+    lastObjective = overallObjective;
+
+    fullGradient /= (double) numFunctions;
+
+    terminate |= Callback::Gradient(*this, function, iterate, fullGradient,
+        callbacks...);
+
+    // Store current parameter for the calculation of the variance reduced
+    // gradient.
+    iterate0 = iterate;
+
+    for (size_t f = 0, currentFunction = 0;
+        f < actualInnerIterations && !terminate;
+        /* incrementing done manually */)
+    {
+      // Is this iteration the start of a sequence?
+      if ((currentFunction % numFunctions) == 0)
+      {
+        currentFunction = 0;
+
+        // Determine order of visitation.
+        if (shuffle)
+          function.Shuffle();
+      }
+
+      // Find the effective batch size (the last batch may be smaller).
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
+
+      // Calculate variance reduced gradient.
+      function.Gradient(iterate, currentFunction, gradient,
+          effectiveBatchSize);
+      function.Gradient(iterate0, currentFunction, gradient0,
+          effectiveBatchSize);
+
+      terminate |= Callback::Gradient(*this, function, iterate, gradient,
+          callbacks...);
+      terminate |= Callback::Gradient(*this, function, iterate0, gradient0,
+          callbacks...);
+
+      gradient -= gradient0;
+      gradient /= (double) effectiveBatchSize;
+      gradient += fullGradient;
+
+      // Scale the gradient with the inverse Hessian approximation, once there
+      // is a curvature pair.
+      if (history.Size() == 0)
+      {
+        direction = -gradient;
+      }
+      else
+      {
+        history.SearchDirection(gradient, history.ScalingFactor(gradient),
+            direction);
+      }
+
+      iterate += stepSize * direction;
+
+      terminate |= Callback::StepTaken(*this, function, iterate,
+          callbacks...);
+
+      // Build a curvature pair from the means of the iterates of the last two
+      // update intervals.
+      iterateSum += iterate;
+      if (++steps % updateInterval == 0)
+      {
+        average = iterateSum / (double) updateInterval;
+        iterateSum.zeros();
+
+        if (!lastAverage.is_empty())
+        {
+          const size_t begin = (numFunctions == curvatureBatchSize) ? 0 :
+              arma::as_scalar(arma::randi<arma::uvec>(1, arma::distr_param(0,
+              int(numFunctions - curvatureBatchSize))));
+
+          function.Gradient(average, begin, curvatureGradient,
+              curvatureBatchSize);
+          function.Gradient(lastAverage, begin, lastCurvatureGradient,
+              curvatureBatchSize);
+
+          const double sy = arma::dot(average - lastAverage,
+              curvatureGradient - lastCurvatureGradient);
+          const double yy = arma::dot(
+              curvatureGradient - lastCurvatureGradient,
+              curvatureGradient - lastCurvatureGradient);
+          if (sy > std::numeric_limits<double>::epsilon() * yy)
+          {
+            // The pair is scale-invariant, so the gradients of the batch do
+            // not need to be averaged.
+            history.Update(average, lastAverage, curvatureGradient,
+                lastCurvatureGradient);
+          }
+        }
+
+        lastAverage = average;
+      }
+
+      currentFunction += effectiveBatchSize;
+      f += effectiveBatchSize;
+    }
+  }
+
+  if (!terminate)
+  {
+    Info << "SLBFGS: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
+  }
+
+  // Calculate final objective.
+  overallObjective = 0;
+  for (size_t i = 0; i < numFunctions; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
+    overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
+  }
+
+  // If the maximum number of iterations was reached or a callback terminated
+  // the optimization, the last epoch has not ended yet; it ends with the final
+  // objective.
+  if (epochOpen)
+  {
+    Callback::EndEpoch(*this, function, iterate, epoch, overallObjective,
+        callbacks...);
+  }
+
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
+  return overallObjective;
+}
+
+} // namespace ens
+
+#endif
@@ -44,49 +44,70 @@ class SMORMS3Update
   { /* Do nothing. */ }
 
   /**
-   * The Initialize method is called by SGD::Optimize method with UpdatePolicy
-   * SMORMS3Update before the start of the iteration update process.
-   *
-   * @param rows Number of rows in the gradient matrix.
-   * @param cols Number of columns in the gradient matrix.
+   * The UpdatePolicyType policy classes must contain an internal 'Policy'
+   * template class with two template arguments: MatType and GradType.  This is
+   * instantiated at the start of the optimization, and holds parameters
+   * specific to an individual optimization.
    */
-  void Initialize(const size_t rows, const size_t cols)
+  template<typename MatType, typename GradType>
+  class Policy
   {
-    // Initialise the parameters mem, g and g2.
-    mem = arma::ones<arma::mat>(rows, cols);
-    g = arma::zeros<arma::mat>(rows, cols);
-    g2 = arma::zeros<arma::mat>(rows, cols);
-  }
-
-  /**
-   * Update step for SMORMS3.
-   *
-   * @param iterate Parameter that minimizes the function.
-   * @param stepSize Step size to be used for the given iteration.
-   * @param gradient The gradient matrix.
-   */
-  void Update(arma::mat& iterate,
-              const double stepSize,
-              const arma::mat& gradient)
-  {
-    // Update the iterate.
-    arma::mat r = 1 / (mem + 1);
-
-    g = (1 - r) % g;
-    g += r % gradient;
-
-    g2 = (1 - r) % g2;
-    g2 += r % (gradient % gradient);
-
-    arma::mat x = (g % g) / (g2 + epsilon);
-
-    x.transform( [stepSize](double &v) { return std::min(v, stepSize); } );
-
-    iterate -= gradient % x / (arma::sqrt(g2) + epsilon);
-
-    mem %= (1 - x);
-    mem += 1;
-  }
+   public:
+    /**
+     * This is called by SGD::Optimize() with UpdatePolicy SMORMS3Update before
+     * the start of the iteration update process.
+     *
+     * @param parent Instantiated parent class.
+     * @param rows Number of rows in the gradient matrix.
+     * @param cols Number of columns in the gradient matrix.
+     */
+    Policy(const SMORMS3Update& parent, const size_t rows, const size_t cols) :
+        parent(parent),
+        mem(arma::ones<MatType>(rows, cols)),
+        g(arma::zeros<MatType>(rows, cols)),
+        g2(arma::zeros<MatType>(rows, cols))
+    { /* Do nothing. */ }
+
+    /**
+     * Update step for SMORMS3.
+     *
+     * @param iterate Parameter that minimizes the function.
+     * @param stepSize Step size to be used for the given iteration.
+     * @param gradient The gradient matrix.
+     */
+    void Update(MatType& iterate,
+                const double stepSize,
+                const GradType& gradient)
+    {
+      typedef typename MatType::elem_type ElemType;
+
+      // Update the iterate.
+      MatType r = 1 / (mem + 1);
+
+      g = (1 - r) % g;
+      g += r % gradient;
+
+      g2 = (1 - r) % g2;
+      g2 += r % (gradient % gradient);
+
+      MatType x = (g % g) / (g2 + parent.epsilon);
+
+      const ElemType maxStep = ElemType(stepSize);
+      x.transform( [maxStep](ElemType &v) { return std::min(v, maxStep); } );
+
+      iterate -= gradient % x / (arma::sqrt(g2) + parent.epsilon);
+
+      mem %= (1 - x);
+      mem += 1;
+    }
+
+   private:
+    //! Instantiated parent object.
+    const SMORMS3Update& parent;
+
+    // The parameters mem, g and g2.
+    MatType mem, g, g2;
+  };
 
   //! Get the value used to initialise the mean squared gradient parameter.
   double Epsilon() const { return epsilon; }
@@ -96,9 +117,6 @@ class SMORMS3Update
  private:
   //! The value used to initialise the mean squared gradient parameter.
   double epsilon;
-
-  // The parameters mem, g and g2.
-  arma::mat mem, g, g2;
 };
 
 } // namespace ens
@@ -122,6 +122,9 @@ class SVRGType
    * @param decayPolicy Instantiated decay policy used to adjust the step size.
    * @param resetPolicy Flag that determines whether update policy parameters
    *     are reset before every Optimize call.
+   * @param numThreads Number of parts the full gradient pass is split into
+   *     for thread-parallel evaluation (1 means no parallelism, 0 means one
+   *     part per OpenMP thread).  See NumThreads().
    */
   SVRGType(const double stepSize = 0.01,
            const size_t batchSize = 32,
@@ -131,20 +134,29 @@ class SVRGType
            const bool shuffle = true,
            const UpdatePolicyType& updatePolicy = UpdatePolicyType(),
            const DecayPolicyType& decayPolicy = DecayPolicyType(),
-           const bool resetPolicy = true);
+           const bool resetPolicy = true,
+           const size_t numThreads = 1);
 
   /**
    * Optimize the given function using SVRG. The given starting point will be
    * modified to store the finishing point of the algorithm, and the final
    * objective value is returned.
    *
+   * Any number of callbacks may be given after the iterate; see Callback for
+   * the events they can handle.  An epoch is one outer iteration (one full
+   * gradient computation followed by the inner iterations).
+   *
    * @tparam DecomposableFunctionType Type of the function to be optimized.
+   * @tparam CallbackTypes Types of the callbacks.
    * @param function Function to optimize.
    * @param iterate Starting point (will be modified).
+   * @param callbacks Callbacks to be invoked during the optimization.
    * @return Objective value of the final point.
    */
-  template<typename DecomposableFunctionType>
-  double Optimize(DecomposableFunctionType& function, arma::mat& iterate);
+  template<typename DecomposableFunctionType, typename... CallbackTypes>
+  double Optimize(DecomposableFunctionType& function,
+                  arma::mat& iterate,
+                  CallbackTypes&&... callbacks);
 
   //! Get the step size.
   double StepSize() const { return stepSize; }
@@ -183,6 +195,18 @@ class SVRGType
   //! are reset before Optimize call.
   bool& ResetPolicy() { return resetPolicy; }
 
+  /**
+   * Get the number of parts the full objective and gradient pass of each outer
+   * iteration is split into.  If it is not 1, the batches are evaluated in
+   * that many parallel ranges (or one per OpenMP thread if it is 0), so the
+   * EvaluateWithGradient() method of the function must be safe to call
+   * concurrently.
+   */
+  size_t NumThreads() const { return numThreads; }
+  //! Modify the number of parts the full objective and gradient pass is split
+  //! into.
+  size_t& NumThreads() { return numThreads; }
+
   //! Get the update policy.
   const UpdatePolicyType& UpdatePolicy() const { return updatePolicy; }
   //! Modify the update policy.
@@ -222,6 +246,9 @@ class SVRGType
   //! Flag indicating whether update policy
   //! should be reset before running optimization.
   bool resetPolicy;
+
+  //! The number of parts the full gradient pass is split into.
+  size_t numThreads;
 };
 
 // Convenience typedefs.
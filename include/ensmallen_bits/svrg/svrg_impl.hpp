@@ -15,6 +15,10 @@
 // In case it hasn't been included yet.
 #include "svrg.hpp"
 
+#include <ensmallen_bits/function.hpp>
+#include <ensmallen_bits/callbacks/callbacks.hpp>
+#include <ensmallen_bits/utility/full_evaluate_with_gradient.hpp>
+
 namespace ens {
 
 template<typename UpdatePolicyType, typename DecayPolicyType>
@@ -27,7 +31,8 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     const bool shuffle,
     const UpdatePolicyType& updatePolicy,
     const DecayPolicyType& decayPolicy,
-    const bool resetPolicy) :
+    const bool resetPolicy,
+    const size_t numThreads) :
     stepSize(stepSize),
     batchSize(batchSize),
     maxIterations(maxIterations),
@@ -36,15 +41,17 @@ SVRGType<UpdatePolicyType, DecayPolicyType>::SVRGType(
     shuffle(shuffle),
     updatePolicy(updatePolicy),
     decayPolicy(decayPolicy),
-    resetPolicy(resetPolicy)
+    resetPolicy(resetPolicy),
+    numThreads(numThreads)
 { /* Nothing to do. */ }
 
 //! Optimize the function (minimize).
 template<typename UpdatePolicyType, typename DecayPolicyType>
-template<typename DecomposableFunctionType>
+template<typename DecomposableFunctionType, typename... CallbackTypes>
 double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     DecomposableFunctionType& function,
-    arma::mat& iterate)
+    arma::mat& iterate,
+    CallbackTypes&&... callbacks)
 {
   // Find the number of functions to use.
   const size_t numFunctions = function.NumFunctions();
@@ -64,6 +71,7 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   // Now iterate!
   arma::mat gradient(iterate.n_rows, iterate.n_cols);
   arma::mat gradient0(iterate.n_rows, iterate.n_cols);
+  arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
   arma::mat iterate0;
 
   // Find the number of batches.
@@ -71,16 +79,33 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
   if (numFunctions % batchSize != 0)
     ++numBatches; // Capture last few.
 
+  // Controls early termination of the optimization process.
+  bool terminate = false;
+  terminate |= Callback::BeginOptimization(*this, function, iterate,
+      callbacks...);
+
+  // Whether BeginEpoch() has been fired for an epoch whose EndEpoch() has not
+  // been fired yet, and the index of that epoch.
+  bool epochOpen = false;
+  size_t epoch = 0;
+
   const size_t actualMaxIterations = (maxIterations == 0) ?
       std::numeric_limits<size_t>::max() : maxIterations;
-  for (size_t i = 0; i < actualMaxIterations; ++i)
+  for (size_t i = 0; i < actualMaxIterations && !terminate; ++i)
   {
-    // Calculate the objective function.
-    overallObjective = 0;
-    for (size_t f = 0; f < numFunctions; f += batchSize)
+    // Calculate the objective function and the full gradient in a single
+    // pass over the data.
+    overallObjective = FullEvaluateWithGradient(function, iterate,
+        fullGradient, batchSize, numThreads);
+
+    terminate |= Callback::Evaluate(*this, function, iterate,
+        overallObjective, callbacks...);
+
+    if (i > 0)
     {
-      const size_t effectiveBatchSize = std::min(batchSize, numFunctions - f);
-      overallObjective += function.Evaluate(iterate, f, effectiveBatchSize);
+      terminate |= Callback::EndEpoch(*this, function, iterate, i - 1,
+          overallObjective, callbacks...);
+      epochOpen = false;
     }
 
     if (std::isnan(overallObjective) || std::isinf(overallObjective))
@@ -88,6 +113,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       Warn << "SVRG: converged to " << overallObjective
           << "; terminating  with failure.  Try a smaller step size?"
           << std::endl;
+
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
       return overallObjective;
     }
 
@@ -95,33 +122,31 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     {
       Info << "SVRG: minimized within tolerance " << tolerance
           << "; terminating optimization." << std::endl;
+
+      Callback::EndOptimization(*this, function, iterate, callbacks...);
       return overallObjective;
     }
 
-    lastObjective = overallObjective;
+    if (terminate)
+      break;
 
-    // Compute the full gradient.
-    size_t effectiveBatchSize = std::min(batchSize, numFunctions);
-    arma::mat fullGradient(iterate.n_rows, iterate.n_cols);
-    function.Gradient(iterate, 0, fullGradient, effectiveBatchSize);
-    for (size_t f = effectiveBatchSize; f < numFunctions;
-        /* incrementing done manually */)
-    {
-      // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - f);
+    terminate |= Callback::BeginEpoch(*this, function, iterate, i,
+        overallObjective, callbacks...);
+    epochOpen = true;
+    epoch = i;
 
-      function.Gradient(iterate, f, gradient, effectiveBatchSize);
-      fullGradient += gradient;
+    lastObjective = overallObjective;
 
-      f += effectiveBatchSize;
-    }
     fullGradient /= (double) numFunctions;
 
+    terminate |= Callback::Gradient(*this, function, iterate, fullGradient,
+        callbacks...);
+
     // Store current parameter for the calculation of the variance reduced
     // gradient.
     iterate0 = iterate;
 
-    for (size_t f = 0, currentFunction = 0; f < innerIterations;
+    for (size_t f = 0, currentFunction = 0; f < innerIterations && !terminate;
         /* incrementing done manually */)
     {
       // Is this iteration the start of a sequence?
@@ -135,7 +160,8 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       }
 
       // Find the effective batch size (the last batch may be smaller).
-      effectiveBatchSize = std::min(batchSize, numFunctions - currentFunction);
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - currentFunction);
 
       // Calculate variance reduced gradient.
       function.Gradient(iterate, currentFunction, gradient,
@@ -143,10 +169,18 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
       function.Gradient(iterate0, currentFunction, gradient0,
           effectiveBatchSize);
 
+      terminate |= Callback::Gradient(*this, function, iterate, gradient,
+          callbacks...);
+      terminate |= Callback::Gradient(*this, function, iterate0, gradient0,
+          callbacks...);
+
       // Use the update policy to take a step.
       updatePolicy.Update(iterate, fullGradient, gradient, gradient0,
           effectiveBatchSize, stepSize);
 
+      terminate |= Callback::StepTaken(*this, function, iterate,
+          callbacks...);
+
       currentFunction += effectiveBatchSize;
       f += effectiveBatchSize;
     }
@@ -156,8 +190,11 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
         stepSize);
   }
 
-  Info << "SVRG: maximum iterations (" << maxIterations << ") reached; "
-      << "terminating optimization." << std::endl;
+  if (!terminate)
+  {
+    Info << "SVRG: maximum iterations (" << maxIterations << ") reached; "
+        << "terminating optimization." << std::endl;
+  }
 
   // Calculate final objective.
   overallObjective = 0;
@@ -166,6 +203,17 @@ double SVRGType<UpdatePolicyType, DecayPolicyType>::Optimize(
     const size_t effectiveBatchSize = std::min(batchSize, numFunctions - i);
     overallObjective += function.Evaluate(iterate, i, effectiveBatchSize);
   }
+
+  // If the maximum number of iterations was reached or a callback terminated
+  // the optimization, the last epoch has not ended yet; it ends with the final
+  // objective.
+  if (epochOpen)
+  {
+    Callback::EndEpoch(*this, function, iterate, epoch, overallObjective,
+        callbacks...);
+  }
+
+  Callback::EndOptimization(*this, function, iterate, callbacks...);
   return overallObjective;
 }
 
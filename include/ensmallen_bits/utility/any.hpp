@@ -0,0 +1,113 @@
+/**
+ * @file any.hpp
+ * @author agent
+ *
+ * A minimal type-erased holder, used by optimizers to keep state whose type
+ * depends on the matrix type passed to Optimize() (e.g., instantiated update
+ * policies).
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_ANY_HPP
+#define ENSMALLEN_UTILITY_ANY_HPP
+
+namespace ens {
+
+/**
+ * Any holds a single heap-allocated object of arbitrary type, or nothing.  The
+ * type of the held object can be queried with Has<T>(), and the object can be
+ * accessed with As<T>().
+ *
+ * Copying an Any does not copy the held object: the copy is empty.  This is
+ * intentional; the objects held by optimizers usually keep references to
+ * members of the optimizer that owns them, so a copied optimizer must create
+ * its own instance anyway.
+ */
+class Any
+{
+ public:
+  //! Create an empty Any.
+  Any() : ptr(NULL), type(NULL), deleter(NULL) { }
+
+  //! Copying an Any results in an empty Any.
+  Any(const Any& /* other */) : ptr(NULL), type(NULL), deleter(NULL) { }
+
+  //! Copying an Any results in an empty Any.
+  Any& operator=(const Any& other)
+  {
+    if (this != &other)
+      Clean();
+
+    return *this;
+  }
+
+  //! Destroy the held object, if any.
+  ~Any() { Clean(); }
+
+  /**
+   * Take ownership of the given object (which must have been allocated with
+   * new).  Any previously held object is destroyed.
+   *
+   * @param object Object to hold.
+   * @return Reference to the held object.
+   */
+  template<typename T>
+  T& Set(T* object)
+  {
+    Clean();
+    ptr = object;
+    type = TypeId<T>();
+    deleter = &Delete<T>;
+    return *object;
+  }
+
+  //! Return true if an object of type T is held.
+  template<typename T>
+  bool Has() const { return (ptr != NULL) && (type == TypeId<T>()); }
+
+  //! Access the held object; Has<T>() must be true.
+  template<typename T>
+  T& As() { return *static_cast<T*>(ptr); }
+
+  //! Access the held object; Has<T>() must be true.
+  template<typename T>
+  const T& As() const { return *static_cast<const T*>(ptr); }
+
+  //! Destroy the held object, if any.
+  void Clean()
+  {
+    if (deleter)
+      deleter(ptr);
+
+    ptr = NULL;
+    type = NULL;
+    deleter = NULL;
+  }
+
+ private:
+  //! Return a unique identifier for the type T.
+  template<typename T>
+  static const void* TypeId()
+  {
+    static const char id = 0;
+    return &id;
+  }
+
+  //! Delete an object of type T.
+  template<typename T>
+  static void Delete(void* object) { delete static_cast<T*>(object); }
+
+  //! The held object.
+  void* ptr;
+  //! The identifier of the type of the held object.
+  const void* type;
+  //! The function used to destroy the held object.
+  void (*deleter)(void*);
+};
+
+} // namespace ens
+
+#endif
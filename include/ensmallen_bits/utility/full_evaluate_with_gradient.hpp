@@ -0,0 +1,100 @@
+/**
+ * @file full_evaluate_with_gradient.hpp
+ * @author agent
+ *
+ * Evaluate the objective and the gradient of a decomposable function over all
+ * of its functions in a single pass, as needed by the variance-reduced
+ * optimizers for their snapshot.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_FULL_EVALUATE_WITH_GRADIENT_HPP
+#define ENSMALLEN_UTILITY_FULL_EVALUATE_WITH_GRADIENT_HPP
+
+#include <ensmallen_bits/function.hpp>
+
+namespace ens {
+
+/**
+ * Compute the sum of the objectives and the sum of the gradients of all the
+ * functions of the given decomposable function, visiting every batch once with
+ * EvaluateWithGradient().  The function is wrapped in Function<>, so it may
+ * implement Evaluate() and Gradient() instead.
+ *
+ * If numThreads is not 1, the batches are split into that many contiguous
+ * ranges (or one per OpenMP thread if it is 0), which are evaluated in
+ * parallel and then summed in order.  The EvaluateWithGradient() method of the
+ * function must then be safe to call concurrently.
+ *
+ * @param function Function to evaluate.
+ * @param iterate Point to evaluate at.
+ * @param gradient Matrix to store the summed gradient in.
+ * @param batchSize Number of functions per EvaluateWithGradient() call.
+ * @param numThreads Number of ranges evaluated in parallel.
+ * @return The summed objective.
+ */
+template<typename FunctionType, typename MatType, typename GradType>
+typename MatType::elem_type FullEvaluateWithGradient(
+    FunctionType& function,
+    const MatType& iterate,
+    GradType& gradient,
+    const size_t batchSize,
+    const size_t numThreads = 1)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef Function<FunctionType, MatType, GradType> FullFunctionType;
+  FullFunctionType& fullFunction(static_cast<FullFunctionType&>(function));
+
+  const size_t numFunctions = function.NumFunctions();
+  const size_t numBatches = (numFunctions + batchSize - 1) / batchSize;
+
+  size_t numParts = numThreads;
+  #ifdef ENS_USE_OPENMP
+    if (numParts == 0)
+      numParts = omp_get_max_threads();
+  #endif
+  numParts = std::max(std::min(numParts, numBatches), size_t(1));
+
+  // The first range is accumulated into the output directly.
+  std::vector<GradType> partGradients(numParts - 1);
+  std::vector<ElemType> partObjectives(numParts, ElemType(0));
+
+  // The loop variable is signed for OpenMP 2.0 compilers.
+  ENS_PRAGMA_OMP_PARALLEL_FOR
+  for (ptrdiff_t p = 0; p < (ptrdiff_t) numParts; ++p)
+  {
+    GradType& partGradient = (p == 0) ? gradient : partGradients[p - 1];
+    partGradient.zeros(iterate.n_rows, iterate.n_cols);
+    GradType batchGradient(iterate.n_rows, iterate.n_cols);
+
+    const size_t firstBatch = (size_t(p) * numBatches) / numParts;
+    const size_t lastBatch = ((size_t(p) + 1) * numBatches) / numParts;
+    for (size_t b = firstBatch; b < lastBatch; ++b)
+    {
+      const size_t begin = b * batchSize;
+      const size_t effectiveBatchSize = std::min(batchSize,
+          numFunctions - begin);
+
+      partObjectives[p] += fullFunction.EvaluateWithGradient(iterate, begin,
+          batchGradient, effectiveBatchSize);
+      partGradient += batchGradient;
+    }
+  }
+
+  // Reduce in a fixed order, so that the result is deterministic.
+  ElemType objective = partObjectives[0];
+  for (size_t p = 1; p < numParts; ++p)
+  {
+    objective += partObjectives[p];
+    gradient += partGradients[p - 1];
+  }
+
+  return objective;
+}
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,248 @@
+/**
+ * @file mapped_matrix.hpp
+ * @author agent
+ *
+ * A read-only, memory-mapped matrix stored in a binary file, for datasets that
+ * do not fit in memory.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_MAPPED_MATRIX_HPP
+#define ENSMALLEN_UTILITY_MAPPED_MATRIX_HPP
+
+#if defined(__unix__) || defined(__APPLE__)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace ens {
+
+/**
+ * MappedMatrix maps a binary file holding a column-major matrix into memory,
+ * and exposes it as a read-only Armadillo matrix that aliases the mapping.
+ * The operating system then reads the pages of the file when they are
+ * accessed and can evict them when memory is needed, so the matrix may be
+ * larger than the available memory.  The file is not modified.
+ *
+ * The file must contain the elements of the matrix with no header, as written
+ * by Armadillo's raw_binary format:
+ *
+ * @code
+ * data.save("data.bin", arma::raw_binary);
+ *
+ * MappedMatrix<> mapped("data.bin", data.n_rows);
+ * LogisticRegressionFunction<> f(mapped.Matrix(), responses, 0.5);
+ * @endcode
+ *
+ * The functions in ensmallen_bits/problems/ keep an alias of the data they are
+ * given and do not copy it (not even when shuffling), so they can be trained
+ * directly on a mapped matrix.  Accesses are sequential when the functions are
+ * visited in order, or nearly sequential with a large shuffle block size; call
+ * AdviseSequential() in that case so that the operating system reads ahead.
+ * Prefetch() and Evict() give batch-wise control over which columns are
+ * resident.
+ *
+ * Memory mapping is only available on POSIX systems; elsewhere the constructor
+ * throws std::runtime_error.
+ *
+ * @tparam eT Type of the elements of the matrix.
+ */
+template<typename eT = double>
+class MappedMatrix
+{
+ public:
+  /**
+   * Map the given file.  The number of columns is the number of elements in
+   * the file (after the offset) divided by the number of rows.
+   *
+   * @param filename Name of the file to map.
+   * @param rows Number of rows of the matrix.
+   * @param offset Number of bytes to skip at the beginning of the file; must be
+   *     a multiple of sizeof(eT).
+   */
+  MappedMatrix(const std::string& filename,
+               const size_t rows,
+               const size_t offset = 0) :
+      mappingSize(0),
+      mapping(Map(filename, rows, offset, mappingSize)),
+      // The memory is read-only, so the matrix must never be written to; it is
+      // only ever exposed as const.
+      matrix(reinterpret_cast<eT*>(mapping + offset), rows,
+          (mappingSize - offset) / (rows * sizeof(eT)), false, true)
+  { /* Nothing to do. */ }
+
+  //! Unmap the file.
+  ~MappedMatrix()
+  {
+  #if defined(__unix__) || defined(__APPLE__)
+    munmap(mapping, mappingSize);
+  #endif
+  }
+
+  // The matrix aliases the mapping, so a MappedMatrix can't be copied.
+  MappedMatrix(const MappedMatrix&) = delete;
+  MappedMatrix& operator=(const MappedMatrix&) = delete;
+
+  //! Get the mapped matrix.
+  const arma::Mat<eT>& Matrix() const { return matrix; }
+
+  //! Advise the operating system that the columns will be read in order, so
+  //! that it reads ahead aggressively and drops pages behind.
+  void AdviseSequential() const { Advise(0, matrix.n_cols, Sequential); }
+
+  //! Advise the operating system that the columns will be read in random
+  //! order, so that it does not read ahead.
+  void AdviseRandom() const { Advise(0, matrix.n_cols, Random); }
+
+  //! Restore the default access advice.
+  void AdviseNormal() const { Advise(0, matrix.n_cols, Normal); }
+
+  /**
+   * Ask the operating system to start reading the given columns, e.g. the
+   * next batch while the current one is processed.
+   *
+   * @param begin First column.
+   * @param count Number of columns.
+   */
+  void Prefetch(const size_t begin, const size_t count) const
+  {
+    Advise(begin, count, WillNeed);
+  }
+
+  /**
+   * Tell the operating system that the given columns will not be needed soon,
+   * so that their pages can be dropped.  They are read again from the file if
+   * they are accessed later.
+   *
+   * @param begin First column.
+   * @param count Number of columns.
+   */
+  void Evict(const size_t begin, const size_t count) const
+  {
+    Advise(begin, count, DontNeed);
+  }
+
+ private:
+  //! The kinds of advice that can be given about the access pattern.
+  enum AdviceType { Normal, Sequential, Random, WillNeed, DontNeed };
+
+  /**
+   * Map the given file and return the start of the mapping; the size of the
+   * mapping is stored in mappingSize.
+   */
+  static char* Map(const std::string& filename,
+                   const size_t rows,
+                   const size_t offset,
+                   size_t& mappingSize)
+  {
+    if (rows == 0)
+    {
+      throw std::invalid_argument("MappedMatrix::MappedMatrix(): the number "
+          "of rows must be positive");
+    }
+
+    if (offset % sizeof(eT) != 0)
+    {
+      throw std::invalid_argument("MappedMatrix::MappedMatrix(): the offset "
+          "must be a multiple of the element size");
+    }
+
+  #if defined(__unix__) || defined(__APPLE__)
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+      throw std::runtime_error("MappedMatrix::MappedMatrix(): cannot open '" +
+          filename + "'");
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+      close(fd);
+      throw std::runtime_error("MappedMatrix::MappedMatrix(): cannot stat '" +
+          filename + "'");
+    }
+
+    const size_t fileSize = size_t(fileStat.st_size);
+    const size_t cols = (fileSize > offset) ?
+        (fileSize - offset) / (rows * sizeof(eT)) : 0;
+    if (cols == 0)
+    {
+      close(fd);
+      throw std::runtime_error("MappedMatrix::MappedMatrix(): '" + filename +
+          "' does not hold a full column");
+    }
+
+    mappingSize = offset + rows * cols * sizeof(eT);
+    void* address = mmap(NULL, mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after the file is closed.
+    close(fd);
+    if (address == MAP_FAILED)
+    {
+      throw std::runtime_error("MappedMatrix::MappedMatrix(): cannot map '" +
+          filename + "'");
+    }
+
+    return static_cast<char*>(address);
+  #else
+    (void) filename;
+    (void) mappingSize;
+    throw std::runtime_error("MappedMatrix::MappedMatrix(): memory mapping is "
+        "not supported on this platform");
+  #endif
+  }
+
+  //! Give the given advice for the pages holding the given columns.  Advice is
+  //! only a hint, so failures are ignored.
+  void Advise(const size_t begin,
+              const size_t count,
+              const AdviceType advice) const
+  {
+  #if defined(__unix__) || defined(__APPLE__)
+    if (count == 0 || begin >= matrix.n_cols)
+      return;
+
+    int flag = MADV_NORMAL;
+    switch (advice)
+    {
+      case Sequential: flag = MADV_SEQUENTIAL; break;
+      case Random: flag = MADV_RANDOM; break;
+      case WillNeed: flag = MADV_WILLNEED; break;
+      case DontNeed: flag = MADV_DONTNEED; break;
+      default: break;
+    }
+
+    const size_t end = std::min(begin + count, size_t(matrix.n_cols));
+    const char* first = reinterpret_cast<const char*>(matrix.colptr(begin));
+    const char* last = reinterpret_cast<const char*>(matrix.colptr(end - 1) +
+        matrix.n_rows);
+
+    // madvise() needs a page-aligned address.
+    const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    const size_t alignedBegin = (size_t(first - mapping) / pageSize) *
+        pageSize;
+    madvise(mapping + alignedBegin, size_t(last - mapping) - alignedBegin,
+        flag);
+  #else
+    (void) begin;
+    (void) count;
+    (void) advice;
+  #endif
+  }
+
+  //! The size of the mapping in bytes.
+  size_t mappingSize;
+  //! The start of the mapping.
+  char* mapping;
+  //! The matrix, an alias of the mapping.
+  arma::Mat<eT> matrix;
+};
+
+} // namespace ens
+
+#endif
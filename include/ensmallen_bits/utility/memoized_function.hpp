@@ -0,0 +1,229 @@
+/**
+ * @file memoized_function.hpp
+ * @author agent
+ *
+ * A wrapper that caches the objective values of a function, so that repeated
+ * evaluations at the same point are not recomputed.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_MEMOIZED_FUNCTION_HPP
+#define ENSMALLEN_UTILITY_MEMOIZED_FUNCTION_HPP
+
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+
+namespace ens {
+
+/**
+ * MemoizedFunction wraps a function with an Evaluate() method, and remembers
+ * the objective of every point it is evaluated at.  The points are keyed by a
+ * hash of their dimensions and elements, and are compared exactly, so a
+ * cached objective is only returned for a bit-identical point.  This helps
+ * optimizers that evaluate the same points repeatedly, such as population
+ * optimizers whose candidates survive unchanged, or a grid search over a grid
+ * with repeated points.
+ *
+ * Every cached point is a copy, so the cache holds a bounded number of points;
+ * when it is full, the oldest point is dropped.  For a population optimizer,
+ * a cache of a few generations is enough:
+ *
+ * @code
+ * CNE optimizer(500);
+ * MemoizedFunction<RosenbrockFunction> memoized(f, 2 * 500);
+ * optimizer.Optimize(memoized, coordinates);
+ * @endcode
+ *
+ * Evaluate() may be called concurrently, if the wrapped function's Evaluate()
+ * may be; the cache is only locked for the lookup and the insertion, not for
+ * the evaluation.
+ *
+ * @tparam FunctionType Type of the wrapped function.
+ * @tparam MatType Type of the points.
+ */
+template<typename FunctionType, typename MatType = arma::mat>
+class MemoizedFunction
+{
+ public:
+  //! The type of the objective.
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Wrap the given function.  The function is not copied, so it must outlive
+   * the wrapper.
+   *
+   * @param function Function to wrap.
+   * @param maxEntries Maximum number of cached points (0 means no limit); when
+   *     the cache is full, the oldest point is dropped.
+   */
+  MemoizedFunction(FunctionType& function, const size_t maxEntries = 1000) :
+      function(function),
+      maxEntries(maxEntries),
+      hits(0),
+      misses(0)
+  { /* Nothing to do. */ }
+
+  /**
+   * Return the objective at the given point, from the cache if the point has
+   * been evaluated before.
+   *
+   * @param coordinates The point to evaluate the function at.
+   */
+  ElemType Evaluate(const MatType& coordinates)
+  {
+    const size_t hash = Hash(coordinates);
+
+    bool found = false;
+    ElemType objective = 0;
+    ENS_PRAGMA_OMP_CRITICAL
+    {
+      typedef typename CacheType::const_iterator IteratorType;
+      const std::pair<IteratorType, IteratorType> range =
+          cache.equal_range(hash);
+      for (IteratorType it = range.first; it != range.second; ++it)
+      {
+        if (Equal(it->second.first, coordinates))
+        {
+          objective = it->second.second;
+          found = true;
+          break;
+        }
+      }
+
+      if (found)
+        ++hits;
+      else
+        ++misses;
+    }
+
+    if (found)
+      return objective;
+
+    objective = function.Evaluate(coordinates);
+
+    ENS_PRAGMA_OMP_CRITICAL
+    {
+      // Another thread may have evaluated the same point in the meantime; the
+      // duplicate entry is harmless.
+      while (maxEntries != 0 && cache.size() >= maxEntries)
+        DropOldest();
+
+      const typename CacheType::iterator it = cache.emplace(hash,
+          std::make_pair(MatType(coordinates), objective));
+      order.push_back(std::make_pair(hash, &it->second.first));
+    }
+
+    return objective;
+  }
+
+  //! Remove all cached points, and reset the counters.
+  void Clear()
+  {
+    cache.clear();
+    order.clear();
+    hits = 0;
+    misses = 0;
+  }
+
+  //! Get the wrapped function.
+  const FunctionType& Function() const { return function; }
+  //! Modify the wrapped function.
+  FunctionType& Function() { return function; }
+
+  //! Get the maximum number of cached points (0 means no limit).
+  size_t MaxEntries() const { return maxEntries; }
+  //! Modify the maximum number of cached points (0 means no limit).
+  size_t& MaxEntries() { return maxEntries; }
+
+  //! Get the number of cached points.
+  size_t Entries() const { return cache.size(); }
+
+  //! Get the number of evaluations answered from the cache.
+  size_t Hits() const { return hits; }
+
+  //! Get the number of evaluations of the wrapped function.
+  size_t Misses() const { return misses; }
+
+ private:
+  //! The cached points and their objectives, by hash.
+  typedef std::unordered_multimap<size_t, std::pair<MatType, ElemType>>
+      CacheType;
+
+  //! Hash the dimensions and the bytes of the elements of the given point
+  //! (FNV-1a).
+  static size_t Hash(const MatType& coordinates)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    const auto mix = [&hash](const unsigned char* bytes, const size_t n)
+    {
+      for (size_t i = 0; i < n; ++i)
+      {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+      }
+    };
+
+    const size_t dims[2] = { size_t(coordinates.n_rows),
+                             size_t(coordinates.n_cols) };
+    mix(reinterpret_cast<const unsigned char*>(dims), sizeof(dims));
+    mix(reinterpret_cast<const unsigned char*>(coordinates.memptr()),
+        coordinates.n_elem * sizeof(ElemType));
+
+    return size_t(hash);
+  }
+
+  //! Remove the point that was cached first.
+  void DropOldest()
+  {
+    const std::pair<size_t, const MatType*> oldest = order.front();
+    order.pop_front();
+
+    // The entries are found by the address of their point, since iterators of
+    // the cache are invalidated when it is rehashed.
+    typedef typename CacheType::iterator IteratorType;
+    const std::pair<IteratorType, IteratorType> range =
+        cache.equal_range(oldest.first);
+    for (IteratorType it = range.first; it != range.second; ++it)
+    {
+      if (&it->second.first == oldest.second)
+      {
+        cache.erase(it);
+        break;
+      }
+    }
+  }
+
+  //! Whether the two points are bit-identical.
+  static bool Equal(const MatType& a, const MatType& b)
+  {
+    return a.n_rows == b.n_rows && a.n_cols == b.n_cols &&
+        std::memcmp(a.memptr(), b.memptr(), a.n_elem * sizeof(ElemType)) == 0;
+  }
+
+  //! The wrapped function.
+  FunctionType& function;
+
+  //! The maximum number of cached points.
+  size_t maxEntries;
+
+  //! The cached points.
+  CacheType cache;
+
+  //! The hashes and the addresses of the cached points, from the oldest to the
+  //! newest.
+  std::deque<std::pair<size_t, const MatType*>> order;
+
+  //! The number of evaluations answered from the cache.
+  size_t hits;
+
+  //! The number of evaluations of the wrapped function.
+  size_t misses;
+};
+
+} // namespace ens
+
+#endif
@@ -0,0 +1,87 @@
+/**
+ * @file visitation_order.hpp
+ * @author agent
+ *
+ * Utilities for functions that shuffle their points through a permutation
+ * vector instead of reordering their data.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef ENSMALLEN_UTILITY_VISITATION_ORDER_HPP
+#define ENSMALLEN_UTILITY_VISITATION_ORDER_HPP
+
+namespace ens {
+
+/**
+ * Generate a random visitation order of the given number of points.  The
+ * points are split into blocks of blockSize consecutive points; the order of
+ * the blocks is shuffled, and the points of each block are visited in order.
+ * With a block size of 1, every point is shuffled individually; larger blocks
+ * keep batches of consecutive points together, so that gathering a batch
+ * reads contiguous memory.
+ *
+ * @param numPoints Number of points.
+ * @param blockSize Number of consecutive points that are kept together.
+ * @param order Vector to store the visitation order in.
+ */
+inline void ShuffleVisitationOrder(const size_t numPoints,
+                                   const size_t blockSize,
+                                   arma::uvec& order)
+{
+  order.set_size(numPoints);
+  if (numPoints == 0)
+    return;
+
+  if (blockSize <= 1)
+  {
+    order = arma::shuffle(arma::linspace<arma::uvec>(0, numPoints - 1,
+        numPoints));
+    return;
+  }
+
+  const size_t numBlocks = (numPoints + blockSize - 1) / blockSize;
+  const arma::uvec blockOrder = arma::shuffle(arma::linspace<arma::uvec>(0,
+      numBlocks - 1, numBlocks));
+
+  size_t i = 0;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockBegin = blockOrder[b] * blockSize;
+    const size_t blockEnd = std::min(blockBegin + blockSize, numPoints);
+    for (size_t j = blockBegin; j < blockEnd; ++j)
+      order[i++] = j;
+  }
+}
+
+/**
+ * Return true if the given range of the visitation order refers to consecutive
+ * points in increasing order, so that the batch can be accessed without
+ * gathering it.  An empty visitation order is the identity.
+ *
+ * @param order Visitation order.
+ * @param begin First index of the range.
+ * @param batchSize Number of indices in the range.
+ */
+inline bool IsContiguousBatch(const arma::uvec& order,
+                              const size_t begin,
+                              const size_t batchSize)
+{
+  if (order.is_empty())
+    return true;
+
+  const arma::uword first = order[begin];
+  for (size_t i = 1; i < batchSize; ++i)
+  {
+    if (order[begin + i] != first + i)
+      return false;
+  }
+
+  return true;
+}
+
+} // namespace ens
+
+#endif
@@ -33,6 +33,25 @@ TEST_CASE("SimpleAdaGradTestFunction", "[AdaGradTest]")
   REQUIRE(coordinates[2] == Approx(0.0).margin(0.003));
 }
 
+/**
+ * Run AdaGrad with sparse gradients, so that only the touched coordinates are
+ * updated in each step.
+ */
+TEST_CASE("AdaGradSparseGradientTest", "[AdaGradTest]")
+{
+  SparseTestFunction f;
+  AdaGrad optimizer(0.99, 1, 1e-8, 500000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+      coordinates);
+
+  REQUIRE(coordinates[0] == Approx(2.0).epsilon(0.003));
+  REQUIRE(coordinates[1] == Approx(1.0).epsilon(0.003));
+  REQUIRE(coordinates[2] == Approx(1.5).epsilon(0.003));
+  REQUIRE(coordinates[3] == Approx(4.0).epsilon(0.003));
+}
+
 /**
  * Run AdaGrad on logistic regression and make sure the results are acceptable.
  */
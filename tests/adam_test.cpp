@@ -35,6 +35,25 @@ TEST_CASE("AdamSphereFunctionTest", "[AdamTest]")
   REQUIRE(coordinates[1] == Approx(0.0).margin(0.1));
 }
 
+/**
+ * Run Adam with sparse gradients; the lazy update only touches the coordinates
+ * that have a nonzero gradient in each step.
+ */
+TEST_CASE("AdamSparseGradientTest", "[AdamTest]")
+{
+  SparseTestFunction f;
+  Adam optimizer(1e-2, 1, 0.9, 0.999, 1e-8, 500000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+      coordinates);
+
+  REQUIRE(coordinates[0] == Approx(2.0).margin(0.1));
+  REQUIRE(coordinates[1] == Approx(1.0).margin(0.1));
+  REQUIRE(coordinates[2] == Approx(1.5).margin(0.1));
+  REQUIRE(coordinates[3] == Approx(4.0).margin(0.1));
+}
+
 /**
  * Test the Adam optimizer on the Wood function.
  */
@@ -185,6 +204,36 @@ TEST_CASE("AdamLogisticRegressionTest", "[AdamTest]")
   REQUIRE(testAcc == Approx(100.0).epsilon(0.006)); // 0.6% error tolerance.
 }
 
+/**
+ * Run Adam on logistic regression with arma::fmat data and coordinates and make
+ * sure the results are acceptable.
+ */
+TEST_CASE("AdamLogisticRegressionFMatTest", "[AdamTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  arma::fmat fData = arma::conv_to<arma::fmat>::from(data);
+  arma::fmat fTestData = arma::conv_to<arma::fmat>::from(testData);
+  arma::fmat fShuffledData = arma::conv_to<arma::fmat>::from(shuffledData);
+  LogisticRegression<arma::fmat> lr(fShuffledData, shuffledResponses, 0.5);
+
+  Adam adam;
+  arma::fmat coordinates = lr.GetInitialPoint();
+  adam.Optimize(lr, coordinates);
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(fData, responses, coordinates);
+  REQUIRE(acc == Approx(100.0).epsilon(0.003)); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(fTestData, testResponses,
+      coordinates);
+  REQUIRE(testAcc == Approx(100.0).epsilon(0.006)); // 0.6% error tolerance.
+}
+
 /**
  * Run AdaMax on logistic regression and make sure the results are acceptable.
  */
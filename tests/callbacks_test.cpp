@@ -0,0 +1,258 @@
+/**
+ * @file callbacks_test.cpp
+ * @author agent
+ *
+ * Test the optimizer callbacks.
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Callback that requests termination after a given number of steps.
+ */
+class StopAfterSteps
+{
+ public:
+  StopAfterSteps(const size_t maxSteps) : maxSteps(maxSteps), steps(0) { }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool StepTaken(OptimizerType& /* optimizer */,
+                 FunctionType& /* function */,
+                 MatType& /* coordinates */)
+  {
+    return (++steps >= maxSteps);
+  }
+
+ private:
+  size_t maxSteps;
+  size_t steps;
+};
+
+/**
+ * Callback that counts the epochs that begin and end.
+ */
+class EpochCounter
+{
+ public:
+  EpochCounter() : begun(0), ended(0) { }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double /* objective */)
+  {
+    ++begun;
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    ++ended;
+  }
+
+  size_t begun;
+  size_t ended;
+};
+
+/**
+ * Make sure the built-in callbacks see the events of SGD.
+ */
+TEST_CASE("SGDCallbacksTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+  StandardSGD s(0.0003, 1, 3000, 1e-9, true);
+
+  EvaluationCounter counter;
+  GradientNormTrace trace;
+  PhaseTimer timer;
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, counter, trace, timer);
+
+  // SGDTestFunction has three functions and the batch size is one.
+  REQUIRE(counter.Steps() == 3000);
+  REQUIRE(counter.Evaluations() == 3000);
+  REQUIRE(counter.Gradients() == 3000);
+  REQUIRE(counter.Epochs() == 1000);
+  REQUIRE(trace.Norms().size() == 3000);
+  REQUIRE(timer.EpochTimes().size() == 1000);
+
+  REQUIRE(timer.TotalTime() >= 0.0);
+  REQUIRE(timer.EvaluationTime() >= 0.0);
+  REQUIRE(timer.StepTime() >= 0.0);
+  REQUIRE(timer.EvaluationTime() + timer.StepTime() <=
+      timer.TotalTime() + 1e-6);
+}
+
+/**
+ * Make sure that a callback returning true terminates SGD, and that the
+ * callbacks are forwarded by the optimizers built on SGD.
+ */
+TEST_CASE("AdamCallbackTerminationTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+  Adam optimizer(0.01, 1, 0.9, 0.999, 1e-8, 0, 1e-20, true);
+
+  EvaluationCounter counter;
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates, counter, StopAfterSteps(25));
+
+  REQUIRE(counter.Steps() == 25);
+  REQUIRE(counter.Gradients() == 25);
+}
+
+/**
+ * Make sure that EarlyStopAtMinLoss terminates an optimization that does not
+ * make progress.
+ */
+TEST_CASE("EarlyStopAtMinLossTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+  // With a step size of zero the objective never improves.
+  StandardSGD s(0.0, 3, 0, 0.0, false);
+
+  EvaluationCounter counter;
+
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, EarlyStopAtMinLoss(5), counter);
+
+  // The first epoch sets the best objective; five more epochs do not improve
+  // it.
+  REQUIRE(counter.Epochs() == 6);
+}
+
+/**
+ * Make sure the callbacks see the evaluations of L-BFGS.
+ */
+TEST_CASE("LBFGSCallbacksTest", "[CallbacksTest]")
+{
+  RosenbrockFunction f;
+  L_BFGS lbfgs;
+  lbfgs.MaxIterations() = 10000;
+
+  EvaluationCounter counter;
+  GradientNormTrace trace;
+
+  arma::mat coords = f.GetInitialPoint();
+  lbfgs.Optimize(f, coords, counter, trace);
+
+  REQUIRE(counter.Steps() > 0);
+  REQUIRE(counter.Evaluations() > counter.Steps());
+  REQUIRE(counter.Gradients() == counter.Evaluations());
+  REQUIRE(trace.Norms().size() == counter.Gradients());
+  REQUIRE(counter.Epochs() == 0);
+
+  // The last gradient is evaluated at the minimum.
+  REQUIRE(trace.Norms().back() == Approx(0.0).margin(1e-2));
+
+  // Stop L-BFGS early.
+  coords = f.GetInitialPoint();
+  lbfgs.Optimize(f, coords, counter, StopAfterSteps(3));
+  REQUIRE(counter.Steps() == 3);
+}
+
+/**
+ * Make sure the callbacks see the epochs and steps of SVRG.
+ */
+TEST_CASE("SVRGCallbacksTest", "[CallbacksTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+  SVRG optimizer(0.005, 50, 5, 0, 1e-20, true);
+
+  EvaluationCounter counter;
+  PhaseTimer timer;
+
+  arma::mat coordinates = lr.GetInitialPoint();
+  optimizer.Optimize(lr, coordinates, counter, timer);
+
+  // One full objective per outer iteration; the inner iterations take two
+  // gradients per step and the full gradient is one more per epoch.
+  REQUIRE(counter.Evaluations() == 5);
+  REQUIRE(counter.Epochs() == 5);
+  REQUIRE(counter.Gradients() == 2 * counter.Steps() + 5);
+  REQUIRE(timer.EpochTimes().size() == 5);
+}
+
+/**
+ * Every epoch that begins must also end, including the last one, when the
+ * maximum number of iterations is reached in the middle of it or a callback
+ * terminates the optimization.
+ */
+TEST_CASE("EpochCallbacksPairedTest", "[CallbacksTest]")
+{
+  SGDTestFunction f;
+
+  // SGDTestFunction has three functions, so the last epoch is cut short.
+  StandardSGD s(0.0003, 1, 3001, 1e-9, true);
+  EpochCounter epochs;
+  arma::mat coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, epochs);
+  REQUIRE(epochs.begun == 1001);
+  REQUIRE(epochs.ended == 1001);
+
+  // The maximum number of iterations ends an epoch.
+  s.MaxIterations() = 3000;
+  EpochCounter fullEpochs;
+  coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, fullEpochs);
+  REQUIRE(fullEpochs.begun == 1000);
+  REQUIRE(fullEpochs.ended == 1000);
+
+  // A callback terminates the optimization in the middle of an epoch.
+  s.MaxIterations() = 0;
+  EpochCounter stoppedEpochs;
+  coordinates = f.GetInitialPoint();
+  s.Optimize(f, coordinates, stoppedEpochs, StopAfterSteps(10));
+  REQUIRE(stoppedEpochs.begun == 4);
+  REQUIRE(stoppedEpochs.ended == 4);
+
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+  SVRG optimizer(0.005, 50, 5, 0, 1e-20, true);
+  EpochCounter svrgEpochs;
+  coordinates = lr.GetInitialPoint();
+  optimizer.Optimize(lr, coordinates, svrgEpochs);
+  REQUIRE(svrgEpochs.begun == 5);
+  REQUIRE(svrgEpochs.ended == 5);
+
+  EpochCounter stoppedSVRGEpochs;
+  coordinates = lr.GetInitialPoint();
+  optimizer.Optimize(lr, coordinates, stoppedSVRGEpochs, StopAfterSteps(3));
+  REQUIRE(stoppedSVRGEpochs.begun == 1);
+  REQUIRE(stoppedSVRGEpochs.ended == 1);
+
+  SLBFGS slbfgs(0.005, 32, 5, 0, 10, 10, 200, 1e-20, true);
+  EpochCounter slbfgsEpochs;
+  coordinates = lr.GetInitialPoint();
+  slbfgs.Optimize(lr, coordinates, slbfgsEpochs);
+  REQUIRE(slbfgsEpochs.begun == 5);
+  REQUIRE(slbfgsEpochs.ended == 5);
+}
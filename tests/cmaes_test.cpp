@@ -102,3 +102,367 @@ TEST_CASE("ApproxCMAESLogisticRegressionTest", "[CMAESTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Evaluating the offspring in parallel should not change the result for a
+ * given seed, even when the objective of each offspring is estimated from a
+ * random selection of the functions.
+ */
+TEST_CASE("ApproxCMAESParallelEvaluationTest", "[CMAESTest]")
+{
+  SGDTestFunction f;
+
+  ApproxCMAES<> serial(0, -1, 1, 1, 50, -1);
+  ApproxCMAES<> parallel(0, -1, 1, 1, 50, -1, RandomSelection(), 0);
+  REQUIRE(parallel.NumThreads() == 0);
+
+  arma::mat serialCoordinates = f.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double serialObjective = serial.Optimize(f, serialCoordinates);
+
+  arma::mat parallelCoordinates = f.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double parallelObjective = parallel.Optimize(f, parallelCoordinates);
+
+  REQUIRE(parallelObjective == serialObjective);
+  for (size_t i = 0; i < serialCoordinates.n_elem; ++i)
+    REQUIRE(parallelCoordinates[i] == serialCoordinates[i]);
+}
+
+/**
+ * In medium dimensions, CMA-ES should only recompute the eigendecomposition of
+ * the covariance every few generations, and still converge.
+ */
+TEST_CASE("CMAESLazyDecompositionSphereFunctionTest", "[CMAESTest]")
+{
+  const size_t iterations = 300;
+
+  SphereFunction f(50);
+  CMAES<> optimizer(0, -1, 1, 50, iterations, -1);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  const double result = optimizer.Optimize(f, coordinates);
+
+  REQUIRE(result == Approx(0.0).margin(1e-6));
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+    REQUIRE(coordinates[i] == Approx(0.0).margin(1e-3));
+
+  // The default population size gives an update gap of about ten generations.
+  const size_t decompositions = optimizer.CovariancePolicy().Decompositions();
+  REQUIRE(decompositions > 0);
+  REQUIRE(decompositions < iterations / 5);
+}
+
+/**
+ * Both covariance policies must whiten the steps they sample: the transform
+ * used for the step size is the inverse of the transform used for sampling.
+ */
+TEST_CASE("CMAESCovarianceWhitenTest", "[CMAESTest]")
+{
+  const size_t n = 4;
+  const arma::vec w = arma::ones<arma::vec>(3) / 3.0;
+  const arma::mat bestSteps = 3.0 * arma::randn<arma::mat>(n, 3);
+  const arma::vec pc = arma::randn<arma::vec>(n);
+  const arma::mat z = arma::randn<arma::mat>(n, 5);
+
+  FullCovariance full;
+  full.Reset(n, 10);
+  full.Update(0.3, 0.2, pc, 0.5, w, bestSteps);
+  full.Factorize();
+
+  DiagonalCovariance diagonal;
+  diagonal.Reset(n, 10);
+  diagonal.Update(0.3, 0.2, pc, 0.5, w, bestSteps);
+  diagonal.Factorize();
+
+  arma::mat fullSteps, diagonalSteps;
+  full.Transform(z, fullSteps);
+  diagonal.Transform(z, diagonalSteps);
+  for (size_t j = 0; j < z.n_cols; ++j)
+  {
+    const arma::vec fullStep = fullSteps.col(j);
+    const arma::vec diagonalStep = diagonalSteps.col(j);
+    arma::vec fullWhitened, diagonalWhitened;
+    full.Whiten(fullStep, fullWhitened);
+    diagonal.Whiten(diagonalStep, diagonalWhitened);
+    for (size_t i = 0; i < n; ++i)
+    {
+      REQUIRE(fullWhitened[i] == Approx(z(i, j)).margin(1e-8));
+      REQUIRE(diagonalWhitened[i] == Approx(z(i, j)).margin(1e-8));
+    }
+  }
+}
+
+/**
+ * f(x) = sum_i 10^(4 i / (n - 1)) (R x)_i^2 for a random rotation R, an
+ * ill-conditioned quadratic whose axes are not the coordinate axes.
+ */
+class RotatedEllipsoidFunction
+{
+ public:
+  RotatedEllipsoidFunction(const size_t n) : scales(n)
+  {
+    arma::mat r;
+    arma::qr(rotation, r, arma::randn<arma::mat>(n, n));
+    for (size_t i = 0; i < n; ++i)
+      scales[i] = std::pow(10.0, 4.0 * i / (n - 1));
+  }
+
+  size_t NumFunctions() const { return 1; }
+
+  double Evaluate(const arma::mat& coordinates,
+                  const size_t /* begin */,
+                  const size_t /* batchSize */) const
+  {
+    const arma::vec y = rotation * arma::vectorise(coordinates);
+    return arma::dot(scales, arma::square(y));
+  }
+
+ private:
+  arma::mat rotation;
+  arma::vec scales;
+};
+
+/**
+ * Record the step size of CMA-ES at the end of every generation.
+ */
+class StepSizeTrace
+{
+ public:
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  bool EndEpoch(OptimizerType& optimizer,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    stepSizes.push_back(optimizer.StepSize());
+    return false;
+  }
+
+  std::vector<double> stepSizes;
+};
+
+/**
+ * On an ill-conditioned rotated quadratic the step size should first adapt and
+ * then shrink with the distance to the optimum, without collapsing before the
+ * covariance is learned or blowing up.
+ */
+TEST_CASE("CMAESRotatedEllipsoidStepSizeTest", "[CMAESTest]")
+{
+  const size_t trials = 3;
+  bool success = false;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    RotatedEllipsoidFunction f(10);
+    CMAES<> optimizer(0, -1, 1, 1, 250, -1);
+    const double initialStepSize = 0.3 * 2;
+
+    arma::mat coordinates(10, 1, arma::fill::zeros);
+    StepSizeTrace trace;
+    const double result = optimizer.Optimize(f, coordinates, trace);
+
+    REQUIRE(trace.stepSizes.size() > 0);
+    bool sensible = true;
+    for (const double stepSize : trace.stepSizes)
+    {
+      if (!std::isfinite(stepSize) || stepSize <= 0 ||
+          stepSize > 10 * initialStepSize)
+        sensible = false;
+    }
+
+    if (sensible && result < 1e-15 &&
+        trace.stepSizes.back() < initialStepSize / 100)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
+
+/**
+ * Run separable CMA-ES on a simple test function and make sure that only the
+ * diagonal of the covariance is kept.
+ */
+TEST_CASE("SepCMAESSimpleTestFunction", "[CMAESTest]")
+{
+  SGDTestFunction f;
+  SepCMAES<> optimizer(0, -1, 1, 32, 200, -1);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates);
+
+  REQUIRE(coordinates[0] == Approx(0.0).margin(0.003));
+  REQUIRE(coordinates[1] == Approx(0.0).margin(0.003));
+  REQUIRE(coordinates[2] == Approx(0.0).margin(0.003));
+
+  const arma::vec& variance = optimizer.CovariancePolicy().Variance();
+  REQUIRE(variance.n_elem == coordinates.n_elem);
+}
+
+/**
+ * Run separable CMA-ES on logistic regression and make sure the results are
+ * acceptable.
+ */
+TEST_CASE("SepCMAESLogisticRegressionTest", "[CMAESTest]")
+{
+  const size_t trials = 3;
+  bool success = false;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    arma::mat data, testData, shuffledData;
+    arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+    LogisticRegressionTestData(data, testData, shuffledData,
+        responses, testResponses, shuffledResponses);
+    LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+    SepCMAES<> cmaes(0, -1, 1, 32, 200, 1e-3);
+    arma::mat coordinates = lr.GetInitialPoint();
+    cmaes.Optimize(lr, coordinates);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+    const double testAcc = lr.ComputeAccuracy(testData, testResponses,
+        coordinates);
+    if (acc >= 99.7 && testAcc >= 99.4)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
+
+/**
+ * Callback that counts the optimizations and epochs that begin and end.
+ */
+class RunCounter
+{
+ public:
+  RunCounter() :
+      optimizationsBegun(0),
+      optimizationsEnded(0),
+      epochsBegun(0),
+      epochsEnded(0)
+  { }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginOptimization(OptimizerType& /* optimizer */,
+                         FunctionType& /* function */,
+                         MatType& /* coordinates */)
+  {
+    ++optimizationsBegun;
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndOptimization(OptimizerType& /* optimizer */,
+                       FunctionType& /* function */,
+                       MatType& /* coordinates */)
+  {
+    ++optimizationsEnded;
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void BeginEpoch(OptimizerType& /* optimizer */,
+                  FunctionType& /* function */,
+                  const MatType& /* coordinates */,
+                  const size_t /* epoch */,
+                  const double /* objective */)
+  {
+    ++epochsBegun;
+  }
+
+  template<typename OptimizerType, typename FunctionType, typename MatType>
+  void EndEpoch(OptimizerType& /* optimizer */,
+                FunctionType& /* function */,
+                const MatType& /* coordinates */,
+                const size_t /* epoch */,
+                const double /* objective */)
+  {
+    ++epochsEnded;
+  }
+
+  size_t optimizationsBegun;
+  size_t optimizationsEnded;
+  size_t epochsBegun;
+  size_t epochsEnded;
+};
+
+/**
+ * IPOP-CMA-ES passes its callbacks to every run.
+ */
+TEST_CASE("IPOPCMAESCallbacksTest", "[CMAESTest]")
+{
+  RastriginFunction f(2);
+  CMAES<> cmaes(0, -5.12, 5.12, 1, 50, -1);
+  IPOP_CMAES<> optimizer(cmaes, 2, 3);
+
+  RunCounter counter;
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize(f, coordinates, counter);
+
+  REQUIRE(counter.optimizationsBegun == 4);
+  REQUIRE(counter.optimizationsEnded == 4);
+  REQUIRE(counter.epochsBegun > 0);
+  REQUIRE(counter.epochsBegun == counter.epochsEnded);
+  REQUIRE(counter.epochsEnded <= 4 * 49);
+}
+
+/**
+ * IPOP-CMA-ES should escape from the local minima of the Rastrigin function.
+ */
+TEST_CASE("IPOPCMAESRastriginFunctionTest", "[CMAESTest]")
+{
+  const size_t trials = 3;
+  bool success = false;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    RastriginFunction f(2);
+    CMAES<> cmaes(0, -5.12, 5.12, 1, 1000, 1e-10);
+    IPOP_CMAES<> optimizer(cmaes, 2, 5);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    const double result = optimizer.Optimize(f, coordinates);
+
+    if (std::abs(result) < 1e-3 && std::abs(coordinates[0]) < 1e-3 &&
+        std::abs(coordinates[1]) < 1e-3)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
+
+/**
+ * BIPOP-CMA-ES with concurrent runs should escape from the local minima of the
+ * Rastrigin function too.
+ */
+TEST_CASE("BIPOPCMAESConcurrentRastriginFunctionTest", "[CMAESTest]")
+{
+  const size_t trials = 3;
+  bool success = false;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    RastriginFunction f(2);
+    CMAES<> cmaes(0, -5.12, 5.12, 1, 1000, 1e-10);
+    IPOP_CMAES<> optimizer(cmaes, 2, 7, true, 0);
+
+    arma::mat coordinates = f.GetInitialPoint();
+    const double result = optimizer.Optimize(f, coordinates);
+
+    if (std::abs(result) < 1e-3 && std::abs(coordinates[0]) < 1e-3 &&
+        std::abs(coordinates[1]) < 1e-3)
+    {
+      success = true;
+      break;
+    }
+  }
+
+  REQUIRE(success == true);
+}
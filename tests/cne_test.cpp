@@ -41,3 +41,93 @@ TEST_CASE("CNELogisticRegressionTest", "[CNETest]")
       coordinates);
   REQUIRE(testAcc == Approx(100.0).epsilon(0.006)); // 0.6% error tolerance.
 }
+
+/**
+ * Evaluating the population in parallel should not change the result for a
+ * given seed.
+ */
+TEST_CASE("CNEParallelEvaluationTest", "[CNETest]")
+{
+  RosenbrockFunction f;
+
+  CNE serial(40, 50, 0.2, 0.2, 0.3, -1, -1);
+  CNE parallel(40, 50, 0.2, 0.2, 0.3, -1, -1, 0);
+  REQUIRE(parallel.NumThreads() == 0);
+
+  arma::mat serialCoordinates = f.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double serialObjective = serial.Optimize(f, serialCoordinates);
+
+  arma::mat parallelCoordinates = f.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double parallelObjective = parallel.Optimize(f, parallelCoordinates);
+
+  REQUIRE(parallelObjective == serialObjective);
+  for (size_t i = 0; i < serialCoordinates.n_elem; ++i)
+    REQUIRE(parallelCoordinates[i] == serialCoordinates[i]);
+}
+
+/**
+ * Count the evaluations of the Rosenbrock function.
+ */
+class CountingRosenbrockFunction : public RosenbrockFunction
+{
+ public:
+  CountingRosenbrockFunction() : evaluations(0) { }
+
+  double Evaluate(const arma::mat& coordinates)
+  {
+    ++evaluations;
+    return RosenbrockFunction::Evaluate(coordinates);
+  }
+
+  size_t evaluations;
+};
+
+/**
+ * CNE should only evaluate the candidates that changed, and a MemoizedFunction
+ * should answer repeated evaluations from its cache.
+ */
+TEST_CASE("CNEMemoizedFunctionTest", "[CNETest]")
+{
+  const size_t populationSize = 40;
+  const size_t generations = 50;
+  CNE opt(populationSize, generations, 0.2, 0.2, 0.3, -1, -1);
+
+  // Without the cache: the initial point, and after the first generation at
+  // most populationSize - 1 candidates per generation, since the best one is
+  // never changed.  The other 11 elite candidates are each left untouched by
+  // the mutation with probability 0.8^2, so about 7 more are reused per
+  // generation.
+  CountingRosenbrockFunction f;
+  arma::mat coordinates = f.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double objective = opt.Optimize(f, coordinates);
+  const size_t evaluations = f.evaluations;
+
+  REQUIRE(evaluations <= 1 + populationSize +
+      (generations - 1) * (populationSize - 1));
+  REQUIRE(evaluations < 1 + populationSize +
+      (generations - 1) * (populationSize - 6));
+
+  // With the cache, the same seed gives the same result, but children that are
+  // copies of their parents are not evaluated again.
+  CountingRosenbrockFunction g;
+  MemoizedFunction<CountingRosenbrockFunction> memoized(g,
+      2 * populationSize);
+  arma::mat memoizedCoordinates = g.GetInitialPoint();
+  arma::arma_rng::set_seed(42);
+  const double memoizedObjective = opt.Optimize(memoized, memoizedCoordinates);
+
+  REQUIRE(memoizedObjective == objective);
+  REQUIRE(memoized.Hits() + memoized.Misses() == evaluations);
+  REQUIRE(memoized.Hits() > 0);
+  REQUIRE(g.evaluations < evaluations);
+  REQUIRE(memoized.Entries() <= 2 * populationSize);
+
+  // Evaluating a point again is answered from the cache.
+  const size_t misses = memoized.Misses();
+  REQUIRE(memoized.Evaluate(memoizedCoordinates) == Approx(objective));
+  REQUIRE(memoized.Evaluate(memoizedCoordinates) == Approx(objective));
+  REQUIRE(memoized.Misses() <= misses + 1);
+}
@@ -330,6 +330,41 @@ TEST_CASE("LogisticRegressionEvaluateWithGradientTest", "[FunctionTest]")
   REQUIRE(hasEvaluateWithGradient == true);
 }
 
+/**
+ * Make sure that Function<> recognizes and adds methods for arma::fmat when
+ * the FunctionType is written for single-precision coordinates.
+ */
+TEST_CASE("LogisticRegressionFMatEvaluateWithGradientTest", "[FunctionTest]")
+{
+  typedef Function<LogisticRegressionFunction<arma::fmat>, arma::fmat>
+      FunctionType;
+  typedef TypedForms<arma::fmat> Forms;
+
+  const bool hasEvaluate =
+      HasEvaluate<FunctionType, Forms::EvaluateConstForm>::value;
+  const bool hasGradient =
+      HasGradient<FunctionType, Forms::GradientConstForm>::value;
+  const bool hasEvaluateWithGradient =
+      HasEvaluateWithGradient<FunctionType,
+                              Forms::EvaluateWithGradientConstForm>::value;
+  const bool hasDecomposableEvaluate =
+      HasEvaluate<FunctionType, Forms::DecomposableEvaluateConstForm>::value;
+
+  REQUIRE(hasEvaluate == true);
+  REQUIRE(hasGradient == true);
+  REQUIRE(hasEvaluateWithGradient == true);
+  REQUIRE(hasDecomposableEvaluate == true);
+
+  // The double-precision forms should not match.
+  const bool hasDoubleEvaluate =
+      HasEvaluate<FunctionType, EvaluateConstForm>::value;
+  REQUIRE(hasDoubleEvaluate == false);
+
+  static_assert(CheckDecomposableEvaluateWithGradient<FunctionType,
+      arma::fmat>::value, "CheckDecomposableEvaluateWithGradient static check "
+      "failed.");
+}
+
 TEST_CASE("SDPTest", "[FunctionTest]")
 {
   typedef AugLagrangianFunction<LRSDPFunction<SDP<arma::mat>>> FunctionType;
@@ -47,3 +47,59 @@ TEST_CASE("IQNLogisticRegressionTest", "[IQNTest]")
     REQUIRE(testAcc == Approx(100.0).epsilon(0.016)); // 1.6% error tolerance.
   }
 }
+
+/**
+ * After several passes, the inverse Hessian approximation maintained by IQN
+ * must still be the inverse of the Hessian approximation.
+ */
+TEST_CASE("IQNHessianInverseTest", "[IQNTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+  IQN iqn(0.01, 1, 6, 1e-10);
+  arma::mat coordinates = lr.GetInitialPoint();
+  iqn.Optimize(lr, coordinates);
+
+  const arma::mat product = iqn.HessianInverse() * iqn.Hessian();
+  REQUIRE(product.n_rows == coordinates.n_elem);
+  for (size_t i = 0; i < product.n_rows; ++i)
+  {
+    for (size_t j = 0; j < product.n_cols; ++j)
+      REQUIRE(product(i, j) == Approx(i == j ? 1.0 : 0.0).margin(1e-5));
+  }
+}
+
+/**
+ * Run limited-memory IQN on logistic regression and make sure the results are
+ * acceptable.
+ */
+TEST_CASE("LIQNLogisticRegressionTest", "[IQNTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  for (size_t batchSize = 1; batchSize < 9; batchSize += 4)
+  {
+    L_IQN iqn(0.01, batchSize, 5000, 1e-3, 3);
+    LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+    arma::mat coordinates = lr.GetInitialPoint();
+    iqn.Optimize(lr, coordinates);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+    REQUIRE(acc == Approx(100.0).epsilon(0.013)); // 1.3% error tolerance.
+
+    const double testAcc = lr.ComputeAccuracy(testData, testResponses,
+      coordinates);
+    REQUIRE(testAcc == Approx(100.0).epsilon(0.016)); // 1.6% error tolerance.
+  }
+}
@@ -127,3 +127,291 @@ TEST_CASE("RosenbrockWoodFunctionTest", "[LBFGSTest]")
     REQUIRE((coords(row, 1)) == Approx(1.0).epsilon(1e-7));
   }
 }
+
+/**
+ * Tests L-BFGS with the More-Thuente line search on the Rosenbrock and Wood
+ * functions; the returned objective must be the objective of the final point.
+ */
+TEST_CASE("MoreThuenteLineSearchTest", "[LBFGSTest]")
+{
+  RosenbrockFunction f;
+  MoreThuenteL_BFGS lbfgs;
+  lbfgs.MaxIterations() = 10000;
+
+  arma::mat coords = f.GetInitialPoint();
+  EvaluationCounter counter;
+  const double objective = lbfgs.Optimize(f, coords, counter);
+
+  REQUIRE(objective == Approx(f.Evaluate(coords)).margin(1e-15));
+  REQUIRE(objective == Approx(0.0).margin(1e-5));
+  REQUIRE(coords[0] == Approx(1.0).epsilon(1e-7));
+  REQUIRE(coords[1] == Approx(1.0).epsilon(1e-7));
+
+  // Most iterations should accept the first trial.
+  REQUIRE(counter.Evaluations() < 2 * counter.Steps() + 10);
+
+  WoodFunction g;
+  arma::mat woodCoords = g.GetInitialPoint();
+  const double woodObjective = lbfgs.Optimize(g, woodCoords);
+
+  REQUIRE(woodObjective == Approx(g.Evaluate(woodCoords)).margin(1e-15));
+  REQUIRE(woodObjective == Approx(0.0).margin(1e-5));
+  for (size_t i = 0; i < 4; ++i)
+    REQUIRE(woodCoords[i] == Approx(1.0).epsilon(1e-7));
+}
+
+/**
+ * The bracketing line search must leave the objective of the accepted point,
+ * not the objective of its last trial.
+ */
+TEST_CASE("BracketingLineSearchObjectiveTest", "[LBFGSTest]")
+{
+  ColvilleFunction f;
+  L_BFGS lbfgs;
+  lbfgs.MaxIterations() = 10000;
+
+  arma::mat coords = f.GetInitialPoint();
+  const double objective = lbfgs.Optimize(f, coords);
+
+  REQUIRE(objective == Approx(f.Evaluate(coords)).margin(1e-15));
+}
+
+/**
+ * f(x) = sum(exp(x) + exp(-x)), which overflows to infinity for large |x|.
+ */
+class OverflowFunction
+{
+ public:
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient) const
+  {
+    gradient = arma::exp(coordinates) - arma::exp(-coordinates);
+    return arma::accu(arma::exp(coordinates) + arma::exp(-coordinates));
+  }
+};
+
+/**
+ * f(x) = sum(x^2 - log(1 - x^2)), which is not a number outside of (-1, 1).
+ */
+class LogBarrierFunction
+{
+ public:
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient) const
+  {
+    gradient = 2 * coordinates + 2 * coordinates /
+        (1 - arma::square(coordinates));
+    return arma::accu(arma::square(coordinates) -
+        arma::log(1 - arma::square(coordinates)));
+  }
+};
+
+/**
+ * Run a line search from the given point along the given direction, and
+ * return whether it succeeded.
+ */
+template<typename LineSearchType, typename FunctionType>
+bool RunLineSearch(FunctionType& f,
+                   arma::mat& iterate,
+                   const arma::mat& searchDirection,
+                   double& functionValue)
+{
+  L_BFGS lbfgs;
+  LineSearchType lineSearch;
+  arma::mat gradient, newIterateTmp;
+  functionValue = f.EvaluateWithGradient(iterate, gradient);
+  bool terminate = false;
+  return lineSearch.Search(lbfgs, f, functionValue, iterate, gradient,
+      newIterateTmp, searchDirection, terminate);
+}
+
+/**
+ * The first full step of the line search overflows (or leaves the domain of
+ * the function); both line searches must back off to a finite point that
+ * decreases the function.
+ */
+template<typename LineSearchType>
+void NonFiniteTrialTest()
+{
+  OverflowFunction f;
+  arma::mat iterate(1, 1);
+  iterate.fill(1.0);
+  const arma::mat searchDirection = -1000.0 * arma::ones<arma::mat>(1, 1);
+  arma::mat gradient;
+  const double initialValue = f.EvaluateWithGradient(iterate, gradient);
+
+  double value;
+  REQUIRE(RunLineSearch<LineSearchType>(f, iterate, searchDirection, value));
+  REQUIRE(std::isfinite(value));
+  REQUIRE(value < initialValue);
+  REQUIRE(value == Approx(f.EvaluateWithGradient(iterate, gradient)));
+
+  LogBarrierFunction g;
+  arma::mat barrierIterate(1, 1);
+  barrierIterate.fill(0.5);
+  const arma::mat barrierDirection = -10.0 * arma::ones<arma::mat>(1, 1);
+  const double barrierInitialValue = g.EvaluateWithGradient(barrierIterate,
+      gradient);
+
+  REQUIRE(RunLineSearch<LineSearchType>(g, barrierIterate, barrierDirection,
+      value));
+  REQUIRE(std::isfinite(value));
+  REQUIRE(value < barrierInitialValue);
+  REQUIRE(std::abs(barrierIterate[0]) < 1.0);
+  REQUIRE(value == Approx(g.EvaluateWithGradient(barrierIterate, gradient)));
+}
+
+TEST_CASE("BracketingLineSearchNonFiniteTrialTest", "[LBFGSTest]")
+{
+  NonFiniteTrialTest<BracketingLineSearch>();
+}
+
+TEST_CASE("MoreThuenteLineSearchNonFiniteTrialTest", "[LBFGSTest]")
+{
+  NonFiniteTrialTest<MoreThuenteLineSearch>();
+}
+
+/**
+ * If no trial of the bracketing line search is finite, the iterate must not
+ * move, and the search must fail and leave the non-finite value.
+ */
+TEST_CASE("BracketingLineSearchAllNonFiniteTest", "[LBFGSTest]")
+{
+  LogBarrierFunction f;
+  arma::mat iterate(1, 1);
+  iterate.fill(-0.5);
+  const arma::mat searchDirection = 1e30 * arma::ones<arma::mat>(1, 1);
+
+  double value;
+  REQUIRE(!RunLineSearch<BracketingLineSearch>(f, iterate, searchDirection,
+      value));
+  REQUIRE(std::isnan(value));
+  REQUIRE(iterate[0] == -0.5);
+}
+
+/**
+ * Tests L-BFGS-B on the Rosenbrock function with bounds that exclude the
+ * unconstrained minimum, which then lies on the boundary.
+ */
+TEST_CASE("LBFGSBRosenbrockBoundTest", "[LBFGSTest]")
+{
+  RosenbrockFunction f;
+  L_BFGS_B lbfgsb(-2.0, 0.5);
+
+  arma::mat coords = f.GetInitialPoint();
+  const double objective = lbfgsb.Optimize(f, coords);
+
+  // With x_1 <= 0.5, the minimum is at (0.5, 0.25).
+  REQUIRE(objective == Approx(0.25).epsilon(1e-5));
+  REQUIRE(coords[0] == Approx(0.5).epsilon(1e-7));
+  REQUIRE(coords[1] == Approx(0.25).epsilon(1e-5));
+}
+
+/**
+ * Tests L-BFGS-B with per-coordinate bounds that contain the minimum, starting
+ * from a point outside of the bounds.
+ */
+TEST_CASE("LBFGSBWoodFunctionTest", "[LBFGSTest]")
+{
+  WoodFunction f;
+  arma::mat lower(4, 1);
+  lower.fill(-3.0);
+  arma::mat upper(4, 1);
+  upper.fill(3.0);
+  upper[2] = 1.5;
+  L_BFGS_B lbfgsb(lower, upper);
+
+  arma::mat coords = f.GetInitialPoint();
+  coords[0] = -5.0;
+  const double objective = lbfgsb.Optimize(f, coords);
+
+  REQUIRE(objective == Approx(0.0).margin(1e-5));
+  for (size_t i = 0; i < 4; ++i)
+    REQUIRE(coords[i] == Approx(1.0).epsilon(1e-5));
+}
+
+/**
+ * Make sure that the compact representation of the L-BFGS history gives the
+ * same direction as the BFGS updates of the last pairs, also after the oldest
+ * pairs have been overwritten.
+ */
+TEST_CASE("LBFGSHistoryCompactRepresentationTest", "[LBFGSTest]")
+{
+  const size_t n = 8;
+  arma::mat a(n, n, arma::fill::randn);
+  a = a * a.t() + n * arma::eye<arma::mat>(n, n);
+
+  LBFGSHistory history(3, n, 1);
+  arma::mat pointS(n, 5, arma::fill::randn);
+  arma::mat pointY = a * pointS;
+  const arma::mat zero(n, 1, arma::fill::zeros);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    history.Update(pointS.col(i), zero, pointY.col(i), zero);
+    REQUIRE(history.Size() == std::min(i + 1, (size_t) 3));
+  }
+
+  const arma::mat gradient(n, 1, arma::fill::randn);
+  const double scalingFactor = history.ScalingFactor(gradient);
+  REQUIRE(scalingFactor == Approx(arma::dot(pointS.col(4), pointY.col(4)) /
+      arma::dot(pointY.col(4), pointY.col(4))));
+
+  arma::mat h = scalingFactor * arma::eye<arma::mat>(n, n);
+  for (size_t i = 2; i < 5; ++i)
+  {
+    const double rho = 1.0 / arma::dot(pointY.col(i), pointS.col(i));
+    const arma::mat v = arma::eye<arma::mat>(n, n) -
+        rho * pointY.col(i) * pointS.col(i).t();
+    h = v.t() * h * v + rho * pointS.col(i) * pointS.col(i).t();
+  }
+
+  arma::mat searchDirection;
+  history.SearchDirection(gradient, scalingFactor, searchDirection);
+
+  const arma::mat expected = -h * gradient;
+  for (size_t i = 0; i < n; ++i)
+    REQUIRE(searchDirection(i) == Approx(expected(i)).epsilon(1e-8));
+}
+
+/**
+ * Make sure that the subspace step of the L-BFGS history minimizes the
+ * quadratic model with the Hessian approximation over the free coordinates.
+ */
+TEST_CASE("LBFGSHistorySubspaceStepTest", "[LBFGSTest]")
+{
+  const size_t n = 8;
+  arma::mat a(n, n, arma::fill::randn);
+  a = a * a.t() + n * arma::eye<arma::mat>(n, n);
+
+  LBFGSHistory history(3, n, 1);
+  arma::mat pointS(n, 5, arma::fill::randn);
+  arma::mat pointY = a * pointS;
+  const arma::mat zero(n, 1, arma::fill::zeros);
+  for (size_t i = 0; i < 5; ++i)
+    history.Update(pointS.col(i), zero, pointY.col(i), zero);
+
+  const arma::mat gradient(n, 1, arma::fill::randn);
+  const double scalingFactor = history.ScalingFactor(gradient);
+
+  // The direct BFGS updates of the last pairs.
+  arma::mat b = arma::eye<arma::mat>(n, n) / scalingFactor;
+  for (size_t i = 2; i < 5; ++i)
+  {
+    const arma::vec bs = b * pointS.col(i);
+    b += pointY.col(i) * pointY.col(i).t() / arma::dot(pointY.col(i),
+        pointS.col(i)) - bs * bs.t() / arma::dot(pointS.col(i), bs);
+  }
+
+  const arma::mat offset(n, 1, arma::fill::randn);
+  const arma::uvec free = { 0, 2, 3, 5, 7 };
+
+  arma::vec step;
+  REQUIRE(history.SubspaceStep(gradient, offset, free, scalingFactor, step));
+
+  const arma::vec residual = gradient + b * offset;
+  const arma::vec expected = -arma::solve(b.submat(free, free),
+      arma::vec(residual.elem(free)));
+  REQUIRE(step.n_elem == free.n_elem);
+  for (size_t i = 0; i < free.n_elem; ++i)
+    REQUIRE(step(i) == Approx(expected(i)).epsilon(1e-8));
+}
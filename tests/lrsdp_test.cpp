@@ -294,3 +294,112 @@ TEST_CASE("GaussianMatrixSensingSDP", "[LRSDPTest]")
       arma::norm(Xorig, "fro");
   REQUIRE(err == Approx(0.0).margin(0.05));
 }
+
+/**
+ * Make sure that the augmented Lagrangian of an LRSDP, which is evaluated
+ * without forming R * R^T, matches the direct evaluation with R * R^T.
+ */
+TEST_CASE("LRSDPAugLagrangianLowRankTest", "[LRSDPTest]")
+{
+  const size_t n = 12;
+  const size_t r = 3;
+  const arma::mat coordinates(n, r, arma::fill::randn);
+
+  LRSDPFunction<SDP<arma::sp_mat>> function(2, 1, coordinates);
+  arma::sp_mat c = arma::sprandn<arma::sp_mat>(n, n, 0.3);
+  function.SDP().C() = c + trans(c);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    arma::sp_mat a = arma::sprandn<arma::sp_mat>(n, n, 0.2);
+    function.SDP().SparseA()[i] = a + trans(a);
+  }
+  arma::mat a(n, n, arma::fill::randn);
+  function.SDP().DenseA()[0] = a + trans(a);
+  function.SDP().SparseB() = arma::vec("1.0 -2.0");
+  function.SDP().DenseB() = arma::vec("0.5");
+
+  const arma::vec lambda("0.3 -1.2 0.7");
+  const double sigma = 2.5;
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> augFunction(
+      function, lambda, sigma);
+
+  // The direct evaluation with R * R^T.
+  const arma::mat rrt = coordinates * trans(coordinates);
+  double expectedObjective = arma::accu(arma::mat(function.SDP().C()) % rrt);
+  arma::mat s(function.SDP().C());
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const arma::mat ai = (i < 2) ? arma::mat(function.SDP().SparseA()[i]) :
+        function.SDP().DenseA()[0];
+    const double bi = (i < 2) ? function.SDP().SparseB()[i] :
+        function.SDP().DenseB()[0];
+    const double constraint = arma::accu(ai % rrt) - bi;
+    expectedObjective += -lambda[i] * constraint +
+        (sigma / 2.0) * constraint * constraint;
+    s -= (lambda[i] - sigma * constraint) * ai;
+
+    REQUIRE(function.EvaluateConstraint(i, coordinates) ==
+        Approx(constraint).epsilon(1e-10));
+  }
+  const arma::mat expectedGradient = 2 * s * coordinates;
+
+  REQUIRE(augFunction.Evaluate(coordinates) ==
+      Approx(expectedObjective).epsilon(1e-10));
+
+  arma::mat gradient;
+  augFunction.Gradient(coordinates, gradient);
+  REQUIRE(gradient.n_rows == n);
+  REQUIRE(gradient.n_cols == r);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    REQUIRE(gradient[i] == Approx(expectedGradient[i]).epsilon(1e-10)
+        .margin(1e-10));
+  }
+}
+
+/**
+ * Make sure that splitting the constraints of an LRSDP into several parts,
+ * which are evaluated in parallel if OpenMP is available, gives the same
+ * augmented Lagrangian as a single part.
+ */
+TEST_CASE("LRSDPParallelConstraintsTest", "[LRSDPTest]")
+{
+  const size_t n = 10;
+  const size_t r = 2;
+  const size_t numConstraints = 7;
+  const arma::mat coordinates(n, r, arma::fill::randn);
+
+  LRSDPFunction<SDP<arma::sp_mat>> function(numConstraints, 0, coordinates);
+  function.SDP().C().eye(n, n);
+  for (size_t i = 0; i < numConstraints; ++i)
+  {
+    arma::sp_mat a = arma::sprandn<arma::sp_mat>(n, n, 0.2);
+    function.SDP().SparseA()[i] = a + trans(a);
+  }
+  function.SDP().SparseB().randn(numConstraints);
+
+  const arma::vec lambda(numConstraints, arma::fill::randn);
+  AugLagrangianFunction<LRSDPFunction<SDP<arma::sp_mat>>> augFunction(
+      function, lambda, 3.0);
+
+  const double objective = augFunction.Evaluate(coordinates);
+  arma::mat gradient;
+  augFunction.Gradient(coordinates, gradient);
+
+  // More parts than constraints are allowed too.
+  for (size_t numThreads = 2; numThreads <= 8; numThreads += 3)
+  {
+    function.NumThreads() = numThreads;
+
+    REQUIRE(augFunction.Evaluate(coordinates) ==
+        Approx(objective).epsilon(1e-12));
+
+    arma::mat parallelGradient;
+    augFunction.Gradient(coordinates, parallelGradient);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+    {
+      REQUIRE(parallelGradient[i] == Approx(gradient[i]).epsilon(1e-12)
+          .margin(1e-12));
+    }
+  }
+}
@@ -90,6 +90,34 @@ TEST_CASE("ParallelSGDGeneralizedRosenbrockTest", "[ParallelSGDTest]")
   }
 }
 
+/**
+ * Estimating the objective from a sample of the functions should still
+ * converge, and the returned objective should be exact.
+ */
+TEST_CASE("ParallelSGDObjectiveSamplesTest", "[ParallelSGDTest]")
+{
+  SparseTestFunction f;
+
+  ConstantStep decayPolicy(0.4);
+
+  // Estimate the objective from half of the functions.
+  ParallelSGD<ConstantStep> s(10000, 2, 1e-5, true, decayPolicy, 2);
+  REQUIRE(s.ObjectiveSamples() == 2);
+
+  omp_set_num_threads(2);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  double result = s.Optimize(f, coordinates);
+
+  REQUIRE(result == Approx(123.75).epsilon(0.0001));
+  REQUIRE(result == Approx(f.Evaluate(coordinates)).epsilon(1e-10));
+
+  REQUIRE(coordinates[0] == Approx(2.0).epsilon(0.0002));
+  REQUIRE(coordinates[1] == Approx(1.0).epsilon(0.0002));
+  REQUIRE(coordinates[2] == Approx(1.5).epsilon(0.0002));
+  REQUIRE(coordinates[3] == Approx(4.0).epsilon(0.0002));
+}
+
 #endif
 
 /**
@@ -29,6 +29,25 @@ TEST_CASE("RMSPropSGDFunction", "[rmsprop]")
   REQUIRE(std::abs(coordinates[2]) <= 0.1);
 }
 
+/**
+ * Run RMSProp with sparse gradients, so that only the touched coordinates are
+ * updated in each step.
+ */
+TEST_CASE("RMSPropSparseGradientTest", "[rmsprop]")
+{
+  SparseTestFunction f;
+  RMSProp optimizer(1e-3, 1, 0.99, 1e-8, 5000000, 1e-9, true);
+
+  arma::mat coordinates = f.GetInitialPoint();
+  optimizer.Optimize<SparseTestFunction, arma::mat, arma::sp_mat>(f,
+      coordinates);
+
+  REQUIRE(std::abs(coordinates[0] - 2.0) <= 0.1);
+  REQUIRE(std::abs(coordinates[1] - 1.0) <= 0.1);
+  REQUIRE(std::abs(coordinates[2] - 1.5) <= 0.1);
+  REQUIRE(std::abs(coordinates[3] - 4.0) <= 0.1);
+}
+
 /**
  * Run RMSProp on logistic regression and make sure the results are acceptable.
  */
@@ -283,6 +283,37 @@ TEST_CASE("SmallMaxCutSdp","[SdpPrimalDualTest]")
   SolveMaxCutPositiveSDP(sdp);
 }
 
+/**
+ * Make sure that the constraints can be split into several parts, which are
+ * transformed in parallel if OpenMP is available, without changing the
+ * solution.
+ */
+TEST_CASE("SmallMaxCutSdpParallel","[SdpPrimalDualTest]")
+{
+  auto sdp = ConstructMaxCutSDPFromLaplacian("data/r10.txt");
+
+  arma::mat X0, Z0;
+  arma::vec ysparse0, ydense0;
+  ydense0.set_size(0);
+  X0.eye(sdp.N(), sdp.N());
+  ysparse0 = -1.1 * arma::vec(arma::sum(arma::abs(sdp.C()), 0).t());
+  Z0 = -arma::diagmat(ysparse0) + sdp.C();
+
+  PrimalDualSolver<SDP<arma::sp_mat>> solver(sdp, X0, ysparse0, ydense0, Z0);
+  arma::mat X, Z;
+  arma::vec ysparse, ydense;
+  const double objective = solver.Optimize(X, ysparse, ydense, Z);
+
+  solver.NumThreads() = 3;
+  arma::mat parallelX, parallelZ;
+  arma::vec parallelYsparse, parallelYdense;
+  const double parallelObjective = solver.Optimize(parallelX, parallelYsparse,
+      parallelYdense, parallelZ);
+
+  REQUIRE(parallelObjective == Approx(objective).epsilon(1e-7));
+  REQUIRE(arma::norm(parallelX - X, "fro") == Approx(0.0).margin(1e-5));
+}
+
 TEST_CASE("SmallLovaszThetaSdp","[SdpPrimalDualTest]")
 {
   UndirectedGraph g;
@@ -12,6 +12,7 @@
 
 #include <ensmallen.hpp>
 #include "catch.hpp"
+#include "test_function_tools.hpp"
 
 using namespace std;
 using namespace arma;
@@ -50,3 +51,171 @@ TEST_CASE("GeneralizedRosenbrockTest","[SGDTest]")
       REQUIRE(coordinates[j] == Approx(1.0).epsilon(1e-5));
   }
 }
+
+/**
+ * Run SGD on logistic regression using single-precision coordinates and data,
+ * and make sure the results are acceptable.
+ */
+TEST_CASE("SGDLogisticRegressionFMatTest","[SGDTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  arma::fmat fData = arma::conv_to<arma::fmat>::from(data);
+  arma::fmat fTestData = arma::conv_to<arma::fmat>::from(testData);
+  arma::fmat fShuffledData = arma::conv_to<arma::fmat>::from(shuffledData);
+  LogisticRegression<arma::fmat> lr(fShuffledData, shuffledResponses, 0.5);
+
+  StandardSGD s;
+  arma::fmat coordinates = lr.GetInitialPoint();
+  const float result = s.Optimize(lr, coordinates);
+
+  REQUIRE(std::isfinite(result));
+
+  // Ensure that the error is close to zero.
+  const double acc = lr.ComputeAccuracy(fData, responses, coordinates);
+  REQUIRE(acc == Approx(100.0).epsilon(0.003)); // 0.3% error tolerance.
+
+  const double testAcc = lr.ComputeAccuracy(fTestData, testResponses,
+      coordinates);
+  REQUIRE(testAcc == Approx(100.0).epsilon(0.006)); // 0.6% error tolerance.
+}
+
+/**
+ * Make sure that splitting the batches for thread-parallel evaluation gives
+ * the same result as evaluating them on one thread.
+ */
+TEST_CASE("SGDParallelBatchTest","[SGDTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+  // The functions are visited in order, so both runs see the same batches.
+  StandardSGD s(0.001, 64, 50000, 1e-9, false);
+  arma::mat coordinates = lr.GetInitialPoint();
+  const double result = s.Optimize(lr, coordinates);
+
+  // Use more parts than there are in the last batch of each epoch, too.
+  for (size_t numThreads = 0; numThreads < 100; numThreads += 7)
+  {
+    s.NumThreads() = numThreads;
+    arma::mat parallelCoordinates = lr.GetInitialPoint();
+    const double parallelResult = s.Optimize(lr, parallelCoordinates);
+
+    REQUIRE(parallelResult == Approx(result).epsilon(1e-8));
+    for (size_t i = 0; i < coordinates.n_elem; ++i)
+    {
+      REQUIRE(parallelCoordinates[i] ==
+          Approx(coordinates[i]).epsilon(1e-6).margin(1e-8));
+    }
+  }
+
+  const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+  REQUIRE(acc == Approx(100.0).epsilon(0.003)); // 0.3% error tolerance.
+}
+
+/**
+ * Make sure that shuffling logistic regression does not copy the data, and that
+ * every point is still visited exactly once per pass, with and without block
+ * shuffling.
+ */
+TEST_CASE("LogisticRegressionShuffleTest","[SGDTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+  LogisticRegression<> lr(data, responses, 0.5);
+
+  arma::mat parameters(1, data.n_rows + 1, arma::fill::randn);
+  const size_t batchSize = 17;
+
+  arma::mat gradient;
+  const double objective = lr.EvaluateWithGradient(parameters, 0, gradient,
+      lr.NumFunctions());
+
+  for (size_t blockSize = 1; blockSize < 100; blockSize += 32)
+  {
+    lr.ShuffleBlockSize() = blockSize;
+    lr.Shuffle();
+
+    // The data is still the user's data.
+    REQUIRE(lr.Predictors().memptr() == data.memptr());
+    REQUIRE(lr.Responses().memptr() == responses.memptr());
+
+    double shuffledObjective = 0.0;
+    arma::mat shuffledGradient(gradient.n_rows, gradient.n_cols,
+        arma::fill::zeros);
+    arma::mat batchGradient;
+    for (size_t i = 0; i < lr.NumFunctions(); i += batchSize)
+    {
+      const size_t effectiveBatchSize = std::min(batchSize,
+          lr.NumFunctions() - i);
+      shuffledObjective += lr.EvaluateWithGradient(parameters, i,
+          batchGradient, effectiveBatchSize);
+      shuffledGradient += batchGradient;
+    }
+
+    REQUIRE(shuffledObjective == Approx(objective).epsilon(1e-10));
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      REQUIRE(shuffledGradient[i] == Approx(gradient[i]).epsilon(1e-10));
+  }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+/**
+ * Train logistic regression with SGD on a memory-mapped dataset, and make sure
+ * the mapped data is used in place.
+ */
+TEST_CASE("SGDMappedMatrixTest","[SGDTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  const std::string filename = "sgd_mapped_matrix_test.bin";
+  REQUIRE(shuffledData.save(filename, arma::raw_binary));
+
+  {
+    MappedMatrix<> mapped(filename, shuffledData.n_rows);
+    REQUIRE(mapped.Matrix().n_rows == shuffledData.n_rows);
+    REQUIRE(mapped.Matrix().n_cols == shuffledData.n_cols);
+    REQUIRE(arma::approx_equal(mapped.Matrix(), shuffledData, "absdiff",
+        0.0));
+
+    mapped.AdviseSequential();
+    mapped.Prefetch(0, 10);
+
+    LogisticRegression<> lr(mapped.Matrix(), shuffledResponses, 0.5);
+    lr.ShuffleBlockSize() = 64;
+    REQUIRE(lr.Predictors().memptr() == mapped.Matrix().memptr());
+
+    StandardSGD s;
+    arma::mat coordinates = lr.GetInitialPoint();
+    s.Optimize(lr, coordinates);
+
+    REQUIRE(lr.Predictors().memptr() == mapped.Matrix().memptr());
+    const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+    REQUIRE(acc == Approx(100.0).epsilon(0.003)); // 0.3% error tolerance.
+
+    mapped.Evict(0, mapped.Matrix().n_cols);
+  }
+
+  std::remove(filename.c_str());
+
+  REQUIRE_THROWS_AS(MappedMatrix<>("sgd_mapped_matrix_missing.bin", 3),
+      std::runtime_error);
+}
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file slbfgs_test.cpp
+ * @author agent
+ *
+ * ensmallen is free software; you may redistribute it and/or modify it under
+ * the terms of the 3-clause BSD license.  You should have received a copy of
+ * the 3-clause BSD license along with ensmallen.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#include <ensmallen.hpp>
+#include "catch.hpp"
+#include "test_function_tools.hpp"
+
+using namespace ens;
+using namespace ens::test;
+
+/**
+ * Run SLBFGS on logistic regression and make sure the results are acceptable.
+ */
+TEST_CASE("SLBFGSLogisticRegressionTest", "[SLBFGSTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  // Now run SLBFGS with a couple of batch sizes.
+  for (size_t batchSize = 35; batchSize < 50; batchSize += 5)
+  {
+    SLBFGS optimizer(0.005, batchSize, 100, 0, 10, 10, 200, 1e-5, true);
+    LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+    arma::mat coordinates = lr.GetInitialPoint();
+    optimizer.Optimize(lr, coordinates);
+
+    // Ensure that the error is close to zero.
+    const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+    REQUIRE(acc == Approx(100.0).epsilon(0.015)); // 1.5% error tolerance.
+
+    const double testAcc = lr.ComputeAccuracy(testData, testResponses,
+        coordinates);
+    REQUIRE(testAcc == Approx(100.0).epsilon(0.015)); // 1.5% error tolerance.
+  }
+}
+
+/**
+ * Make sure that SLBFGS rejects an update interval of zero.
+ */
+TEST_CASE("SLBFGSInvalidUpdateIntervalTest", "[SLBFGSTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  SLBFGS optimizer(0.005, 32, 10, 0, 10, 0);
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+  arma::mat coordinates = lr.GetInitialPoint();
+  REQUIRE_THROWS_AS(optimizer.Optimize(lr, coordinates),
+      std::invalid_argument);
+}
@@ -78,3 +78,57 @@ TEST_CASE("SVRGBBLogisticRegressionTest", "[SVRGTest]")
     REQUIRE(testAcc == Approx(100.0).epsilon(0.015)); // 1.5% error tolerance.
   }
 }
+
+/**
+ * Make sure that the single-pass full objective and gradient computation used
+ * by SVRG, SARAH and Katyusha matches separate Evaluate() and Gradient() calls,
+ * with and without thread-parallel evaluation.
+ */
+TEST_CASE("FullEvaluateWithGradientTest", "[SVRGTest]")
+{
+  arma::mat data, testData, shuffledData;
+  arma::Row<size_t> responses, testResponses, shuffledResponses;
+
+  LogisticRegressionTestData(data, testData, shuffledData,
+      responses, testResponses, shuffledResponses);
+
+  LogisticRegression<> lr(shuffledData, shuffledResponses, 0.5);
+
+  arma::mat coordinates(lr.GetInitialPoint().n_rows, 1, arma::fill::randu);
+
+  const size_t batchSize = 37;
+  double objective = 0.0;
+  arma::mat gradient(coordinates.n_rows, coordinates.n_cols,
+      arma::fill::zeros);
+  arma::mat batchGradient;
+  for (size_t i = 0; i < lr.NumFunctions(); i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        lr.NumFunctions() - i);
+    objective += lr.Evaluate(coordinates, i, effectiveBatchSize);
+    lr.Gradient(coordinates, i, batchGradient, effectiveBatchSize);
+    gradient += batchGradient;
+  }
+
+  for (size_t numThreads = 0; numThreads < 200; numThreads += 9)
+  {
+    arma::mat fullGradient;
+    const double fullObjective = FullEvaluateWithGradient(lr, coordinates,
+        fullGradient, batchSize, numThreads);
+
+    REQUIRE(fullObjective == Approx(objective).epsilon(1e-10));
+    REQUIRE(fullGradient.n_rows == gradient.n_rows);
+    REQUIRE(fullGradient.n_cols == gradient.n_cols);
+    for (size_t i = 0; i < gradient.n_elem; ++i)
+      REQUIRE(fullGradient[i] == Approx(gradient[i]).epsilon(1e-10));
+  }
+
+  // SVRG with a parallel full gradient pass should still converge.
+  SVRG optimizer(0.005, batchSize, 300, 0, 1e-5, true, SVRGUpdate(),
+      NoDecay(), true, 4);
+  coordinates = lr.GetInitialPoint();
+  optimizer.Optimize(lr, coordinates);
+
+  const double acc = lr.ComputeAccuracy(data, responses, coordinates);
+  REQUIRE(acc == Approx(100.0).epsilon(0.015)); // 1.5% error tolerance.
+}